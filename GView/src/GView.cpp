@@ -8,7 +8,8 @@ enum class CommandID
     Open,
     Reset,
     ListTypes,
-    UpdateConfig
+    UpdateConfig,
+    Analyze
 };
 
 struct CommandInfo
@@ -37,6 +38,7 @@ CommandInfo commands[] = {
     { CommandID::Reset, _U("reset") },
     { CommandID::ListTypes, _U("list-types") },
     { CommandID::UpdateConfig, _U("updateconfig") },
+    { CommandID::Analyze, _U("analyze") },
 };
 
 std::string_view help = R"HELP(
@@ -61,11 +63,20 @@ Where <command> is on of:
 
    list-types             List all available types (as loaded from gview.ini).
                           Ex: 'GView list-types' 
+
+   analyze [files|path]   Identifies, hashes (CRC32, MD5, SHA1, SHA256) and
+                          parses one or multiple files (folders are analyzed
+                          recursively) without opening the user interface.
+                          Results are printed as JSON lines.
+                          Ex: 'GView analyze samples/ --jobs:8'
 And <options> are:
    --type:<type>          Specify the type of the file (if knwon)
                           Ex: 'GView open a.temp --type:PE'    
    --selectType           Specify the type of the file should be manually selected
                           Ex: 'GView open a.temp --selectType'   
+   --jobs:<count>         Number of files analyzed in parallel by 'analyze'
+                          (by default, one for each CPU core)
+                          Ex: 'GView analyze a.exe b.pdf --jobs:4'
 )HELP";
 
 void ShowHelp()
@@ -157,6 +168,49 @@ int ProcessOpenCommand(int argc, T** argv, int startIndex)
     return 0;
 }
 
+template <typename T>
+int ProcessAnalyzeCommand(int argc, T** argv, int startIndex)
+{
+    LocalString<128> tempString;
+    std::vector<std::filesystem::path> paths;
+    auto jobs = 0U;
+
+    for (auto start = startIndex; start < argc; start++)
+    {
+        if (argv[start][0] != '-')
+        {
+            paths.emplace_back(argv[start]);
+            continue;
+        }
+        // options are always in ASCII format
+        tempString.Clear();
+        const T* p = argv[start];
+        while ((*p))
+        {
+            tempString.AddChar(static_cast<char>(*p));
+            p++;
+        }
+        if (tempString.StartsWith("--jobs:", true))
+        {
+            auto value = Number::ToUInt32(tempString.ToStringView().substr(7));
+            if (value.has_value())
+            {
+                jobs = value.value();
+                continue;
+            }
+        }
+        std::cout << "Unknwon option: " << tempString.ToStringView() << std::endl;
+        std::cout << "Type 'GView help' for a detailed list of available options" << std::endl;
+        return 1;
+    }
+    if (paths.empty())
+    {
+        std::cout << "Expecting at least one file or folder to analyze" << std::endl;
+        return 1;
+    }
+    return GView::App::Analyze(paths, jobs) ? 0 : 1;
+}
+
 #ifdef BUILD_FOR_WINDOWS
 int wmain(int argc, const wchar_t** argv)
 #else
@@ -183,6 +237,8 @@ int main(int argc, const char** argv)
         return 0;
     case CommandID::Open:
         return ProcessOpenCommand(argc, argv, 2);
+    case CommandID::Analyze:
+        return ProcessAnalyzeCommand(argc, argv, 2);
     case CommandID::Unknown:
         return ProcessOpenCommand(argc, argv, 1);
     default:
@@ -5,6 +5,10 @@
 
 #include <AppCUI/include/AppCUI.hpp>
 
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
 using namespace AppCUI::Controls;
 using namespace AppCUI::Utils;
 using namespace AppCUI::Graphics;
@@ -96,20 +100,164 @@ namespace Utils
     };
     class CORE_EXPORT DataCache
     {
+      public:
+        static constexpr uint32 PAGE_SIZE = 0x10000; // 64 K
+
+        struct Statistics {
+            uint64 hits, misses;
+            uint64 pagesRead, pagesRelocated;
+        };
+
+      private:
+        struct Page {
+            uint64 index;      // page index in file (INVALID_OFFSET if the slot is empty)
+            uint64 lastAccess; // LRU stamp
+        };
+
         AppCUI::OS::DataObject* fileObj;
         uint64 fileSize, start, end, currentPos;
-        uint8* cache;
+        uint8* cache;  // page slots (pages.size() * PAGE_SIZE bytes)
+        uint8* window; // points to the slot that holds 'start' ([start,end) are the pages from the last Get)
         uint32 cacheSize;
+        const uint8* mappedData; // not null if the entire file is memory mapped
+        std::vector<Page> pages;
+        std::unordered_map<uint64, uint32> pageToSlot;
+        uint64 accessCounter;
+        Statistics stats;
+        std::unique_ptr<std::mutex> fileLock; // file reads can be issued from SequentialReader workers
 
         bool CopyObject(void* buffer, uint64 offset, uint32 requestedSize);
+        bool ReadFromFile(uint64 offset, uint8* buffer, uint32 size);
+        void UnmapFile();
+        uint32 FindSlotsRun(uint32 count);
+        bool LoadPages(uint64 firstPage, uint32 count, uint32& slot);
 
       public:
+        // Reads a range in chunks, in order. While the current chunk is processed, the next one is read
+        // on a background thread (double buffering). For memory mapped files chunks point into the mapping.
+        class CORE_EXPORT SequentialReader
+        {
+            void* data;
+
+          public:
+            SequentialReader(DataCache& cache, uint64 offset, uint64 size, uint32 chunkSize = 0);
+            SequentialReader(const SequentialReader&)            = delete;
+            SequentialReader& operator=(const SequentialReader&) = delete;
+            ~SequentialReader();
+
+            // next chunk (valid until the next call) or an empty view if the range was consumed or a read failed
+            BufferView Next();
+            uint64 GetChunkOffset() const;
+            bool HasFailed() const;
+        };
+
+        // Iterates over a range in chunks that are views in the cache (no copy). A chunk is valid until the next
+        // one is requested. Consecutive chunks share 'overlap' bytes, so a pattern of N bytes that crosses a chunk
+        // boundary is found if overlap >= N - 1 (with exactly N - 1 bytes, no match is reported twice).
+        // The overlap must be at most half of a chunk, otherwise the range is rejected (it is empty and HasFailed returns true).
+        class ChunksRange
+        {
+            DataCache* cache;
+            uint64 rangeStart, rangeEnd;
+            uint32 chunkSize, overlap;
+            bool failed;
+
+          public:
+            class Iterator
+            {
+                ChunksRange* range;
+                uint64 offset;
+                BufferView chunk;
+
+                inline void Read()
+                {
+                    if (offset >= range->rangeEnd)
+                    {
+                        chunk = BufferView();
+                        return;
+                    }
+                    chunk = range->cache->Get(offset, (uint32) std::min<>((uint64) range->chunkSize, range->rangeEnd - offset), true);
+                    if (chunk.Empty())
+                    {
+                        range->failed = true;
+                        offset        = range->rangeEnd;
+                    }
+                }
+
+              public:
+                Iterator(ChunksRange* r, uint64 startOffset) : range(r), offset(startOffset)
+                {
+                    Read();
+                }
+                inline BufferView operator*() const
+                {
+                    return chunk;
+                }
+                // file offset of the current chunk
+                inline uint64 GetOffset() const
+                {
+                    return offset;
+                }
+                inline Iterator& operator++()
+                {
+                    if (offset + chunk.GetLength() >= range->rangeEnd)
+                        offset = range->rangeEnd;
+                    else
+                        offset += chunk.GetLength() - range->overlap;
+                    Read();
+                    return *this;
+                }
+                inline bool operator!=(const Iterator& it) const
+                {
+                    return offset != it.offset;
+                }
+            };
+
+            ChunksRange(DataCache& dataCache, uint64 offset, uint64 size, uint32 overlapSize, uint32 maxChunkSize)
+                : cache(&dataCache), failed(true)
+            {
+                rangeStart = std::min<>(offset, dataCache.GetSize());
+                rangeEnd   = rangeStart;
+                chunkSize  = maxChunkSize > 0 ? std::min<>(maxChunkSize, dataCache.GetCacheSize()) : (dataCache.GetCacheSize() >> 1);
+                overlap    = overlapSize;
+                CHECKRET(overlapSize <= (chunkSize >> 1), "Overlap (%u bytes) larger than half of a chunk (%u bytes)", overlapSize, chunkSize);
+                rangeEnd = rangeStart + std::min<>(size, dataCache.GetSize() - rangeStart);
+                failed   = false;
+            }
+            inline Iterator begin()
+            {
+                return Iterator(this, rangeStart);
+            }
+            inline Iterator end()
+            {
+                return Iterator(this, rangeEnd);
+            }
+            inline bool HasFailed() const
+            {
+                return failed;
+            }
+        };
+
         DataCache();
         DataCache(DataCache&& obj);
         ~DataCache();
 
         bool Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 cacheSize);
+
+        // maps a regular file in memory (the file must be the same one the cache was initialized with)
+        // if mapping is not possible (pipes, devices, empty files), the cache remains in windowed mode
+        // views returned for a mapped file stay valid for the lifetime of the cache object
+        bool MapFile(const std::filesystem::path& path);
+        inline bool IsMemoryMapped() const
+        {
+            return mappedData != nullptr;
+        }
+
         BufferView Get(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead);
+        inline ChunksRange Chunks(uint64 offset, uint64 size, uint32 overlap = 0, uint32 chunkSize = 0)
+        {
+            return ChunksRange(*this, offset, size, overlap, chunkSize);
+        }
         inline BufferView GetEntireFile()
         {
             return fileSize < 0xFFFFFFFF ? Get(0, (uint32) fileSize, true) : BufferView();
@@ -122,14 +270,24 @@ namespace Utils
         }
         inline uint8 GetFromCache(uint64 offset, uint8 defaultValue = 0) const
         {
+            if (mappedData)
+                return offset < fileSize ? mappedData[offset] : defaultValue;
             if ((offset >= start) && (offset < end))
-                return cache[offset - start];
+                return window[offset - start];
             return defaultValue;
         }
         inline uint32 GetCacheSize() const
         {
             return cacheSize;
         }
+        inline const Statistics& GetStatistics() const
+        {
+            return stats;
+        }
+        inline void ResetStatistics()
+        {
+            stats = {};
+        }
 
         inline uint64 GetSize() const
         {
@@ -190,6 +348,8 @@ namespace Utils
 
       public:
         ZonesList();
+        ZonesList(const ZonesList& other);
+        ZonesList& operator=(const ZonesList& other);
         ~ZonesList();
 
         bool Add(uint64 start, uint64 end, AppCUI::Graphics::ColorPair c, std::string_view txt);
@@ -199,6 +359,8 @@ namespace Utils
         void Clear();
         uint32 GetCount() const;
         std::optional<Zone> GetZone(uint32 index) const;
+        // the parts of the zones from the interval of the last SetCache (disjoint, sorted), each one with the zone shown there
+        void GetCachedZones(std::vector<Zone>& output) const;
     };
 
     struct CORE_EXPORT ObjectHighlightingZonesInterface {
@@ -794,18 +956,55 @@ namespace Regex
         void* context{ nullptr };
 
       public:
+        // false if the expression is not valid (GetError has the reason)
+        // if isUnicode is false the expression and the buffers are treated as Latin-1 (a character for every byte)
         bool Init(std::string_view expression, bool isUnicode, bool isCaseSensitive);
         Matcher() = default;
         ~Matcher();
 
+        std::string_view GetError() const;
+
         bool Match(BufferView buffer, uint64& start, uint64& end);
     };
 } // namespace Regex
 
 namespace Entropy
 {
+    using Histogram = std::array<uint64, 256>;
+
     CORE_EXPORT double ShannonEntropy(const BufferView& buffer);
     CORE_EXPORT double RenyiEntropy(const BufferView& buffer, double alpha);
+
+    // adds the frequency of every byte from the buffer to the histogram
+    CORE_EXPORT void UpdateHistogram(const BufferView& buffer, Histogram& histogram);
+    CORE_EXPORT double ShannonEntropy(const Histogram& histogram, uint64 total);
+    CORE_EXPORT double RenyiEntropy(const Histogram& histogram, uint64 total, double alpha);
+
+    // Entropy of every block of 'blockSize' bytes from [offset, offset + size) computed in a single pass over the
+    // data (the last block can be smaller). An alpha of 1 means Shannon entropy, any other value Renyi entropy.
+    CORE_EXPORT bool ComputeProfile(
+          Utils::DataCache& cache, uint64 offset, uint64 size, uint32 blockSize, double alpha, std::vector<double>& profile);
+
+    // Shannon entropy of the last 'windowSize' bytes added, updated in O(1) for every byte
+    class CORE_EXPORT SlidingWindow
+    {
+        std::vector<int64> cLogC; // c * log2(c) in fixed point (the sum is exact => no drift)
+        std::vector<uint8> window;
+        std::array<uint32, 256> counts;
+        uint32 position, filled;
+        int64 sum;
+
+      public:
+        SlidingWindow(uint32 windowSize);
+
+        void Reset();
+        void Add(uint8 value); // the oldest byte is removed if the window is full
+        double GetEntropy() const;
+        inline bool IsFull() const
+        {
+            return filled == window.size();
+        }
+    };
 } // namespace Entropy
 
 /*
@@ -827,10 +1026,17 @@ class CORE_EXPORT Object
     AppCUI::Utils::UnicodeStringBuilder filePath;
     uint32 PID;
     Type objectType;
+    struct
+    {
+        uint32 bomLength;
+        uint8 encoding; // a CharacterEncoding::Encoding value
+        bool available;
+    } probedEncoding;
 
   public:
     Object(Type objType, Utils::DataCache&& dataCache, TypeInterface* contType, ConstString objName, ConstString objFilePath, uint32 pid)
-        : cache(std::move(dataCache)), contentType(contType), name(objName), filePath(objFilePath), PID(pid), objectType(objType)
+        : cache(std::move(dataCache)), contentType(contType), name(objName), filePath(objFilePath), PID(pid), objectType(objType),
+          probedEncoding{ 0, 0, false }
     {
         if (contentType)
             contentType->obj = this;
@@ -864,6 +1070,20 @@ class CORE_EXPORT Object
     {
         return objectType;
     }
+
+    // encoding detected on the first bytes of the object during type identification (if it was needed)
+    inline void SetProbedEncoding(uint8 encoding, uint32 bomLength)
+    {
+        probedEncoding = { bomLength, encoding, true };
+    }
+    inline bool GetProbedEncoding(uint8& encoding, uint32& bomLength) const
+    {
+        if (!probedEncoding.available)
+            return false;
+        encoding  = probedEncoding.encoding;
+        bomLength = probedEncoding.bomLength;
+        return true;
+    }
 };
 
 namespace View
@@ -879,6 +1099,11 @@ namespace View
     constexpr int32 VIEW_COMMAND_ACTIVATE_OBJECT_HIGHLIGHTING{ 0xBF16 };
     constexpr int32 VIEW_COMMAND_DEACTIVATE_OBJECT_HIGHLIGHTING{ 0xBF17 };
 
+    namespace BufferViewer
+    {
+        struct BufferColor;
+    }
+
     struct ViewData {
         uint64 viewStartOffset{ GView::Utils::INVALID_OFFSET };
         uint64 viewSize{ GView::Utils::INVALID_OFFSET };
@@ -888,6 +1113,9 @@ namespace View
 
     struct CORE_EXPORT BufferColorInterface {
         virtual bool GetColorForByteAt(uint64 offset, const ViewData& vd, ColorPair& cp) = 0;
+        // Colors of all the bytes from 'buf' (that starts at 'offset') as runs sorted by their start. The view calls it once
+        // for every paint (with the visible bytes); the default implementation calls GetColorForByteAt for every byte.
+        virtual void GetColorsForBuffer(uint64 offset, BufferView buf, const ViewData& vd, std::vector<BufferViewer::BufferColor>& runs);
     };
 
     struct CORE_EXPORT OnStartViewMoveInterface {
@@ -963,6 +1191,10 @@ namespace View
 
         struct CORE_EXPORT PositionToColorInterface {
             virtual bool GetColorForBuffer(uint64 offset, BufferView buf, BufferColor& result) = 0;
+            // Colors of the first 'size' bytes from 'buf' (that starts at 'offset') as runs sorted by their start, the bytes
+            // after them are only used to decode what starts in the range. The view calls it once for every paint (with the
+            // visible bytes); the default implementation calls GetColorForBuffer for every byte that is not in a previous run.
+            virtual void GetColorsForBuffer(uint64 offset, BufferView buf, uint32 size, std::vector<BufferColor>& runs);
         };
 
         struct CORE_EXPORT OffsetTranslateInterface {
@@ -1339,7 +1571,9 @@ namespace View
             const TextParser& text;
             TokensList& tokens;
             BlocksList& blocks;
-            SyntaxManager(const TextParser& _text, TokensList& _tokens, BlocksList& _blocks) : text(_text), tokens(_tokens), blocks(_blocks)
+            bool blocksMatched; // set to false by the parser if a block token from the text has no pair
+            SyntaxManager(const TextParser& _text, TokensList& _tokens, BlocksList& _blocks)
+                : text(_text), tokens(_tokens), blocks(_blocks), blocksMatched(true)
             {
             }
         };
@@ -1366,6 +1600,17 @@ namespace View
             virtual void AnalyzeText(SyntaxManager& syntax)                                                            = 0;
             virtual bool StringToContent(std::u16string_view stringValue, AppCUI::Utils::UnicodeStringBuilder& result) = 0;
             virtual bool ContentToString(std::u16string_view content, AppCUI::Utils::UnicodeStringBuilder& result)     = 0;
+
+            // Optional (used to re-analyze only the modified part of the text after a change).
+            // Returns true if the text that follows 'token' (a token that is not part of any block) can be analyzed
+            // separately from the text that precedes it. In that case AnalyzeText is called only for that part of the text,
+            // with the type of 'token' as the last token ID. If it never does, the entire text is analyzed after every change.
+            // The analysis is split only if every block token had a pair (SyntaxManager::blocksMatched) and the new tokens
+            // of that part of the text end with a token that the parser also splits after.
+            virtual bool CanSplitAnalysisAfter(Token token)
+            {
+                return false;
+            }
         };
         struct PluginData {
             TextEditor& editor;
@@ -1440,6 +1685,13 @@ namespace View
             void AddDisassemblyZone(uint64 zoneStart, uint64 zoneSize, uint64 zoneDissasmStartPoint, DisassemblyLanguage lang = DisassemblyLanguage::Default);
 
             void AddMemoryMapping(uint64 address, std::string_view name, MemoryMappingType mappingType);
+            /**
+             * Add a function that may not be called from the disassembly zone (for example an exported function). The deep scan starts a function
+             * from it and names it.
+             * @param[in] offset The file offset of the function
+             * @param[in] name The name of the function
+             */
+            void AddFunction(uint64 offset, std::string_view name);
             void AddCollapsibleZone(uint64 offset, uint64 size);
 
             /**
@@ -1516,6 +1768,7 @@ namespace App
           OpenMethod method,
           std::string_view typeName = "",
           Reference<Window> parent  = nullptr);
+    bool CORE_EXPORT Analyze(const std::vector<std::filesystem::path>& paths, uint32 jobs = 0); // headless, results are printed as JSON lines
     Reference<GView::Object> CORE_EXPORT GetObject(uint32 index);
     uint32 CORE_EXPORT GetObjectsCount();
     std::string_view CORE_EXPORT GetTypePluginName(uint32 index);
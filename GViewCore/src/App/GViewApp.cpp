@@ -6,6 +6,10 @@
 #include "DissasmViewer.hpp"
 #include "LexicalViewer.hpp"
 
+#include <atomic>
+#include <iostream>
+#include <thread>
+
 using namespace GView::App;
 using namespace AppCUI::Application;
 using namespace AppCUI::Controls;
@@ -98,6 +102,7 @@ bool GView::App::ResetConfiguration()
 
     // generic GView settings
     ini["GView"]["CacheSize"]        = DEFAULT_CACHE_SIZE;
+    ini["GView"]["UseMemoryMappedFiles"] = true;
 
     const std::array<std::reference_wrapper<KeyboardControl>, 6> localKeys = {
         InstanceCommands::INSTANCE_CHANGE_VIEW,     InstanceCommands::INSTANCE_SWITCH_TO_VIEW, InstanceCommands::INSTANCE_COMMAND_GOTO,
@@ -141,6 +146,69 @@ void GView::App::OpenFile(const std::filesystem::path& path, OpenMethod method,
         }
     }
 }
+bool GView::App::Analyze(const std::vector<std::filesystem::path>& paths, uint32 jobs)
+{
+    GView::App::Instance instance;
+    CHECK(instance.InitHeadless(), false, "Fail to initialize GView (headless mode)");
+
+    // folders are analyzed recursively
+    std::vector<std::filesystem::path> files;
+    for (const auto& path : paths)
+    {
+        try
+        {
+            if (std::filesystem::is_directory(path))
+            {
+                for (const auto& entry :
+                     std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied))
+                {
+                    if (entry.is_regular_file())
+                        files.push_back(entry.path());
+                }
+            }
+            else
+            {
+                files.push_back(path);
+            }
+        }
+        catch (std::filesystem::filesystem_error /* e */)
+        {
+            files.push_back(path); // will be reported as an error by AnalyzeFile
+        }
+    }
+    if (jobs == 0)
+        jobs = std::max<>(std::thread::hardware_concurrency(), 1U);
+    jobs = static_cast<uint32>(std::max<>(std::min<>(static_cast<size_t>(jobs), files.size()), static_cast<size_t>(1)));
+
+    // each worker picks the next file and prints one JSON object per line
+    std::atomic<size_t> nextFile{ 0 };
+    std::atomic<uint32> failed{ 0 };
+    std::mutex outputLock;
+    auto worker = [&]()
+    {
+        std::string line;
+        while (true)
+        {
+            const auto index = nextFile.fetch_add(1);
+            if (index >= files.size())
+                return;
+            if (!instance.AnalyzeFile(files[index], line))
+                failed++;
+            std::lock_guard<std::mutex> lock(outputLock);
+            std::cout << line << '\n';
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(jobs - 1);
+    for (auto idx = 1U; idx < jobs; idx++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+    std::cout.flush();
+
+    return failed == 0;
+}
 void GView::App::OpenBuffer(
       BufferView buf, const ConstString& name, const ConstString& path, OpenMethod method, std::string_view typeName, Reference<Window> parent)
 {
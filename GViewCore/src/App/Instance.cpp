@@ -12,6 +12,7 @@ constexpr uint32 DEFAULT_CACHE_SIZE    = 0xA00000; // 10 MB
 constexpr uint32 MIN_CACHE_SIZE        = 0x10000;  // 64 K
 constexpr uint32 GENERIC_PLUGINS_CMDID = 40000000;
 constexpr uint32 GENERIC_PLUGINS_FRAME = 100;
+constexpr uint32 TYPE_PROBE_SIZE       = 0x8800; // first bytes of an object used to identify its type
 
 struct GViewMenuCommand {
     std::string_view name;
@@ -68,14 +69,14 @@ bool AddMenuCommands(Menu* mnu, const GViewMenuCommand* list, size_t count)
 Instance::Instance()
 {
     this->defaultCacheSize         = DEFAULT_CACHE_SIZE;
+    this->useMemoryMappedFiles     = true;
     this->mnuWindow                = nullptr;
     this->mnuHelp                  = nullptr;
     this->mnuFile                  = nullptr;
     this->lastOpenedFolderLocation = ".";
 }
-bool Instance::LoadSettings()
+bool Instance::LoadSettings(AppCUI::Utils::IniObject* ini)
 {
-    auto ini = AppCUI::Application::GetAppSettings();
     CHECK(ini, false, "");
     CHECK(ini->GetSectionsCount() > 0, false, "");
     // check plugins
@@ -101,10 +102,12 @@ bool Instance::LoadSettings()
 
     // sort all plugins based on their priority
     std::sort(this->typePlugins.begin(), this->typePlugins.end());
+    this->typePluginsIndex.Build(this->typePlugins);
 
     // read instance settings
     auto sect                                  = ini->GetSection("GView");
     this->defaultCacheSize                     = std::max<>(sect.GetValue("CacheSize").ToUInt32(DEFAULT_CACHE_SIZE), MIN_CACHE_SIZE);
+    this->useMemoryMappedFiles                 = sect.GetValue("UseMemoryMappedFiles").ToBool(true);
 
     const std::array<std::reference_wrapper<KeyboardControl>, 6> localKeys = {
         InstanceCommands::INSTANCE_CHANGE_VIEW,     InstanceCommands::INSTANCE_SWITCH_TO_VIEW, InstanceCommands::INSTANCE_COMMAND_GOTO,
@@ -138,8 +141,9 @@ bool Instance::BuildMainMenus()
 bool Instance::Init()
 {
     InitializationData initData;
-    initData.Flags =
-          InitializationFlags::Menu | InitializationFlags::CommandBar | InitializationFlags::LoadSettingsFile | InitializationFlags::AutoHotKeyForWindow;
+    // the FPS mode calls OnFrameUpdate on the controls => the views repaint themselves while a background task runs
+    initData.Flags = InitializationFlags::Menu | InitializationFlags::CommandBar | InitializationFlags::LoadSettingsFile |
+                     InitializationFlags::AutoHotKeyForWindow | InitializationFlags::EnableFPSMode;
 
     const auto settingsPath = AppCUI::Application::GetAppSettingsFile();
     AppCUI::OS::File settingsFile;
@@ -155,7 +159,7 @@ bool Instance::Init()
     CHECK(AppCUI::Application::Init(initData), false, "Fail to initialize AppCUI framework !");
     // reserve some space fo type
     this->typePlugins.reserve(128);
-    if (!LoadSettings()) {
+    if (!LoadSettings(AppCUI::Application::GetAppSettings())) {
         auto preservedSettingsNewPath = settingsPath;
         preservedSettingsNewPath.replace_extension(".ini.bak");
         std::filesystem::rename(settingsPath, preservedSettingsNewPath);
@@ -181,6 +185,26 @@ bool Instance::Init()
     dsk->Handlers()->OnStart = this;
     return true;
 }
+bool Instance::InitHeadless()
+{
+    // no AppCUI initialization: the settings are read directly from the ini file
+    const auto settingsPath = AppCUI::Application::GetAppSettingsFile();
+    AppCUI::Utils::IniObject ini;
+    if (!ini.CreateFromFile(settingsPath)) {
+        CHECK(GView::App::ResetConfiguration(), false, "");
+        CHECK(ini.CreateFromFile(settingsPath), false, "Fail to load configuration file: %s", settingsPath.u8string().c_str());
+    }
+    this->typePlugins.reserve(128);
+    CHECK(LoadSettings(&ini), false, "Invalid configuration file: %s", settingsPath.u8string().c_str());
+    this->defaultPlugin.Init();
+
+    // load every type plugin now, so that the plugins list is only read when analyzing files in parallel
+    for (auto& pType : this->typePlugins) {
+        if (!pType.Load())
+            errList.AddWarning("Fail to load type plugin (%s)", pType.GetName().data());
+    }
+    return true;
+}
 Reference<GView::Type::Plugin> Instance::IdentifyTypePlugin_WithSelectedType(
       const AppCUI::Utils::ConstString& name,
       const AppCUI::Utils::ConstString& path,
@@ -245,17 +269,17 @@ Reference<GView::Type::Plugin> Instance::IdentifyTypePlugin_FirstMatch(
       const string_view& extension, AppCUI::Utils::BufferView buf, GView::Type::Matcher::TextParser& textParser, uint64 extensionHash)
 {
     // check for extension first
-    if (extensionHash != 0) {
-        for (auto& pType : this->typePlugins) {
-            if (pType.MatchExtension(extensionHash)) {
-                if (pType.IsOfType(buf, textParser, extension))
-                    return &pType;
-            }
-        }
+    for (auto idx : this->typePluginsIndex.GetExtensionCandidates(extensionHash)) {
+        auto& pType = this->typePlugins[idx];
+        if (pType.IsOfType(buf, textParser, extension))
+            return &pType;
     }
 
-    // check the content
-    for (auto& pType : this->typePlugins) {
+    // check the content (only plugins that have a pattern compatible with the first byte of the buffer)
+    std::vector<uint32> candidates;
+    this->typePluginsIndex.GetContentCandidates(buf, candidates);
+    for (auto idx : candidates) {
+        auto& pType = this->typePlugins[idx];
         if (pType.MatchContent(buf, textParser)) {
             if (pType.IsOfType(buf, textParser))
                 return &pType;
@@ -276,21 +300,21 @@ Reference<GView::Type::Plugin> Instance::IdentifyTypePlugin_BestMatch(
 {
     auto plg   = &this->defaultPlugin;
     auto count = 0;
-    if (extensionHash != 0) {
-        for (auto& pType : this->typePlugins) {
-            if (pType.MatchExtension(extensionHash)) {
-                if (pType.IsOfType(buf, textParser)) {
-                    count++;
-                    plg = &pType;
-                    if (count > 1) // at least two options
-                        return IdentifyTypePlugin_Select(name, path, dataSize, buf, textParser, extensionHash, newName);
-                }
-            }
+    for (auto idx : this->typePluginsIndex.GetExtensionCandidates(extensionHash)) {
+        auto& pType = this->typePlugins[idx];
+        if (pType.IsOfType(buf, textParser)) {
+            count++;
+            plg = &pType;
+            if (count > 1) // at least two options
+                return IdentifyTypePlugin_Select(name, path, dataSize, buf, textParser, extensionHash, newName);
         }
     }
 
     // check the content
-    for (auto& pType : this->typePlugins) {
+    std::vector<uint32> candidates;
+    this->typePluginsIndex.GetContentCandidates(buf, candidates);
+    for (auto idx : candidates) {
+        auto& pType = this->typePlugins[idx];
         if (pType.MatchContent(buf, textParser)) {
             if (pType.IsOfType(buf, textParser)) {
                 count++;
@@ -308,18 +332,14 @@ Reference<GView::Type::Plugin> Instance::IdentifyTypePlugin(
       const AppCUI::Utils::ConstString& name,
       const AppCUI::Utils::ConstString& path,
       GView::Utils::DataCache& cache,
+      GView::Type::Matcher::TextParser& tp,
       uint64 extensionHash,
       OpenMethod method,
       std::string_view typeName,
       std::u16string& newName)
 {
-    auto buf    = cache.Get(0, 0x8800, false);
-    auto bomLen = 0U;
-    auto enc    = GView::Utils::CharacterEncoding::AnalyzeBufferForEncoding(buf, true, bomLen);
-    auto text =
-          enc != GView::Utils::CharacterEncoding::Encoding::Binary ? GView::Utils::CharacterEncoding::ConvertToUnicode16(buf) : GView::Utils::UnicodeString();
-    auto tp = GView::Type::Matcher::TextParser(text.text, text.size);
-    auto sz = cache.GetSize();
+    auto buf = cache.Get(0, TYPE_PROBE_SIZE, false);
+    auto sz  = cache.GetSize();
 
     LocalUnicodeStringBuilder<256> temp;
     temp.Set(name);
@@ -344,6 +364,144 @@ Reference<GView::Type::Plugin> Instance::IdentifyTypePlugin(
     // for other methods --> return the default plugin
     return &this->defaultPlugin;
 }
+static void AddJSONString(std::string& output, std::string_view text)
+{
+    output += '"';
+    for (auto ch : text) {
+        switch (ch) {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default:
+            if (static_cast<uint8>(ch) < 0x20) {
+                LocalString<8> tmp;
+                output += tmp.Format("\\u%04X", static_cast<uint8>(ch));
+            } else {
+                output += ch;
+            }
+        }
+    }
+    output += '"';
+}
+static std::string_view EncodingToString(GView::Utils::CharacterEncoding::Encoding encoding)
+{
+    switch (encoding) {
+    case GView::Utils::CharacterEncoding::Encoding::Ascii:
+        return "ascii";
+    case GView::Utils::CharacterEncoding::Encoding::UTF8:
+        return "utf-8";
+    case GView::Utils::CharacterEncoding::Encoding::Unicode16LE:
+        return "utf-16le";
+    case GView::Utils::CharacterEncoding::Encoding::Unicode16BE:
+        return "utf-16be";
+    default:
+        return "binary";
+    }
+}
+bool Instance::AnalyzeFile(const std::filesystem::path& path, std::string& output)
+{
+    const auto pathUTF8 = path.u8string();
+    output.clear();
+    output += "{\"path\":";
+    AddJSONString(output, std::string_view(reinterpret_cast<const char*>(pathUTF8.data()), pathUTF8.size()));
+
+    // every call has its own cache, so files can be analyzed in parallel
+    GView::Utils::DataCache cache;
+    auto f = std::make_unique<AppCUI::OS::File>();
+    if ((f->OpenRead(path) == false) || (cache.Init(std::move(f), this->defaultCacheSize) == false)) {
+        output += ",\"error\":\"unable to open file\"}";
+        return false;
+    }
+    if (this->useMemoryMappedFiles)
+        cache.MapFile(path);
+
+    // same rules as OpenMethod::FirstMatch
+    const auto extensionUTF8 = path.extension().u8string();
+    std::string_view extension(reinterpret_cast<const char*>(extensionUTF8.data()), extensionUTF8.size());
+    auto buf = cache.Get(0, TYPE_PROBE_SIZE, false);
+    GView::Type::Matcher::TextParser tp(buf);
+
+    // the plugins (loading them, Validate, CreateInstance, Update and the destructor of their objects) are called by one thread at a
+    // time; only reading and hashing the file is done in parallel
+    std::unique_lock<std::mutex> pluginsLock(this->typePluginsLock);
+    auto plg = IdentifyTypePlugin_FirstMatch(extension, buf, tp, GView::Type::Plugin::ExtensionToHash(extension));
+    pluginsLock.unlock();
+    uint32 bomLength;
+    auto encoding = tp.GetEncoding(bomLength);
+
+    // byte histogram (for entropy) and hashes of the entire file, in a single pass
+    GView::Entropy::Histogram histogram{};
+    GView::Hashes::CRC32 crc32;
+    GView::Hashes::OpenSSLHash md5(GView::Hashes::OpenSSLHashKind::Md5);
+    GView::Hashes::OpenSSLHash sha1(GView::Hashes::OpenSSLHashKind::Sha1);
+    GView::Hashes::OpenSSLHash sha256(GView::Hashes::OpenSSLHashKind::Sha256);
+    crc32.Init(GView::Hashes::CRC32Type::JAMCRC); // initial value and final xor are 0xFFFFFFFF (the usual CRC32)
+    GView::Utils::DataCache::SequentialReader reader(cache, 0, cache.GetSize());
+    while (true) {
+        const auto chunk = reader.Next();
+        if (chunk.Empty())
+            break;
+        GView::Entropy::UpdateHistogram(chunk, histogram);
+        crc32.Update(chunk);
+        md5.Update(chunk.GetData(), static_cast<uint32>(chunk.GetLength()));
+        sha1.Update(chunk.GetData(), static_cast<uint32>(chunk.GetLength()));
+        sha256.Update(chunk.GetData(), static_cast<uint32>(chunk.GetLength()));
+    }
+    if (reader.HasFailed()) {
+        output += ",\"error\":\"read error\"}";
+        return false;
+    }
+    const auto size    = cache.GetSize();
+    const auto entropy = GView::Entropy::ShannonEntropy(histogram, size);
+
+    LocalString<128> tmp;
+    output += tmp.Format(",\"size\":%llu,\"type\":", size);
+    if (plg->GetName().empty()) // default plugin
+        output += "null";
+    else
+        AddJSONString(output, plg->GetName());
+    output += ",\"encoding\":";
+    AddJSONString(output, EncodingToString(encoding));
+    output += tmp.Format(",\"bom\":%u,\"entropy\":%.4f", bomLength, entropy);
+    output += ",\"crc32\":";
+    AddJSONString(output, crc32.GetHexValue());
+    output += ",\"md5\":";
+    AddJSONString(output, md5.GetHexValue());
+    output += ",\"sha1\":";
+    AddJSONString(output, sha1.GetHexValue());
+    output += ",\"sha256\":";
+    AddJSONString(output, sha256.GetHexValue());
+
+    // the type plugin parses the file the same way it does before populating a window (but no window is created);
+    // plugins without an 'Update' export are only identified
+    output += ",\"parsed\":";
+    if (!plg->HasUpdate()) {
+        output += "null}";
+        return true;
+    }
+    pluginsLock.lock(); // released after 'obj' and 'contentType' are destroyed
+    std::unique_ptr<TypeInterface> contentType(plg->CreateInstance());
+    if (!contentType) {
+        output += "false}";
+        return true;
+    }
+    GView::Object obj(GView::Object::Type::File, std::move(cache), contentType.get(), path.filename().u16string(), path.u16string(), 0);
+    obj.SetProbedEncoding(static_cast<uint8>(encoding), bomLength);
+    output += plg->Update(&obj) ? "true}" : "false}";
+    return true;
+}
 bool Instance::Add(
       GView::Object::Type objType,
       std::unique_ptr<AppCUI::OS::DataObject> data,
@@ -375,6 +533,11 @@ bool Instance::Add(
     // extract extension
     LocalUnicodeStringBuilder<256> temp;
     CHECK(temp.Set(path), false, "Fail to get path object");
+
+    // regular files can be accessed directly (if mapping fails, the cache remains in windowed mode)
+    if ((objType == GView::Object::Type::File) && (this->useMemoryMappedFiles)) {
+        cache.MapFile(std::filesystem::path(temp.ToStringView()));
+    }
     // search for the last "."
     auto pos = temp.ToStringView().find_last_of('.');
     auto extHash =
@@ -382,14 +545,22 @@ bool Instance::Add(
 
     CHECK(temp.Set(name), false, "Fail to get filename object");
     std::u16string newName{ temp.ToStringView() };
-    auto plg = IdentifyTypePlugin(name, path, cache, extHash, method, typeName, newName);
+    // the text form of the probe is only computed if a text based matcher needs it
+    GView::Type::Matcher::TextParser tp(cache.Get(0, TYPE_PROBE_SIZE, false));
+    auto plg = IdentifyTypePlugin(name, path, cache, tp, extHash, method, typeName, newName);
     CHECK(plg, false, "Unable to identify a valid plugin open canceled !");
 
     // create an instance of that object type
     auto contentType = plg->CreateInstance();
     CHECK(contentType, false, "'CreateInstance' returned a null pointer to a content type object !");
 
-    auto win = std::make_unique<FileWindow>(std::make_unique<GView::Object>(objType, std::move(cache), contentType, newName, path, PID), this, plg);
+    auto obj = std::make_unique<GView::Object>(objType, std::move(cache), contentType, newName, path, PID);
+    if (tp.IsEncodingComputed()) {
+        uint32 bomLength;
+        auto enc = tp.GetEncoding(bomLength);
+        obj->SetProbedEncoding(static_cast<uint8>(enc), bomLength);
+    }
+    auto win = std::make_unique<FileWindow>(std::move(obj), this, plg);
 
     // instantiate window
     while (true) {
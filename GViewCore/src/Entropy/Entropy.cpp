@@ -2,17 +2,55 @@
 
 #include <math.h>
 #include <array>
+#include <cstring>
 
 constexpr uint32 MAX_NUMBER_OF_BYTES = 256;
 
+// Byte counting uses several interleaved histograms: consecutive bytes are usually equal (or from a small alphabet)
+// and incrementing the same counter back to back stalls on the store -> load dependency.
+constexpr uint32 HISTOGRAM_LANES = 4;
+// The lanes are 32 bit wide => they are flushed in the 64 bit histogram at least every 4G bytes / lane.
+constexpr uint64 HISTOGRAM_SLICE = 1ULL << 30;
+// Blocks smaller than this are counted directly (resetting the lanes would cost more than counting).
+constexpr uint32 SMALL_BLOCK_SIZE = 1024;
+// Counts up to this value use a precomputed table of per-symbol terms.
+constexpr uint32 MAX_TABLE_COUNT = 65536;
+// Fixed point precision for the sliding window terms.
+constexpr uint32 FIXED_POINT_SHIFT = 24;
+
 namespace GView::Entropy
 {
-void SetFrequencies(const BufferView& buffer, std::array<char, MAX_NUMBER_OF_BYTES>& frequency)
+void UpdateHistogram(const BufferView& buffer, Histogram& histogram)
 {
-    // Count frequency of each byte in the buffer
-    for (uint32 i = 0; i < buffer.GetLength(); i++) {
-        const auto c = buffer[i];
-        frequency[c]++;
+    auto p         = buffer.GetData();
+    auto remaining = static_cast<uint64>(buffer.GetLength());
+    if (p == nullptr)
+        return;
+
+    uint32 lanes[HISTOGRAM_LANES][MAX_NUMBER_OF_BYTES];
+    while (remaining > 0) {
+        const auto slice = std::min<>(remaining, HISTOGRAM_SLICE);
+        const auto end   = p + slice;
+        memset(lanes, 0, sizeof(lanes));
+
+        for (; p + 8 <= end; p += 8) {
+            uint64 v;
+            memcpy(&v, p, sizeof(v));
+            lanes[0][v & 0xFF]++;
+            lanes[1][(v >> 8) & 0xFF]++;
+            lanes[2][(v >> 16) & 0xFF]++;
+            lanes[3][(v >> 24) & 0xFF]++;
+            lanes[0][(v >> 32) & 0xFF]++;
+            lanes[1][(v >> 40) & 0xFF]++;
+            lanes[2][(v >> 48) & 0xFF]++;
+            lanes[3][v >> 56]++;
+        }
+        for (; p < end; p++)
+            lanes[0][*p]++;
+
+        for (auto idx = 0U; idx < MAX_NUMBER_OF_BYTES; idx++)
+            histogram[idx] += static_cast<uint64>(lanes[0][idx]) + lanes[1][idx] + lanes[2][idx] + lanes[3][idx];
+        remaining -= slice;
     }
 }
 
@@ -26,26 +64,33 @@ void SetFrequencies(const BufferView& buffer, std::array<char, MAX_NUMBER_OF_BYT
 
     The joint entropy of variables X_1, ..., X_n is then defined by
     H(X_1, ..., X_n) congruent - sum_(x_1) ... sum_(x_n) P(x_1, ..., x_n) log_2[P(x_1, ..., x_n)].
+
+    With P(x) = c_x / n this is also
+    H(X) = log_2(n) - 1/n sum_x c_x log_2(c_x)
+    => the per-symbol term only depends on the count and can be precomputed.
 */
-double ShannonEntropy_private(const BufferView& buffer, std::array<char, MAX_NUMBER_OF_BYTES>& frequency)
+double ShannonEntropy(const Histogram& histogram, uint64 total)
 {
-    double entropy = 0.0;
-    for (auto f : frequency) {
-        if (f == 0) {
-            continue;
+    if (total == 0)
+        return 0.0;
+
+    double sum = 0.0;
+    for (auto f : histogram) {
+        if (f > 1) {
+            const auto c = static_cast<double>(f);
+            sum += c * log2(c);
         }
-        double probability = static_cast<double>(f) / buffer.GetLength();
-        entropy -= probability * log2(probability);
     }
 
-    return entropy; // max log2(n) = 8 (the entire sum)
+    // max log2(n) = 8 (the entire sum)
+    return std::max<>(log2(static_cast<double>(total)) - sum / static_cast<double>(total), 0.0);
 }
 
 double ShannonEntropy(const BufferView& buffer)
 {
-    std::array<char, MAX_NUMBER_OF_BYTES> frequency{};
-    SetFrequencies(buffer, frequency);
-    return ShannonEntropy_private(buffer, frequency);
+    Histogram frequency{};
+    UpdateHistogram(buffer, frequency);
+    return ShannonEntropy(frequency, buffer.GetLength());
 }
 
 /*
@@ -56,25 +101,189 @@ double ShannonEntropy(const BufferView& buffer)
     H_α(p_1, p_2, ..., p_n)<=H_α'(p_1, p_2, ..., p_n)
     for α<=α'.
 */
-double RenyiEntropy(const BufferView& buffer, double alpha)
+double RenyiEntropy(const Histogram& histogram, uint64 total, double alpha)
 {
-    std::array<char, MAX_NUMBER_OF_BYTES> frequency{};
-    SetFrequencies(buffer, frequency);
-
     if (alpha == 1.0) {
-        return ShannonEntropy_private(buffer, frequency);
+        return ShannonEntropy(histogram, total);
+    }
+    if (total == 0) {
+        return 0.0;
     }
 
     double sum = 0.0;
-    for (auto f : frequency) {
+    for (auto f : histogram) {
         if (f > 0) {
-            const double probability = static_cast<double>(f) / buffer.GetLength();
+            const double probability = static_cast<double>(f) / total;
             sum += pow(probability, alpha);
         }
     }
 
     // Convert to bits if using log base e
-    // return std::max(((1.0 / (1.0 - alpha)) * log(sum)) / log(2), 0.0);
     return ((1.0 / (1.0 - alpha)) * log(sum)) / log(2);
 }
+
+double RenyiEntropy(const BufferView& buffer, double alpha)
+{
+    Histogram frequency{};
+    UpdateHistogram(buffer, frequency);
+    return RenyiEntropy(frequency, buffer.GetLength(), alpha);
+}
+
+/*
+    The profile is computed from sum_x T(c_x) where T(c) = c log_2(c) for Shannon and T(c) = c^α for Rényi:
+    Shannon: H = log_2(n) - S / n
+    Rényi  : H = (log_2(S) - α log_2(n)) / (1 - α)
+    T(c) does not depend on the block size => one table for the entire profile.
+*/
+class BlockEvaluator
+{
+    std::vector<double> table;
+    double alpha;
+
+  public:
+    BlockEvaluator(uint32 blockSize, double alpha) : alpha(alpha)
+    {
+        table.resize(static_cast<size_t>(std::min<>(blockSize, MAX_TABLE_COUNT)) + 1);
+        table[0] = 0.0;
+        for (auto idx = 1U; idx < table.size(); idx++) {
+            const auto c = static_cast<double>(idx);
+            table[idx]   = alpha == 1.0 ? c * log2(c) : pow(c, alpha);
+        }
+    }
+    inline double Term(uint64 count) const
+    {
+        if (count < table.size())
+            return table[count];
+        const auto c = static_cast<double>(count);
+        return alpha == 1.0 ? c * log2(c) : pow(c, alpha);
+    }
+    double Compute(double sum, uint64 total) const
+    {
+        if (total == 0)
+            return 0.0;
+        const auto n = static_cast<double>(total);
+        if (alpha == 1.0)
+            return std::max<>(log2(n) - sum / n, 0.0);
+        return (log2(sum) - alpha * log2(n)) / (1.0 - alpha);
+    }
+};
+
+bool ComputeProfile(Utils::DataCache& cache, uint64 offset, uint64 size, uint32 blockSize, double alpha, std::vector<double>& profile)
+{
+    profile.clear();
+    CHECK(blockSize > 0, false, "Invalid block size (0)");
+    CHECK(offset <= cache.GetSize(), false, "Invalid offset (0x%llX)", offset);
+    size = std::min<>(size, cache.GetSize() - offset);
+    if (size == 0)
+        return true;
+
+    const auto blocksCount = (size + blockSize - 1) / blockSize;
+    profile.reserve(static_cast<size_t>(blocksCount));
+
+    const BlockEvaluator evaluator(blockSize, alpha);
+    const auto smallBlocks = blockSize < SMALL_BLOCK_SIZE;
+    Histogram histogram{};
+    std::array<uint8, MAX_NUMBER_OF_BYTES> touched; // symbols present in the current block (small blocks only)
+    uint32 touchedCount = 0;
+    uint64 blockFilled  = 0;
+
+    const auto CloseBlock = [&]()
+    {
+        double sum = 0.0;
+        if (smallBlocks) {
+            for (auto idx = 0U; idx < touchedCount; idx++) {
+                sum += evaluator.Term(histogram[touched[idx]]);
+                histogram[touched[idx]] = 0;
+            }
+            touchedCount = 0;
+        } else {
+            for (auto& f : histogram) {
+                sum += evaluator.Term(f);
+                f = 0;
+            }
+        }
+        profile.push_back(evaluator.Compute(sum, blockFilled));
+        blockFilled = 0;
+    };
+
+    // the blocks are counted while the chunks are streamed => a block can span two (or more) chunks
+    Utils::DataCache::SequentialReader reader(cache, offset, size);
+    for (auto chunk = reader.Next(); !chunk.Empty(); chunk = reader.Next()) {
+        auto p         = chunk.GetData();
+        auto remaining = static_cast<uint64>(chunk.GetLength());
+        while (remaining > 0) {
+            const auto sz = std::min<>(remaining, blockSize - blockFilled);
+            if (smallBlocks) {
+                for (auto e = p + sz; p < e; p++) {
+                    if (histogram[*p]++ == 0)
+                        touched[touchedCount++] = *p;
+                }
+            } else {
+                UpdateHistogram(BufferView(p, static_cast<size_t>(sz)), histogram);
+                p += sz;
+            }
+            remaining -= sz;
+            blockFilled += sz;
+            if (blockFilled == blockSize)
+                CloseBlock();
+        }
+    }
+    CHECK(reader.HasFailed() == false, false, "Fail to read range [0x%llX, size: 0x%llX]", offset, size);
+    if (blockFilled > 0)
+        CloseBlock();
+    return true;
+}
+
+static int64 FixedPointTerm(uint64 count)
+{
+    if (count < 2)
+        return 0;
+    const auto c = static_cast<double>(count);
+    return static_cast<int64>(llround(c * log2(c) * static_cast<double>(1ULL << FIXED_POINT_SHIFT)));
+}
+
+SlidingWindow::SlidingWindow(uint32 windowSize)
+{
+    windowSize = std::max<>(windowSize, 1U);
+    window.resize(windowSize);
+    cLogC.resize(static_cast<size_t>(std::min<>(windowSize, MAX_TABLE_COUNT)) + 1);
+    for (auto idx = 0U; idx < cLogC.size(); idx++)
+        cLogC[idx] = FixedPointTerm(idx);
+    Reset();
+}
+void SlidingWindow::Reset()
+{
+    counts.fill(0);
+    position = 0;
+    filled   = 0;
+    sum      = 0;
+}
+void SlidingWindow::Add(uint8 value)
+{
+    // only two counters change => S is updated with the difference of their terms
+    const auto Term = [this](uint32 count) { return count < cLogC.size() ? cLogC[count] : FixedPointTerm(count); };
+
+    if (filled == window.size()) {
+        const auto old = window[position];
+        sum -= Term(counts[old]);
+        counts[old]--;
+        sum += Term(counts[old]);
+    } else {
+        filled++;
+    }
+    sum -= Term(counts[value]);
+    counts[value]++;
+    sum += Term(counts[value]);
+
+    window[position] = value;
+    position         = position + 1 == window.size() ? 0 : position + 1;
+}
+double SlidingWindow::GetEntropy() const
+{
+    if (filled == 0)
+        return 0.0;
+    const auto n = static_cast<double>(filled);
+    const auto s = static_cast<double>(sum) / static_cast<double>(1ULL << FIXED_POINT_SHIFT);
+    return std::max<>(log2(n) - s / n, 0.0);
+}
 } // namespace GView::Entropy
@@ -1,9 +1,11 @@
-#include "Internal.hpp"
+#include "CPU.hpp"
 
 namespace GView::Hashes
 {
 constexpr uint32 ADLER32_BASE         = 65521;
 constexpr uint32 ADLER32_MODULO_VALUE = 8;
+constexpr uint32 ADLER32_BLOCK_SIZE   = 32;
+constexpr uint32 ADLER32_NMAX         = 5552; // largest n for which 255 * n * (n + 1) / 2 + (n + 1) * (BASE - 1) fits in 32 bits
 
 bool Adler32::Init()
 {
@@ -15,10 +17,9 @@ bool Adler32::Init()
     return true;
 }
 
-bool Adler32::Update(const unsigned char* input, uint32 length)
+// reference implementation (the sums are reduced every 8 bytes)
+static void UpdateReference(uint32& a, uint32& b, const uint8* input, size_t length)
 {
-    CHECK(input != nullptr, false, "");
-
     uint32 s1 = a;
     uint32 s2 = b;
 
@@ -67,6 +68,126 @@ bool Adler32::Update(const unsigned char* input, uint32 length)
         s2 %= ADLER32_BASE;
     }
 
+    a = s1;
+    b = s2;
+}
+
+#ifdef GVIEW_HASHES_X86
+// For a block of 32 bytes: s1 += sum(bytes) and s2 += 32 * s1 + sum((32 - i) * bytes[i]). The sums are kept in
+// 32-bit lanes and reduced after at most ADLER32_NMAX bytes.
+HASHES_TARGET("ssse3") static void UpdateSSSE3(uint32& a, uint32& b, const uint8* input, size_t length)
+{
+    uint32 s1   = a;
+    uint32 s2   = b;
+    auto blocks = length / ADLER32_BLOCK_SIZE;
+    length -= blocks * ADLER32_BLOCK_SIZE;
+
+    const auto tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const auto tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const auto zero = _mm_setzero_si128();
+    const auto ones = _mm_set1_epi16(1);
+
+    while (blocks > 0)
+    {
+        auto n = std::min<size_t>(ADLER32_NMAX / ADLER32_BLOCK_SIZE, blocks);
+        blocks -= n;
+
+        auto vps = _mm_cvtsi32_si128(static_cast<int32>(s1 * n)); // s1 is added 32 times for every block
+        auto vs1 = _mm_setzero_si128();
+        auto vs2 = _mm_cvtsi32_si128(static_cast<int32>(s2));
+        do
+        {
+            const auto bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+            const auto bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16));
+            vps               = _mm_add_epi32(vps, vs1);
+            vs1               = _mm_add_epi32(vs1, _mm_add_epi32(_mm_sad_epu8(bytes1, zero), _mm_sad_epu8(bytes2, zero)));
+            vs2               = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            vs2               = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            input += ADLER32_BLOCK_SIZE;
+        } while (--n);
+        vs2 = _mm_add_epi32(vs2, _mm_slli_epi32(vps, 5));
+
+        // horizontal sums
+        vs1 = _mm_add_epi32(vs1, _mm_shuffle_epi32(vs1, _MM_SHUFFLE(1, 0, 3, 2)));
+        vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(2, 3, 0, 1)));
+        vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1  = (s1 + static_cast<uint32>(_mm_cvtsi128_si32(vs1))) % ADLER32_BASE;
+        s2  = static_cast<uint32>(_mm_cvtsi128_si32(vs2)) % ADLER32_BASE;
+    }
+
+    UpdateReference(s1, s2, input, length);
+    a = s1;
+    b = s2;
+}
+
+HASHES_TARGET("avx2") static void UpdateAVX2(uint32& a, uint32& b, const uint8* input, size_t length)
+{
+    uint32 s1   = a;
+    uint32 s2   = b;
+    auto blocks = length / ADLER32_BLOCK_SIZE;
+    length -= blocks * ADLER32_BLOCK_SIZE;
+
+    const auto tap = _mm256_setr_epi8(
+          32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const auto zero = _mm256_setzero_si256();
+    const auto ones = _mm256_set1_epi16(1);
+
+    while (blocks > 0)
+    {
+        auto n = std::min<size_t>(ADLER32_NMAX / ADLER32_BLOCK_SIZE, blocks);
+        blocks -= n;
+
+        auto vps = _mm256_setr_epi32(static_cast<int32>(s1 * n), 0, 0, 0, 0, 0, 0, 0); // s1 is added 32 times for every block
+        auto vs1 = _mm256_setzero_si256();
+        auto vs2 = _mm256_setr_epi32(static_cast<int32>(s2), 0, 0, 0, 0, 0, 0, 0);
+        do
+        {
+            const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+            vps              = _mm256_add_epi32(vps, vs1);
+            vs1              = _mm256_add_epi32(vs1, _mm256_sad_epu8(bytes, zero));
+            vs2              = _mm256_add_epi32(vs2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+            input += ADLER32_BLOCK_SIZE;
+        } while (--n);
+        vs2 = _mm256_add_epi32(vs2, _mm256_slli_epi32(vps, 5));
+
+        // horizontal sums
+        auto h1 = _mm_add_epi32(_mm256_castsi256_si128(vs1), _mm256_extracti128_si256(vs1, 1));
+        auto h2 = _mm_add_epi32(_mm256_castsi256_si128(vs2), _mm256_extracti128_si256(vs2, 1));
+        h1      = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(1, 0, 3, 2)));
+        h2      = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(2, 3, 0, 1)));
+        h2      = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1      = (s1 + static_cast<uint32>(_mm_cvtsi128_si32(h1))) % ADLER32_BASE;
+        s2      = static_cast<uint32>(_mm_cvtsi128_si32(h2)) % ADLER32_BASE;
+    }
+
+    UpdateReference(s1, s2, input, length);
+    a = s1;
+    b = s2;
+}
+#endif
+
+using UpdateKernel = void (*)(uint32& a, uint32& b, const uint8* input, size_t length);
+static UpdateKernel SelectKernel()
+{
+#ifdef GVIEW_HASHES_X86
+    const auto& features = CPU::GetFeatures();
+    if (features.avx2)
+        return UpdateAVX2;
+    if (features.ssse3)
+        return UpdateSSSE3;
+#endif
+    return UpdateReference;
+}
+static const UpdateKernel updateKernel = SelectKernel();
+
+bool Adler32::Update(const unsigned char* input, uint32 length)
+{
+    CHECK(input != nullptr, false, "");
+
+    uint32 s1 = a;
+    uint32 s2 = b;
+    updateKernel(s1, s2, input, length);
+
     CHECK(s1 < ADLER32_BASE, false, "");
     CHECK(s2 < ADLER32_BASE, false, "");
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Internal.hpp"
+
+// Runtime CPU features detection for the hash kernels. The accelerated kernels are compiled with a target
+// attribute (GCC / Clang) so the rest of the binary does not require these instruction sets.
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64) || defined(__i386__) || defined(_M_IX86)
+#    define GVIEW_HASHES_X86
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define HASHES_TARGET(features)
+#    else
+#        include <cpuid.h>
+#        define HASHES_TARGET(features) __attribute__((target(features)))
+#    endif
+#    include <immintrin.h>
+#endif
+
+namespace GView::Hashes::CPU
+{
+struct Features
+{
+    bool ssse3{ false };
+    bool sse41{ false };
+    bool pclmul{ false };
+    bool avx2{ false };
+};
+
+#ifdef GVIEW_HASHES_X86
+inline void CPUID(uint32 leaf, uint32 subLeaf, uint32 (&registers)[4])
+{
+#    if defined(_MSC_VER)
+    int32 values[4];
+    __cpuidex(values, static_cast<int32>(leaf), static_cast<int32>(subLeaf));
+    for (auto idx = 0U; idx < 4; idx++)
+        registers[idx] = static_cast<uint32>(values[idx]);
+#    else
+    __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#    endif
+}
+inline uint64 XGETBV()
+{
+#    if defined(_MSC_VER)
+    return _xgetbv(0);
+#    else
+    uint32 eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64>(edx) << 32) | eax;
+#    endif
+}
+#endif
+
+inline Features Detect()
+{
+    Features f;
+#ifdef GVIEW_HASHES_X86
+    uint32 r[4]; // eax, ebx, ecx, edx
+    CPUID(0, 0, r);
+    const auto maxLeaf = r[0];
+    if (maxLeaf < 1)
+        return f;
+    CPUID(1, 0, r);
+    f.ssse3  = (r[2] & (1U << 9)) != 0;
+    f.sse41  = (r[2] & (1U << 19)) != 0;
+    f.pclmul = (r[2] & (1U << 1)) != 0;
+
+    // AVX2 also requires the OS to save the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+    const auto osxsave = (r[2] & (1U << 27)) != 0;
+    if ((maxLeaf >= 7) && osxsave && ((XGETBV() & 0x6) == 0x6))
+    {
+        CPUID(7, 0, r);
+        f.avx2 = (r[1] & (1U << 5)) != 0;
+    }
+#endif
+    return f;
+}
+
+inline const Features& GetFeatures()
+{
+    static const Features features = Detect();
+    return features;
+}
+} // namespace GView::Hashes::CPU
@@ -1,8 +1,10 @@
-#include "Internal.hpp"
+#include "CPU.hpp"
+
+#include <array>
 
 namespace GView::Hashes
 {
-static const uint32 CRC32Table[] = {
+static constexpr uint32 CRC32Table[256] = {
     0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L, 0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0x0edb8832L, 0x79dcb8a4L,
     0xe0d5e91eL, 0x97d2d988L, 0x09b64c2bL, 0x7eb17cbdL, 0xe7b82d07L, 0x90bf1d91L, 0x1db71064L, 0x6ab020f2L, 0xf3b97148L, 0x84be41deL,
     0x1adad47dL, 0x6ddde4ebL, 0xf4d4b551L, 0x83d385c7L, 0x136c9856L, 0x646ba8c0L, 0xfd62f97aL, 0x8a65c9ecL, 0x14015c4fL, 0x63066cd9L,
@@ -40,18 +42,130 @@ bool CRC32::Init(CRC32Type type)
     return true;
 }
 
-bool CRC32::Update(const unsigned char* input, uint32 length)
+// CRC32Table[b] is the CRC of byte b; SlicingTables[k][b] is the CRC of byte b followed by k zero bytes
+static constexpr auto SlicingTables = []()
 {
-    CHECK(input != nullptr, false, "");
-    uint32 crc = value;
+    std::array<std::array<uint32, 256>, 16> tables{};
+    for (auto idx = 0U; idx < 256; idx++)
+        tables[0][idx] = CRC32Table[idx];
+    for (auto k = 1U; k < 16; k++)
+    {
+        for (auto idx = 0U; idx < 256; idx++)
+            tables[k][idx] = (tables[k - 1][idx] >> 8) ^ CRC32Table[tables[k - 1][idx] & 0xFF];
+    }
+    return tables;
+}();
 
+// reference implementation (one byte at a time)
+static uint32 UpdateBytes(uint32 crc, const uint8* input, size_t length)
+{
     while (length--)
     {
         crc = CRC32Table[(crc & 0xff) ^ *input++] ^ (crc >> 8);
     }
+    return crc;
+}
+
+// slicing by 16: 16 independent table lookups for every 16 bytes
+static uint32 UpdateSlicing16(uint32 crc, const uint8* input, size_t length)
+{
+    const auto& t = SlicingTables;
+    while (length >= 16)
+    {
+        const auto x = crc ^ (static_cast<uint32>(input[0]) | (static_cast<uint32>(input[1]) << 8) | (static_cast<uint32>(input[2]) << 16) |
+                              (static_cast<uint32>(input[3]) << 24));
+        crc = t[15][x & 0xFF] ^ t[14][(x >> 8) & 0xFF] ^ t[13][(x >> 16) & 0xFF] ^ t[12][x >> 24] ^ t[11][input[4]] ^ t[10][input[5]] ^
+              t[9][input[6]] ^ t[8][input[7]] ^ t[7][input[8]] ^ t[6][input[9]] ^ t[5][input[10]] ^ t[4][input[11]] ^ t[3][input[12]] ^
+              t[2][input[13]] ^ t[1][input[14]] ^ t[0][input[15]];
+        input += 16;
+        length -= 16;
+    }
+    return UpdateBytes(crc, input, length);
+}
+
+#ifdef GVIEW_HASHES_X86
+// Carry-less multiplication folding ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ", Intel).
+// Four 128-bit accumulators are folded 64 bytes at a time, then merged and folded 16 bytes at a time.
+// The constants are x^(n) mod P for the reflected polynomial 0xEDB88320 (bit reflected and shifted).
+HASHES_TARGET("pclmul,sse4.1") static inline __m128i Fold(__m128i x, __m128i k, __m128i next)
+{
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next);
+}
+HASHES_TARGET("pclmul,sse4.1") static uint32 UpdatePCLMUL(uint32 crc, const uint8* input, size_t length)
+{
+    if (length < 64)
+        return UpdateSlicing16(crc, input, length);
+
+    const auto k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const auto k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const auto k5   = _mm_set_epi64x(0, 0x0163cd6124);
+    const auto poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16));
+    auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 32));
+    auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 48));
+    x1      = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int32>(crc)));
+    input += 64;
+    length -= 64;
+
+    while (length >= 64)
+    {
+        x1 = Fold(x1, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+        x2 = Fold(x2, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16)));
+        x3 = Fold(x3, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 32)));
+        x4 = Fold(x4, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 48)));
+        input += 64;
+        length -= 64;
+    }
+
+    // 4 x 128 bits --> 128 bits
+    x1 = Fold(x1, k3k4, x2);
+    x1 = Fold(x1, k3k4, x3);
+    x1 = Fold(x1, k3k4, x4);
+    while (length >= 16)
+    {
+        x1 = Fold(x1, k3k4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+        input += 16;
+        length -= 16;
+    }
+
+    // 128 bits --> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5, 0x00), x2);
 
-    value = crc;
+    // Barrett reduction --> 32 bits
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = static_cast<uint32>(_mm_extract_epi32(x1, 1));
 
+    return UpdateBytes(crc, input, length);
+}
+#endif
+
+using UpdateKernel = uint32 (*)(uint32 crc, const uint8* input, size_t length);
+static UpdateKernel SelectKernel()
+{
+#ifdef GVIEW_HASHES_X86
+    const auto& features = CPU::GetFeatures();
+    if (features.pclmul && features.sse41)
+        return UpdatePCLMUL;
+#endif
+    return UpdateSlicing16;
+}
+static const UpdateKernel updateKernel = SelectKernel();
+
+bool CRC32::Update(const unsigned char* input, uint32 length)
+{
+    CHECK(input != nullptr, false, "");
+    value = updateKernel(value, input, length);
     return true;
 }
 
@@ -1,8 +1,10 @@
-#include "Internal.hpp"
+#include "CPU.hpp"
+
+#include <array>
 
 namespace GView::Hashes
 {
-static const uint64 CRC64Table[256] = {
+static constexpr uint64 CRC64Table[256] = {
     0x0000000000000000, 0x42F0E1EBA9EA3693, 0x85E1C3D753D46D26, 0xC711223CFA3E5BB5, 0x493366450E42ECDF, 0x0BC387AEA7A8DA4C,
     0xCCD2A5925D9681F9, 0x8E224479F47CB76A, 0x9266CC8A1C85D9BE, 0xD0962D61B56FEF2D, 0x17870F5D4F51B498, 0x5577EEB6E6BB820B,
     0xDB55AACF12C73561, 0x99A54B24BB2D03F2, 0x5EB4691841135847, 0x1C4488F3E8F96ED4, 0x663D78FF90E185EF, 0x24CD9914390BB37C,
@@ -65,19 +67,137 @@ bool CRC64::Init(CRC64Type type)
     return true;
 }
 
-bool CRC64::Update(const unsigned char* input, uint32 length)
+// ECMA-182 polynomial (not reflected, x^64 is implicit)
+constexpr uint64 CRC64_POLYNOMIAL = 0x42F0E1EBA9EA3693;
+
+// CRC64Table[b] is the CRC of byte b; SlicingTables[k][b] is the CRC of byte b followed by k zero bytes
+static constexpr auto SlicingTables = []()
 {
-    CHECK(input != nullptr, false, "");
-    uint64 crc = value;
+    std::array<std::array<uint64, 256>, 8> tables{};
+    for (auto idx = 0U; idx < 256; idx++)
+        tables[0][idx] = CRC64Table[idx];
+    for (auto k = 1U; k < 8; k++)
+    {
+        for (auto idx = 0U; idx < 256; idx++)
+            tables[k][idx] = (tables[k - 1][idx] << 8) ^ CRC64Table[tables[k - 1][idx] >> 56];
+    }
+    return tables;
+}();
 
+// reference implementation (one byte at a time)
+static uint64 UpdateBytes(uint64 crc, const uint8* input, size_t length)
+{
     while (length--)
     {
         uint64 i = ((uint64) (crc >> 56) ^ *input++) & 0xFF;
         crc      = CRC64Table[i] ^ (crc << 8);
     }
+    return crc;
+}
+
+// slicing by 8: 8 independent table lookups for every 8 bytes
+static uint64 UpdateSlicing8(uint64 crc, const uint8* input, size_t length)
+{
+    const auto& t = SlicingTables;
+    while (length >= 8)
+    {
+        uint64 x = 0;
+        for (auto idx = 0U; idx < 8; idx++)
+            x = (x << 8) | input[idx];
+        x ^= crc;
+        crc = t[7][x >> 56] ^ t[6][(x >> 48) & 0xFF] ^ t[5][(x >> 40) & 0xFF] ^ t[4][(x >> 32) & 0xFF] ^ t[3][(x >> 24) & 0xFF] ^
+              t[2][(x >> 16) & 0xFF] ^ t[1][(x >> 8) & 0xFF] ^ t[0][x & 0xFF];
+        input += 8;
+        length -= 8;
+    }
+    return UpdateBytes(crc, input, length);
+}
 
-    value = crc;
+#ifdef GVIEW_HASHES_X86
+// x^n mod P
+static constexpr uint64 XPowModP(uint32 n)
+{
+    uint64 r = 1;
+    while (n--)
+        r = (r & 0x8000000000000000ULL) ? ((r << 1) ^ CRC64_POLYNOMIAL) : (r << 1);
+    return r;
+}
 
+// The blocks are byte swapped so that the first bit of the stream is the most significant one (the polynomial is
+// not reflected). Folding a 128-bit accumulator A over n bits: A * x^n = A.hi * x^(n + 64) + A.lo * x^n (mod P).
+HASHES_TARGET("pclmul,ssse3") static inline __m128i Fold(__m128i x, __m128i k, __m128i next)
+{
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next);
+}
+HASHES_TARGET("pclmul,ssse3") static inline __m128i Load(__m128i swap, const uint8* p)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), swap);
+}
+HASHES_TARGET("pclmul,ssse3") static uint64 UpdatePCLMUL(uint64 crc, const uint8* input, size_t length)
+{
+    if (length < 64)
+        return UpdateSlicing8(crc, input, length);
+
+    constexpr uint64 k4hi = XPowModP(512 + 64), k4lo = XPowModP(512); // 4 blocks (64 bytes)
+    constexpr uint64 k1hi = XPowModP(128 + 64), k1lo = XPowModP(128); // 1 block (16 bytes)
+
+    const auto swap  = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const auto fold4 = _mm_set_epi64x(static_cast<int64>(k4hi), static_cast<int64>(k4lo));
+    const auto fold1 = _mm_set_epi64x(static_cast<int64>(k1hi), static_cast<int64>(k1lo));
+
+    auto x1 = _mm_xor_si128(Load(swap, input), _mm_set_epi64x(static_cast<int64>(crc), 0));
+    auto x2 = Load(swap, input + 16);
+    auto x3 = Load(swap, input + 32);
+    auto x4 = Load(swap, input + 48);
+    input += 64;
+    length -= 64;
+
+    while (length >= 64)
+    {
+        x1 = Fold(x1, fold4, Load(swap, input));
+        x2 = Fold(x2, fold4, Load(swap, input + 16));
+        x3 = Fold(x3, fold4, Load(swap, input + 32));
+        x4 = Fold(x4, fold4, Load(swap, input + 48));
+        input += 64;
+        length -= 64;
+    }
+
+    // 4 x 128 bits --> 128 bits
+    x1 = Fold(x1, fold1, x2);
+    x1 = Fold(x1, fold1, x3);
+    x1 = Fold(x1, fold1, x4);
+    while (length >= 16)
+    {
+        x1 = Fold(x1, fold1, Load(swap, input));
+        input += 16;
+        length -= 16;
+    }
+
+    // the accumulator is congruent with the data processed so far => its CRC (starting from 0) is the result
+    uint8 last[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(last), _mm_shuffle_epi8(x1, swap));
+    crc = UpdateSlicing8(0, last, sizeof(last));
+
+    return UpdateSlicing8(crc, input, length);
+}
+#endif
+
+using UpdateKernel = uint64 (*)(uint64 crc, const uint8* input, size_t length);
+static UpdateKernel SelectKernel()
+{
+#ifdef GVIEW_HASHES_X86
+    const auto& features = CPU::GetFeatures();
+    if (features.pclmul && features.ssse3)
+        return UpdatePCLMUL;
+#endif
+    return UpdateSlicing8;
+}
+static const UpdateKernel updateKernel = SelectKernel();
+
+bool CRC64::Update(const unsigned char* input, uint32 length)
+{
+    CHECK(input != nullptr, false, "");
+    value = updateKernel(value, input, length);
     return true;
 }
 
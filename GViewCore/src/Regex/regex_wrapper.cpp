@@ -18,6 +18,11 @@ bool Matcher::Init(std::string_view expression, bool isUnicode, bool isCaseSensi
     RE2::Options options;
     options.set_case_sensitive(isCaseSensitive);
     options.set_longest_match(false);
+    options.set_log_errors(false);
+    if (!isUnicode) {
+        // every byte is a character (the buffers are not required to be valid UTF-8)
+        options.set_encoding(RE2::Options::EncodingLatin1);
+    }
 
     absl::string_view asv{ expression.data(), expression.size() };
 
@@ -29,7 +34,14 @@ bool Matcher::Init(std::string_view expression, bool isUnicode, bool isCaseSensi
 
     this->context = c;
 
-    return true;
+    return c->expression.ok();
+}
+
+std::string_view Matcher::GetError() const
+{
+    auto ctx = reinterpret_cast<const Context*>(this->context);
+    CHECK(ctx != nullptr, "", "");
+    return ctx->expression.error();
 }
 
 Matcher::~Matcher()
@@ -62,6 +62,7 @@ Plugin::Plugin()
     this->fnValidate       = nullptr;
     this->fnCreateInstance = nullptr;
     this->fnPopulateWindow = nullptr;
+    this->fnUpdate         = nullptr;
 }
 void Plugin::Init()
 {
@@ -168,6 +169,7 @@ bool Plugin::LoadPlugin()
     this->fnValidate       = lib.GetFunction<decltype(this->fnValidate)>("Validate");
     this->fnCreateInstance = lib.GetFunction<decltype(this->fnCreateInstance)>("CreateInstance");
     this->fnPopulateWindow = lib.GetFunction<decltype(this->fnPopulateWindow)>("PopulateWindow");
+    this->fnUpdate         = lib.GetFunction<decltype(this->fnUpdate)>("Update"); // optional (used by the headless analysis)
 
     CHECK(fnValidate, false, "Missing 'Validate' export !");
     CHECK(fnCreateInstance, false, "Missing 'CreateInstance' export !");
@@ -207,7 +209,31 @@ bool Plugin::MatchContent(AppCUI::Utils::BufferView buf, Matcher::TextParser& te
     }
     return false;
 }
-bool Plugin::IsOfType(AppCUI::Utils::BufferView buf, Matcher::TextParser& textParser, const std::string_view& extension)
+void Plugin::GetIndexKeys(std::vector<uint64>& extensionHashes, std::vector<int32>& leadingBytes) const
+{
+    extensionHashes.clear();
+    leadingBytes.clear();
+    if (this->extensions.empty())
+    {
+        if (this->extension != EXTENSION_EMPTY_HASH)
+            extensionHashes.push_back(this->extension);
+    }
+    else
+    {
+        extensionHashes.insert(extensionHashes.end(), this->extensions.begin(), this->extensions.end());
+    }
+    if (this->patterns.empty())
+    {
+        if (this->pattern)
+            leadingBytes.push_back(this->pattern->GetLeadingByte());
+    }
+    else
+    {
+        for (auto* p : this->patterns)
+            leadingBytes.push_back(p->GetLeadingByte());
+    }
+}
+bool Plugin::Load()
 {
     if (this->Invalid)
         return false;
@@ -215,9 +241,13 @@ bool Plugin::IsOfType(AppCUI::Utils::BufferView buf, Matcher::TextParser& textPa
     {
         this->Invalid = !LoadPlugin();
         this->Loaded  = !this->Invalid;
-        if (this->Invalid)
-            return false; // something went wrong when loading he plugin
     }
+    return this->Loaded;
+}
+bool Plugin::IsOfType(AppCUI::Utils::BufferView buf, Matcher::TextParser& textParser, const std::string_view& extension)
+{
+    if (!Load())
+        return false; // something went wrong when loading he plugin
     // all good -> code is loaded
     return fnValidate(buf, extension);
 }
@@ -234,3 +264,10 @@ TypeInterface* Plugin::CreateInstance() const
     CHECK(this->Loaded, nullptr, "Plugin was no loaded. Have you call `Validate` first ?");
     return this->fnCreateInstance();
 }
+bool Plugin::Update(Reference<GView::Object> object) const
+{
+    CHECK(!this->Invalid, false, "Invalid plugin (not loaded properly or no valid exports)");
+    CHECK(this->Loaded, false, "Plugin was no loaded. Have you call `Validate` first ?");
+    CHECK(this->fnUpdate, false, "Plugin does not export 'Update' !");
+    return this->fnUpdate(object);
+}
@@ -0,0 +1,68 @@
+#include "Internal.hpp"
+
+using namespace GView::Type;
+
+void PluginsIndex::Build(const std::vector<Plugin>& plugins)
+{
+    std::vector<uint64> extensionHashes;
+    std::vector<int32> leadingBytes;
+
+    this->byExtension.clear();
+    this->textMatchers.clear();
+    for (auto& list : this->byLeadingByte)
+        list.clear();
+
+    // plugins are visited in priority order, so every list ends up sorted and a plugin is always the last entry added
+    for (auto idx = 0U; idx < static_cast<uint32>(plugins.size()); idx++)
+    {
+        plugins[idx].GetIndexKeys(extensionHashes, leadingBytes);
+        for (auto hash : extensionHashes)
+        {
+            auto& list = this->byExtension[hash];
+            if (list.empty() || (list.back() != idx))
+                list.push_back(idx);
+        }
+        for (auto value : leadingBytes)
+        {
+            auto& list = value < 0 ? this->textMatchers : this->byLeadingByte[value & 0xFF];
+            if (list.empty() || (list.back() != idx))
+                list.push_back(idx);
+        }
+    }
+}
+std::span<const uint32> PluginsIndex::GetExtensionCandidates(uint64 extensionHash) const
+{
+    if (extensionHash == 0)
+        return {};
+    auto it = this->byExtension.find(extensionHash);
+    if (it == this->byExtension.end())
+        return {};
+    return { it->second.data(), it->second.size() };
+}
+void PluginsIndex::GetContentCandidates(AppCUI::Utils::BufferView buf, std::vector<uint32>& candidates) const
+{
+    candidates.clear();
+    if (buf.Empty())
+    {
+        candidates.insert(candidates.end(), this->textMatchers.begin(), this->textMatchers.end());
+        return;
+    }
+    // merge the two sorted lists (a plugin can be in both if it mixes magic and text patterns)
+    const auto& magic = this->byLeadingByte[buf[0]];
+    candidates.reserve(magic.size() + this->textMatchers.size());
+    auto m = magic.begin();
+    auto t = this->textMatchers.begin();
+    while ((m != magic.end()) || (t != this->textMatchers.end()))
+    {
+        if ((t == this->textMatchers.end()) || ((m != magic.end()) && ((*m) < (*t))))
+            candidates.push_back(*(m++));
+        else if ((m == magic.end()) || ((*t) < (*m)))
+            candidates.push_back(*(t++));
+        else
+        {
+            candidates.push_back(*m);
+            m++;
+            t++;
+        }
+    }
+}
@@ -2,42 +2,58 @@
 
 namespace GView::Type::Matcher
 {
-TextParser::TextParser(const char16* text, uint32 size)
+using namespace GView::Utils;
+
+TextParser::TextParser(AppCUI::Utils::BufferView _buf) : buf(_buf)
+{
+    this->Raw.text           = nullptr;
+    this->Raw.size           = 0;
+    this->Text.text          = nullptr;
+    this->Text.size          = 0;
+    this->Text.computed      = false;
+    this->Lines.computed     = false;
+    this->Detected.bomLength = 0;
+    this->Detected.value     = CharacterEncoding::Encoding::Binary;
+    this->Detected.computed  = false;
+}
+TextParser::~TextParser()
+{
+    this->converted.Destroy();
+}
+void TextParser::ComputeEncoding()
+{
+    this->Detected.value    = CharacterEncoding::AnalyzeBufferForEncoding(this->buf, true, this->Detected.bomLength);
+    this->Detected.computed = true;
+}
+void TextParser::ComputeText()
 {
-    this->Lines.computed = false;
+    this->Text.computed = true;
+    if (!this->Detected.computed)
+        ComputeEncoding();
+    if (this->Detected.value == CharacterEncoding::Encoding::Binary)
+        return;
 
-    if ((text == nullptr) || (size == 0))
-    {
-        this->Raw.text  = nullptr;
-        this->Text.text = nullptr;
-        this->Raw.size  = 0;
-        this->Text.size = 0;
-    }
-    else
-    {
-        this->Raw.text = text;
-        this->Raw.size = size;
+    this->converted = CharacterEncoding::ConvertToUnicode16(this->buf, this->Detected.value, this->Detected.bomLength);
+    if ((this->converted.text == nullptr) || (this->converted.size == 0))
+        return;
 
-        auto p = text;
-        auto e = text + size;
-        while ((p < e) && (((*p) == ' ') || ((*p) == '\t') || ((*p) == '\n') || ((*p) == '\r')))
-            p++;
-        if (p == e)
-        {
-            this->Raw.text  = nullptr;
-            this->Text.text = nullptr;
-            this->Raw.size  = 0;
-            this->Text.size = 0;
-        }
-        else
-        {
-            this->Text.text = p;
-            this->Text.size = static_cast<uint32>(e - p);
-        }
-    }
+    auto p = this->converted.text;
+    auto e = p + this->converted.size;
+    while ((p < e) && (((*p) == ' ') || ((*p) == '\t') || ((*p) == '\n') || ((*p) == '\r')))
+        p++;
+    if (p == e)
+        return;
+
+    this->Raw.text  = this->converted.text;
+    this->Raw.size  = this->converted.size;
+    this->Text.text = p;
+    this->Text.size = static_cast<uint32>(e - p);
 }
 void TextParser::ComputeLineOffsets()
 {
+    if (!this->Text.computed)
+        ComputeText();
+
     auto p            = this->Text.text;
     auto e            = this->Text.text + this->Text.size;
     auto maxLines     = ARRAY_LEN(this->Lines.offsets);
@@ -58,4 +74,4 @@ void TextParser::ComputeLineOffsets()
     }
     this->Lines.computed = true;
 }
-} // namespace GView::Type::Matcher
\ No newline at end of file
+} // namespace GView::Type::Matcher
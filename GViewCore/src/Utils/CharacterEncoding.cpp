@@ -178,7 +178,15 @@ UnicodeString ConvertToUnicode16(BufferView buf)
     if (buf.GetLength() > 0x80000000)
         return UnicodeString(); // buffer too big to be converted
     uint32 bomLength;
-    auto enc    = AnalyzeBufferForEncoding(buf, true, bomLength);
+    auto enc = AnalyzeBufferForEncoding(buf, true, bomLength);
+    return ConvertToUnicode16(buf, enc, bomLength);
+}
+UnicodeString ConvertToUnicode16(BufferView buf, Encoding enc, uint32 bomLength)
+{
+    if (buf.Empty())
+        return UnicodeString();
+    if ((buf.GetLength() > 0x80000000) || (bomLength > buf.GetLength()))
+        return UnicodeString(); // buffer too big to be converted
     char16* ptr = new char16[buf.GetLength()];
     auto pos    = ptr;
     auto start  = buf.begin() + bomLength;
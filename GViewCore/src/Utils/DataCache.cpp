@@ -1,38 +1,64 @@
 #include "GView.hpp"
 
+#if defined(BUILD_FOR_WINDOWS)
+#    include <Windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 using namespace GView::Utils;
 
 constexpr uint32 MAX_CACHE_SIZE = 0x20000000U; // 16 M
 
 DataCache::DataCache()
 {
-    this->fileObj    = nullptr;
-    this->cache      = nullptr;
-    this->cacheSize  = 0;
-    this->start      = 0;
-    this->end        = 0;
-    this->fileSize   = 0;
-    this->currentPos = 0;
+    this->fileObj       = nullptr;
+    this->cache         = nullptr;
+    this->window        = nullptr;
+    this->cacheSize     = 0;
+    this->start         = 0;
+    this->end           = 0;
+    this->fileSize      = 0;
+    this->currentPos    = 0;
+    this->mappedData    = nullptr;
+    this->accessCounter = 0;
+    this->stats         = {};
 }
 DataCache::DataCache(DataCache&& obj)
 {
-    fileObj        = obj.fileObj;
-    fileSize       = obj.fileSize;
-    start          = obj.start;
-    end            = obj.end;
-    currentPos     = obj.currentPos;
-    cache          = obj.cache;
-    cacheSize      = obj.cacheSize;
-    obj.fileObj    = nullptr;
-    obj.fileSize   = 0;
-    obj.start      = 0;
-    obj.end        = 0;
-    obj.currentPos = 0;
-    obj.cache      = nullptr;
-    obj.cacheSize  = 0;
+    fileObj           = obj.fileObj;
+    fileSize          = obj.fileSize;
+    start             = obj.start;
+    end               = obj.end;
+    currentPos        = obj.currentPos;
+    cache             = obj.cache;
+    window            = obj.window;
+    cacheSize         = obj.cacheSize;
+    mappedData        = obj.mappedData;
+    pages             = std::move(obj.pages);
+    pageToSlot        = std::move(obj.pageToSlot);
+    accessCounter     = obj.accessCounter;
+    stats             = obj.stats;
+    fileLock          = std::move(obj.fileLock);
+    obj.fileObj       = nullptr;
+    obj.fileSize      = 0;
+    obj.start         = 0;
+    obj.end           = 0;
+    obj.currentPos    = 0;
+    obj.cache         = nullptr;
+    obj.window        = nullptr;
+    obj.cacheSize     = 0;
+    obj.mappedData    = nullptr;
+    obj.accessCounter = 0;
+    obj.stats         = {};
 }
 DataCache::~DataCache()
 {
+    UnmapFile();
     if (this->fileObj)
     {
         this->fileObj->Close();
@@ -41,7 +67,8 @@ DataCache::~DataCache()
     this->fileObj = nullptr;
     if (this->cache)
         delete[] this->cache;
-    this->cache = nullptr;
+    this->cache  = nullptr;
+    this->window = nullptr;
 }
 
 bool DataCache::Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 _cacheSize)
@@ -49,32 +76,257 @@ bool DataCache::Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 _cache
     CHECK(this->cacheSize == 0, false, "Cache object already initialized !");
     this->fileObj = file.release(); // take ownership of the pointer
     CHECK(this->fileObj, false, "Expecting a valid file object poiner !");
-    _cacheSize = (_cacheSize | 0xFFFF) + 1; // a minimum of 64 K for cache
+    _cacheSize = (_cacheSize | (PAGE_SIZE - 1)) + 1; // a minimum of 64 K for cache
     if (_cacheSize == 0)
         _cacheSize = MAX_CACHE_SIZE;
     _cacheSize     = std::min(_cacheSize, MAX_CACHE_SIZE);
     this->fileSize = fileObj->GetSize();
 
-    this->cache = new uint8[_cacheSize];
-    CHECK(this->cache, false, "Fail to allocate: %u bytes", _cacheSize);
-    this->cacheSize = _cacheSize;
-    this->start     = 0;
-    this->end       = 0;
+    // any request of at most 'cacheSize' bytes spans (cacheSize / PAGE_SIZE) + 1 pages when it is not page aligned
+    // there is no need for more slots than pages in the file
+    auto slotsCount = (uint64) (_cacheSize / PAGE_SIZE) + 1;
+    slotsCount      = std::min<>(slotsCount, std::max<>((this->fileSize + PAGE_SIZE - 1) / PAGE_SIZE, (uint64) 1));
+
+    this->cache = new uint8[slotsCount * PAGE_SIZE];
+    CHECK(this->cache, false, "Fail to allocate: %llu bytes", slotsCount * PAGE_SIZE);
+    this->pages.resize((size_t) slotsCount, Page{ INVALID_OFFSET, 0 });
+    this->pageToSlot.reserve((size_t) slotsCount);
+    this->cacheSize     = _cacheSize;
+    this->window        = this->cache;
+    this->start         = 0;
+    this->end           = 0;
+    this->accessCounter = 0;
+    this->stats         = {};
+    this->fileLock      = std::make_unique<std::mutex>();
 
     return true;
 }
+bool DataCache::ReadFromFile(uint64 offset, uint8* buffer, uint32 size)
+{
+    std::lock_guard<std::mutex> lock(*this->fileLock);
+    CHECK(this->fileObj->SetCurrentPos(offset), false, "Fail to move to offset %llu", offset);
+    CHECK(this->fileObj->Read(buffer, size), false, "Fail to read %u bytes from offset %llu", size, offset);
+    return true;
+}
+uint32 DataCache::FindSlotsRun(uint32 count)
+{
+    // searches for 'count' consecutive slots whose most recent access is the oldest one
+    // (this way the pages used by the views returned by the last calls are not evicted)
+    // sliding window maximum over the LRU stamps, using a monotonic queue of slot indexes
+    const auto slotsCount = (uint32) this->pages.size();
+    if (count == 1)
+    {
+        auto bestSlot = 0U;
+        for (auto idx = 1U; idx < slotsCount; idx++)
+        {
+            if (this->pages[idx].lastAccess < this->pages[bestSlot].lastAccess)
+                bestSlot = idx;
+        }
+        return bestSlot;
+    }
+    std::vector<uint32> queue(slotsCount);
+    uint32 head = 0, tail = 0;
+    uint32 bestSlot  = 0;
+    uint64 bestStamp = 0xFFFFFFFFFFFFFFFFULL;
+
+    for (uint32 idx = 0; idx < slotsCount; idx++)
+    {
+        while ((tail > head) && (this->pages[queue[tail - 1]].lastAccess <= this->pages[idx].lastAccess))
+            tail--;
+        queue[tail++] = idx;
+        if (queue[head] + count <= idx)
+            head++;
+        if (idx + 1 >= count)
+        {
+            const auto stamp = this->pages[queue[head]].lastAccess;
+            if (stamp < bestStamp)
+            {
+                bestStamp = stamp;
+                bestSlot  = idx + 1 - count;
+                if (stamp == 0)
+                    break; // run of slots that were never used
+            }
+        }
+    }
+    return bestSlot;
+}
+bool DataCache::LoadPages(uint64 firstPage, uint32 count, uint32& slot)
+{
+    const auto stamp = ++this->accessCounter;
+
+    // check if the pages are already loaded in consecutive slots
+    auto it = this->pageToSlot.find(firstPage);
+    if ((it != this->pageToSlot.end()) && (it->second + count <= (uint32) this->pages.size()))
+    {
+        auto idx = 1U;
+        for (; idx < count; idx++)
+        {
+            if (this->pages[it->second + idx].index != firstPage + idx)
+                break;
+        }
+        if (idx == count)
+        {
+            for (idx = 0; idx < count; idx++)
+                this->pages[it->second + idx].lastAccess = stamp;
+            slot = it->second;
+            this->stats.hits++;
+            return true;
+        }
+    }
+    this->stats.misses++;
+
+    // stitch the pages in a run of consecutive slots
+    slot = FindSlotsRun(count);
+    auto readFrom = INVALID_OFFSET;
+    for (auto idx = 0U; idx <= count; idx++)
+    {
+        if (idx < count)
+        {
+            auto& p = this->pages[slot + idx];
+            if (p.index == firstPage + idx)
+            {
+                p.lastAccess = stamp;
+            }
+            else
+            {
+                // evict current page
+                if (p.index != INVALID_OFFSET)
+                    this->pageToSlot.erase(p.index);
+                p.index      = INVALID_OFFSET;
+                p.lastAccess = stamp;
+
+                // page is already loaded in a different slot --> move it
+                it = this->pageToSlot.find(firstPage + idx);
+                if (it != this->pageToSlot.end())
+                {
+                    memcpy(this->cache + (uint64) (slot + idx) * PAGE_SIZE, this->cache + (uint64) it->second * PAGE_SIZE, PAGE_SIZE);
+                    // the old slot is released, but it keeps its LRU stamp (a view returned earlier might still use it)
+                    this->pages[it->second].index = INVALID_OFFSET;
+                    it->second                    = slot + idx;
+                    p.index                       = firstPage + idx;
+                    this->stats.pagesRelocated++;
+                }
+                else if (readFrom == INVALID_OFFSET)
+                {
+                    readFrom = idx;
+                }
+            }
+        }
+        // read consecutive missing pages with one call
+        if ((readFrom != INVALID_OFFSET) && ((idx == count) || (this->pages[slot + idx].index != INVALID_OFFSET)))
+        {
+            const auto offset = (firstPage + readFrom) * PAGE_SIZE;
+            const auto size   = (uint32) (std::min<>((firstPage + idx) * PAGE_SIZE, this->fileSize) - offset);
+            if (ReadFromFile(offset, this->cache + (slot + readFrom) * PAGE_SIZE, size) == false)
+            {
+                this->start  = 0;
+                this->end    = 0;
+                this->window = this->cache;
+                return false;
+            }
+            for (auto i = (uint32) readFrom; i < idx; i++)
+            {
+                this->pages[slot + i].index     = firstPage + i;
+                this->pageToSlot[firstPage + i] = slot + i;
+            }
+            this->stats.pagesRead += idx - readFrom;
+            readFrom = INVALID_OFFSET;
+        }
+    }
+    return true;
+}
+bool DataCache::MapFile(const std::filesystem::path& path)
+{
+    CHECK(this->fileObj, false, "Cache object was not initialized !");
+    CHECK(this->mappedData == nullptr, false, "File is already mapped !");
+    CHECK(this->fileSize > 0, false, "Empty files can not be mapped !");
+    CHECK(this->fileSize <= (uint64) SIZE_MAX, false, "File is too large to be mapped in the current address space !");
+
+    std::error_code err;
+    CHECK(std::filesystem::is_regular_file(path, err), false, "Only regular files can be mapped !");
+
+#if defined(BUILD_FOR_WINDOWS)
+    auto hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    CHECK(hFile != INVALID_HANDLE_VALUE, false, "Fail to open file for mapping (error: %u)", GetLastError());
+    LARGE_INTEGER sz;
+    if ((GetFileSizeEx(hFile, &sz) == FALSE) || ((uint64) sz.QuadPart != this->fileSize))
+    {
+        CloseHandle(hFile);
+        RETURNERROR(false, "File size differs from the size of the cached object !");
+    }
+    auto hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(hFile);
+    CHECK(hMapping, false, "Fail to create file mapping (error: %u)", GetLastError());
+    auto view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    // the view keeps a reference to the mapping object
+    CloseHandle(hMapping);
+    CHECK(view, false, "Fail to map view of file (error: %u)", GetLastError());
+#else
+    auto fd = open(path.c_str(), O_RDONLY);
+    CHECK(fd >= 0, false, "Fail to open file for mapping (errno: %d)", errno);
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (!S_ISREG(st.st_mode)) || ((uint64) st.st_size != this->fileSize))
+    {
+        close(fd);
+        RETURNERROR(false, "File size differs from the size of the cached object !");
+    }
+    auto view = mmap(nullptr, (size_t) this->fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping remains valid after the descriptor is closed
+    close(fd);
+    CHECK(view != MAP_FAILED, false, "Fail to map file (errno: %d)", errno);
+#endif
+
+    this->mappedData = reinterpret_cast<const uint8*>(view);
+    // the window buffer is no longer needed (the cache size is kept as it is used by callers as a chunk size)
+    if (this->cache)
+        delete[] this->cache;
+    this->cache  = nullptr;
+    this->window = nullptr;
+    this->start  = 0;
+    this->end    = 0;
+    this->pages.clear();
+    this->pageToSlot.clear();
+    return true;
+}
+void DataCache::UnmapFile()
+{
+    if (this->mappedData == nullptr)
+        return;
+#if defined(BUILD_FOR_WINDOWS)
+    UnmapViewOfFile(this->mappedData);
+#else
+    munmap(const_cast<uint8*>(this->mappedData), (size_t) this->fileSize);
+#endif
+    this->mappedData = nullptr;
+}
 BufferView DataCache::Get(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead)
 {
     CHECK(this->fileObj, BufferView(), "File was not properly initialized !");
     CHECK(requestedSize > 0, BufferView(), "'requestedSize' has to be bigger than 0 ");
 
-    if (offset >= this->start)
+    if (this->mappedData)
+    {
+        // the entire file is available --> no need to read anything
+        if (offset >= this->fileSize)
+            return BufferView();
+        if ((offset + requestedSize) > this->fileSize)
+        {
+            if (failIfRequestedSizeCanNotBeRead)
+                return BufferView();
+            requestedSize = (uint32) (this->fileSize - offset);
+        }
+        this->currentPos = offset + requestedSize;
+        return BufferView(this->mappedData + offset, requestedSize);
+    }
+
+    if ((offset >= this->start) && (offset < this->end))
     {
         // data is cached --> return from here
         if ((offset + requestedSize) <= this->end)
         {
             this->currentPos = offset + requestedSize;
-            return BufferView(&this->cache[offset - this->start], requestedSize);
+            this->stats.hits++;
+            return BufferView(&this->window[offset - this->start], requestedSize);
         }
         if (this->end == this->fileSize)
         {
@@ -82,64 +334,41 @@ BufferView DataCache::Get(uint64 offset, uint32 requestedSize, bool failIfReques
             if (failIfRequestedSizeCanNotBeRead)
                 return BufferView();
             this->currentPos = this->fileSize;
-            return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
+            this->stats.hits++;
+            return BufferView(&this->window[offset - this->start], (uint32) (this->end - offset));
         }
     }
     // request outside file
     if (offset >= this->fileSize)
         return BufferView();
-    // data is not available in cache ==> read it
-    uint64 _start, _end;
-    if (this->fileSize <= this->cacheSize)
+    // compute the pages that need to be loaded
+    auto last = offset + requestedSize;
+    if (last > this->fileSize)
     {
-        // read everything
-        _start = 0;
-        _end   = this->fileSize;
+        if (failIfRequestedSizeCanNotBeRead)
+            return BufferView();
+        last = this->fileSize;
     }
-    else
+    const auto firstPage = offset / PAGE_SIZE;
+    auto pagesCount      = (last - 1) / PAGE_SIZE - firstPage + 1;
+    if (pagesCount > this->pages.size())
     {
-        // compute the new buffer to read
-        auto sz = requestedSize;
-        if ((offset + sz) > this->fileSize)
-            sz = (uint32) (this->fileSize - offset);
-        if (sz > this->cacheSize)
-            sz = this->cacheSize;
-        auto diff = this->cacheSize - sz;
-        if (diff <= offset)
-            _start = offset - diff;
-        else
-            _start = 0;
-        _end = _start + this->cacheSize;
-        if (_end > this->fileSize)
-            _end = this->fileSize;
+        // the entire data does not fit in our cache
+        if (failIfRequestedSizeCanNotBeRead)
+            return BufferView();
+        pagesCount = this->pages.size();
+        last       = (firstPage + pagesCount) * PAGE_SIZE;
     }
-    // read new data in cache
-    if (this->fileObj->SetCurrentPos(_start) == false)
-        return BufferView();
-    if (this->fileObj->Read(this->cache, (uint32) (_end - _start)) == false)
-    {
-        this->start = 0;
-        this->end   = 0;
+    uint32 slot;
+    if (LoadPages(firstPage, (uint32) pagesCount, slot) == false)
         return BufferView();
-    }
+
     // return new pointer
-    this->start = _start;
-    this->end   = _end;
-    if ((offset + requestedSize) <= this->end)
-    {
-        this->currentPos = offset + requestedSize;
-        return BufferView(&this->cache[offset - this->start], requestedSize);
-    }
-    // the entire data is not in our cache
-    if (failIfRequestedSizeCanNotBeRead)
-        return BufferView();
-    if (this->end == this->fileSize)
-    {
-        this->currentPos = this->fileSize;
-        return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
-    }
-    this->currentPos = this->end;
-    return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
+    this->window     = this->cache + (uint64) slot * PAGE_SIZE;
+    this->start      = firstPage * PAGE_SIZE;
+    this->end        = std::min<>((firstPage + pagesCount) * PAGE_SIZE, this->fileSize);
+    this->currentPos = last;
+    return BufferView(this->window + (offset - this->start), (uint32) (last - offset));
 }
 bool DataCache::CopyObject(void* buffer, uint64 offset, uint32 requestedSize)
 {
@@ -160,6 +389,16 @@ Buffer DataCache::CopyToBuffer(uint64 offset, uint32 requestedSize, bool failIfR
     }
 
     Buffer b{};
+    if (this->mappedData)
+    {
+        // single copy straight from the mapping
+        auto bv = this->Get(offset, requestedSize, failIfRequestedSizeCanNotBeRead);
+        if (bv.Empty())
+            return Buffer();
+        b.Resize(bv.GetLength());
+        memcpy(b.GetData(), bv.GetData(), bv.GetLength());
+        return b;
+    }
     b.Resize(requestedSize);
     uint32 toRead = this->cacheSize >> 1;
     auto p        = b.GetData();
@@ -206,15 +445,13 @@ bool DataCache::WriteTo(Reference<AppCUI::OS::DataObject> output, uint64 offset,
     if (size == 0)
         return true; // nothing to write
 
-    uint32 toRead = this->cacheSize >> 1;
-    while (size)
+    CHECK(offset + size <= this->fileSize, false, "Unable to read %u bytes from %llu", size, offset);
+
+    auto chunks = Chunks(offset, size);
+    for (auto bv : chunks)
     {
-        toRead  = std::min(toRead, size);
-        auto bv = this->Get(offset, toRead, true);
-        CHECK(bv.IsValid(), false, "");
-        CHECK(output->Write(bv.begin(), toRead), false, "");
-        offset += toRead;
-        size -= toRead;
+        CHECK(output->Write(bv.begin(), (uint32) bv.GetLength()), false, "");
     }
+    CHECK(chunks.HasFailed() == false, false, "");
     return true;
 }
@@ -0,0 +1,175 @@
+#include "GView.hpp"
+
+#include <condition_variable>
+#include <thread>
+
+using namespace GView::Utils;
+
+struct InternalSequentialReader
+{
+    struct Chunk
+    {
+        std::unique_ptr<uint8[]> buffer;
+        uint64 offset;
+        uint32 size;
+        bool ready; // filled by the worker and not yet released by the consumer
+        bool error;
+    };
+
+    DataCache* cache;
+    const uint8* mapped;
+    uint64 start, end;
+    uint64 position;    // offset of the next chunk handed to the consumer
+    uint64 chunkOffset; // offset of the chunk returned by the last Next()
+    uint32 chunkSize;
+    bool failed;
+
+    // used when the file is not memory mapped
+    Chunk chunks[2];
+    uint32 nextChunk;
+    bool holdsChunk;
+    bool stop;
+    std::mutex lock;
+    std::condition_variable notifier;
+    std::thread worker;
+};
+
+DataCache::SequentialReader::SequentialReader(DataCache& cache, uint64 offset, uint64 size, uint32 chunkSize)
+{
+    auto r         = new InternalSequentialReader();
+    this->data     = r;
+    r->cache       = &cache;
+    r->mapped      = cache.mappedData;
+    r->start       = std::min<>(offset, cache.GetSize());
+    r->end         = r->start + std::min<>(size, cache.GetSize() - r->start);
+    r->position    = r->start;
+    r->chunkOffset = r->start;
+    r->chunkSize   = chunkSize > 0 ? chunkSize : std::max<>(cache.GetCacheSize() >> 1, DataCache::PAGE_SIZE);
+    r->failed      = false;
+    r->nextChunk   = 0;
+    r->holdsChunk  = false;
+    r->stop        = false;
+
+    if ((r->mapped) || (r->start == r->end))
+        return; // nothing to prepare
+    if (cache.fileObj == nullptr)
+    {
+        r->failed = true;
+        return;
+    }
+
+    // a range that fits in one chunk is read synchronously (no need for a worker)
+    const auto singleChunk = (r->end - r->start) <= r->chunkSize;
+    for (auto idx = 0U; idx < (singleChunk ? 1U : 2U); idx++)
+    {
+        r->chunks[idx].buffer.reset(new uint8[(size_t) std::min<>((uint64) r->chunkSize, r->end - r->start)]);
+        r->chunks[idx].ready = false;
+        r->chunks[idx].error = false;
+    }
+    if (singleChunk)
+        return;
+
+    r->worker = std::thread(
+          [r]()
+          {
+              auto pos = r->start;
+              auto idx = 0U;
+              while (pos < r->end)
+              {
+                  auto& c = r->chunks[idx];
+                  {
+                      std::unique_lock<std::mutex> lock(r->lock);
+                      r->notifier.wait(lock, [r, &c]() { return r->stop || !c.ready; });
+                      if (r->stop)
+                          return;
+                  }
+                  const auto sz = (uint32) std::min<>((uint64) r->chunkSize, r->end - pos);
+                  const auto ok = r->cache->ReadFromFile(pos, c.buffer.get(), sz);
+                  {
+                      std::lock_guard<std::mutex> lock(r->lock);
+                      c.offset = pos;
+                      c.size   = sz;
+                      c.error  = !ok;
+                      c.ready  = true;
+                  }
+                  r->notifier.notify_all();
+                  if (!ok)
+                      return;
+                  pos += sz;
+                  idx = (idx + 1) % 2;
+              }
+          });
+}
+DataCache::SequentialReader::~SequentialReader()
+{
+    auto r = reinterpret_cast<InternalSequentialReader*>(this->data);
+    if (r == nullptr)
+        return;
+    if (r->worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(r->lock);
+            r->stop = true;
+        }
+        r->notifier.notify_all();
+        r->worker.join();
+    }
+    delete r;
+    this->data = nullptr;
+}
+BufferView DataCache::SequentialReader::Next()
+{
+    auto r = reinterpret_cast<InternalSequentialReader*>(this->data);
+    if ((r->failed) || (r->position >= r->end))
+        return BufferView();
+
+    const auto sz = (uint32) std::min<>((uint64) r->chunkSize, r->end - r->position);
+    if (r->mapped)
+    {
+        // the OS read-ahead handles sequential access over a mapping
+        r->chunkOffset = r->position;
+        r->position += sz;
+        return BufferView(r->mapped + r->chunkOffset, sz);
+    }
+    if (r->worker.joinable() == false)
+    {
+        // the entire range fits in one chunk
+        if (r->cache->ReadFromFile(r->position, r->chunks[0].buffer.get(), sz) == false)
+        {
+            r->failed = true;
+            return BufferView();
+        }
+        r->chunkOffset = r->position;
+        r->position += sz;
+        return BufferView(r->chunks[0].buffer.get(), sz);
+    }
+
+    std::unique_lock<std::mutex> lock(r->lock);
+    if (r->holdsChunk)
+    {
+        // release the chunk returned by the previous call (the worker can now fill it)
+        r->chunks[r->nextChunk].ready = false;
+        r->nextChunk                  = (r->nextChunk + 1) % 2;
+        r->holdsChunk                 = false;
+        r->notifier.notify_all();
+    }
+    auto& c = r->chunks[r->nextChunk];
+    r->notifier.wait(lock, [&c]() { return c.ready; });
+    if (c.error)
+    {
+        r->failed = true;
+        return BufferView();
+    }
+    r->holdsChunk  = true;
+    r->chunkOffset = c.offset;
+    r->position    = c.offset + c.size;
+    return BufferView(c.buffer.get(), c.size);
+}
+uint64 DataCache::SequentialReader::GetChunkOffset() const
+{
+    return reinterpret_cast<InternalSequentialReader*>(this->data)->chunkOffset;
+}
+bool DataCache::SequentialReader::HasFailed() const
+{
+    return reinterpret_cast<InternalSequentialReader*>(this->data)->failed;
+}
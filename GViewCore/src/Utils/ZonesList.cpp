@@ -3,16 +3,153 @@
 using namespace GView::Utils;
 using namespace AppCUI::Graphics;
 
+/*
+    The zones are indexed with an implicit interval tree: the zones are sorted by their start and the middle of
+    every range [lo, hi) is the root of that sub-tree (it stores the maximum end of the sub-tree). It is rebuilt
+    (only when zones were added) on the next SetCache and finds the k zones from the view in O(log n + k).
+
+    The zones from the view are flattened into disjoint segments (each one with the zone that is shown there)
+    => OffsetToZone is a lookup that starts from the last segment found (O(1) for consecutive offsets).
+    When zones overlap, the one that starts last is shown (and from those with the same start, the smallest).
+*/
+struct ZoneSegment {
+    uint64 start, end;
+    uint32 zone;
+};
+
 struct ZonesListContext {
     std::vector<Zone> zones{};
-    std::vector<Zone> cache{};
+
+    std::vector<uint32> sorted{}; // indexes in 'zones' sorted by start (the implicit tree)
+    std::vector<uint64> maxEnd{}; // maximum end of the sub-tree rooted in every position of 'sorted'
+    bool dirty{ false };
+
+    std::vector<ZoneSegment> segments{};
+    size_t lastSegment{ 0 };
 };
 
+static inline bool ZoneHasPriority(const Zone& a, const Zone& b)
+{
+    if (a.interval.low == b.interval.low) {
+        return a.interval.high < b.interval.high;
+    }
+    return a.interval.low > b.interval.low;
+}
+
+static uint64 BuildTree(ZonesListContext* ctx, size_t lo, size_t hi)
+{
+    if (lo >= hi) {
+        return 0;
+    }
+    const auto mid   = lo + (hi - lo) / 2;
+    auto result      = ctx->zones[ctx->sorted[mid]].interval.high;
+    result           = std::max<>(result, BuildTree(ctx, lo, mid));
+    result           = std::max<>(result, BuildTree(ctx, mid + 1, hi));
+    ctx->maxEnd[mid] = result;
+    return result;
+}
+
+static void BuildIndex(ZonesListContext* ctx)
+{
+    ctx->sorted.clear();
+    ctx->sorted.reserve(ctx->zones.size());
+    for (uint32 idx = 0; idx < ctx->zones.size(); idx++) {
+        const auto& zone = ctx->zones[idx];
+        if (zone.interval.low <= zone.interval.high) {
+            ctx->sorted.push_back(idx);
+        }
+    }
+    std::sort(ctx->sorted.begin(), ctx->sorted.end(), [ctx](uint32 a, uint32 b) {
+        const auto& za = ctx->zones[a].interval;
+        const auto& zb = ctx->zones[b].interval;
+        if (za.low == zb.low) {
+            return za.high > zb.high;
+        }
+        return za.low < zb.low;
+    });
+    ctx->maxEnd.resize(ctx->sorted.size());
+    BuildTree(ctx, 0, ctx->sorted.size());
+    ctx->dirty = false;
+}
+
+static void QueryTree(const ZonesListContext* ctx, size_t lo, size_t hi, const Zone::Interval& interval, std::vector<uint32>& output)
+{
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        if (ctx->maxEnd[mid] < interval.low) {
+            return; // every zone from this sub-tree ends before the interval
+        }
+        QueryTree(ctx, lo, mid, interval, output);
+        const auto& zone = ctx->zones[ctx->sorted[mid]];
+        if (zone.interval.low > interval.high) {
+            return; // the zones from the right sub-tree start after the interval
+        }
+        if (zone.interval.high >= interval.low) {
+            output.push_back(ctx->sorted[mid]);
+        }
+        lo = mid + 1;
+    }
+}
+
+static void BuildSegments(ZonesListContext* ctx, const std::vector<uint32>& visible)
+{
+    // sweep over the zones (sorted by start) => the shown zone is the one with the highest priority that did not end
+    ctx->segments.clear();
+    ctx->lastSegment = 0;
+
+    const auto lowerPriority = [ctx](uint32 a, uint32 b) { return ZoneHasPriority(ctx->zones[b], ctx->zones[a]); };
+    std::vector<uint32> active;
+    uint64 position = 0;
+    size_t next     = 0;
+
+    while (next < visible.size() || !active.empty()) {
+        if (active.empty()) {
+            position = ctx->zones[visible[next]].interval.low;
+        }
+        while (next < visible.size() && ctx->zones[visible[next]].interval.low <= position) {
+            active.push_back(visible[next++]);
+            std::push_heap(active.begin(), active.end(), lowerPriority);
+        }
+        while (!active.empty() && ctx->zones[active.front()].interval.high < position) {
+            std::pop_heap(active.begin(), active.end(), lowerPriority);
+            active.pop_back();
+        }
+        if (active.empty()) {
+            continue;
+        }
+
+        auto end = ctx->zones[active.front()].interval.high;
+        if (next < visible.size()) {
+            end = std::min<>(end, ctx->zones[visible[next]].interval.low - 1);
+        }
+        ctx->segments.push_back({ position, end, active.front() });
+        if (end == GView::Utils::INVALID_OFFSET) {
+            break;
+        }
+        position = end + 1;
+    }
+}
+
 ZonesList::ZonesList()
 {
     context = new ZonesListContext;
 }
 
+ZonesList::ZonesList(const ZonesList& other)
+{
+    context = new ZonesListContext;
+    *this   = other;
+}
+
+ZonesList& ZonesList::operator=(const ZonesList& other)
+{
+    if (this != &other && context != nullptr && other.context != nullptr) {
+        auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
+        *ctx     = *reinterpret_cast<const ZonesListContext*>(other.context);
+    }
+    return *this;
+}
+
 ZonesList::~ZonesList()
 {
     if (context != nullptr) {
@@ -25,6 +162,7 @@ bool ZonesList::Add(uint64 s, uint64 e, ColorPair c, std::string_view txt)
     CHECK(context != nullptr, false, "");
     auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
     ctx->zones.emplace_back(s, e, c, txt);
+    ctx->dirty = true;
     return true;
 }
 
@@ -33,21 +171,45 @@ bool ZonesList::Add(const Zone& zone)
     CHECK(context != nullptr, false, "");
     auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
     ctx->zones.emplace_back(zone);
+    ctx->dirty = true;
     return true;
 }
 
 std::optional<Zone> ZonesList::OffsetToZone(uint64 position) const
 {
     CHECK(context != nullptr, std::nullopt, "");
-    auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
+    auto ctx             = reinterpret_cast<ZonesListContext*>(this->context);
+    const auto& segments = ctx->segments;
+    if (segments.empty()) {
+        return std::nullopt;
+    }
 
-    for (const auto& zone : ctx->cache) {
-        if (zone.interval.low <= position && position <= zone.interval.high) {
-            return zone;
+    // the view is painted with increasing offsets => try the last segment and the next one first
+    auto idx = ctx->lastSegment;
+    if (segments[idx].start <= position) {
+        if (position <= segments[idx].end) {
+            return ctx->zones[segments[idx].zone];
+        }
+        if (idx + 1 == segments.size() || position < segments[idx + 1].start) {
+            return std::nullopt;
+        }
+        if (position <= segments[idx + 1].end) {
+            ctx->lastSegment = idx + 1;
+            return ctx->zones[segments[idx + 1].zone];
         }
     }
 
-    return std::nullopt;
+    const auto it = std::upper_bound(
+          segments.begin(), segments.end(), position, [](uint64 value, const ZoneSegment& segment) { return value < segment.start; });
+    if (it == segments.begin()) {
+        return std::nullopt;
+    }
+    idx              = static_cast<size_t>(it - segments.begin()) - 1;
+    ctx->lastSegment = idx;
+    if (position > segments[idx].end) {
+        return std::nullopt;
+    }
+    return ctx->zones[segments[idx].zone];
 }
 
 bool ZonesList::SetCache(const Zone::Interval& interval)
@@ -55,21 +217,13 @@ bool ZonesList::SetCache(const Zone::Interval& interval)
     CHECK(context != nullptr, false, "");
     auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
 
-    ctx->cache.clear();
-
-    for (const auto& zone : ctx->zones) {
-        if ((zone.interval.low >= interval.low && zone.interval.low <= interval.high) ||
-            interval.low >= zone.interval.low && interval.low <= zone.interval.high) {
-            ctx->cache.push_back(zone);
-        }
+    if (ctx->dirty) {
+        BuildIndex(ctx);
     }
 
-    std::sort(ctx->cache.begin(), ctx->cache.end(), [](const Zone& a, const Zone& b) {
-        if (a.interval.low == b.interval.low) {
-            return a.interval.high < b.interval.high;
-        }
-        return a.interval.low > b.interval.low;
-    });
+    std::vector<uint32> visible;
+    QueryTree(ctx, 0, ctx->sorted.size(), interval, visible);
+    BuildSegments(ctx, visible);
 
     return true;
 }
@@ -80,7 +234,22 @@ void ZonesList::Clear()
     auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
 
     ctx->zones.clear();
-    ctx->cache.clear();
+    ctx->sorted.clear();
+    ctx->maxEnd.clear();
+    ctx->segments.clear();
+    ctx->lastSegment = 0;
+    ctx->dirty       = false;
+}
+
+void ZonesList::GetCachedZones(std::vector<Zone>& output) const
+{
+    output.clear();
+    CHECKRET(context != nullptr, "");
+    auto ctx = reinterpret_cast<ZonesListContext*>(this->context);
+    for (const auto& segment : ctx->segments) {
+        auto& zone    = output.emplace_back(ctx->zones[segment.zone]);
+        zone.interval = { segment.start, segment.end };
+    }
 }
 
 uint32 ZonesList::GetCount() const
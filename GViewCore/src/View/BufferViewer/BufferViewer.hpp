@@ -2,6 +2,10 @@
 
 #include "Internal.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace GView::View::BufferViewer
 {
 using namespace AppCUI;
@@ -67,6 +71,113 @@ struct Config {
     void Initialize();
 };
 
+// Searches for a pattern inside a buffer (usually a chunk obtained from DataCache::Chunks).
+// Byte patterns (with wildcards) and plain text are compared directly (using SIMD to filter the
+// positions where the first and the last fixed bytes of the pattern match). RE2 is used only for
+// regular expressions.
+class SearchEngine
+{
+    enum class Type : uint8 { None, Bytes, Regex, UnicodeRegex };
+
+    Type type{ Type::None };
+
+    // pattern bytes: a byte 'c' matches position 'i' if (c & mask[i]) is value[i] or alternative[i]
+    // (alternative is used for case folding, a wildcard has the mask, the value and the alternative set to 0)
+    std::vector<uint8> value;
+    std::vector<uint8> alternative;
+    std::vector<uint8> mask;
+    uint32 firstFixed{ 0 };
+    uint32 lastFixed{ 0 };
+    bool hasFixedBytes{ false };
+
+    std::unique_ptr<GView::Regex::Matcher> regex;
+    std::string utf8;            // UTF-16 chunk converted to UTF-8 (for Unicode regular expressions)
+    std::vector<uint32> offsets; // offset in the UTF-16 chunk for every byte from utf8
+
+    bool MatchAt(const uint8* p) const;
+    bool FindBytes(const uint8* p, uint64 size, bool last, uint64& position) const;
+    bool FindRegex(BufferView buffer, bool last, uint64& start, uint64& length);
+    void FindAllRegex(BufferView buffer, std::vector<std::pair<uint64, uint64>>& matches);
+    BufferView ConvertToUTF8(BufferView buffer);
+
+  public:
+    bool InitBytes(const std::vector<int16>& pattern); // -1 means any byte
+    bool InitText(std::u16string_view text, bool unicode, bool ignoreCase);
+    bool InitRegex(std::string_view expression, bool unicode, bool ignoreCase);
+    std::string_view GetRegexError() const; // why InitRegex failed
+
+    // how much two consecutive chunks must overlap so that no match is lost at chunk boundaries
+    uint32 GetOverlap() const;
+
+    // first (or last) match from buffer; start is relative to the beginning of the buffer
+    bool Find(BufferView buffer, bool last, uint64& start, uint64& length);
+
+    // appends every match (non overlapping) that starts at or after 'from' (offsets relative to the buffer)
+    void FindAll(BufferView buffer, uint64 from, std::vector<std::pair<uint64, uint64>>& matches);
+};
+
+// "Find all": the search runs on a worker thread and the matches are appended (sorted by offset) as they are found
+class FindAllTask
+{
+    SearchEngine engine;
+    std::thread worker;
+    mutable std::mutex lock;
+    std::vector<std::pair<uint64, uint64>> results; // start, length
+    std::atomic<uint64> processed{ 0 };
+    std::atomic<bool> stop{ false };
+    uint64 size{ 0 }; // bytes from all the ranges
+    bool running{ false };
+    bool truncated{ false };
+    bool canceled{ false };
+    uint32 id{ 0 };
+
+    void Run(GView::Utils::DataCache& cache, const std::vector<std::pair<uint64, uint64>>& ranges);
+    bool AddMatch(uint64 start, uint64 length);
+
+  public:
+    static constexpr size_t MAX_RESULTS = 0x40000;
+
+    FindAllTask() = default;
+    FindAllTask(const FindAllTask&)            = delete;
+    FindAllTask& operator=(const FindAllTask&) = delete;
+    ~FindAllTask();
+
+    // the engine must be initialized before Start
+    inline SearchEngine& GetEngine()
+    {
+        return engine;
+    }
+    // ranges (start, size) must be sorted and must not overlap
+    bool Start(GView::Utils::DataCache& cache, std::vector<std::pair<uint64, uint64>> ranges);
+    void Cancel();
+    void Clear();
+
+    // changes every time a new search is started (or the results are cleared)
+    inline uint32 GetID() const
+    {
+        return id;
+    }
+    inline uint64 GetProcessed() const
+    {
+        return processed.load(std::memory_order_relaxed);
+    }
+    // percent of the bytes searched until now
+    inline uint32 GetProgress() const
+    {
+        return size == 0 ? 100U : static_cast<uint32>(std::min<>(GetProcessed(), size) * 100 / size);
+    }
+    bool IsRunning() const;
+    bool IsCanceled() const;
+    bool IsTruncated() const;
+    size_t GetResultsCount() const;
+    // copies the results found after the first 'from' ones
+    void CopyResults(size_t from, std::vector<std::pair<uint64, uint64>>& output) const;
+
+    // first match that starts at or after 'offset' / last match that starts at or before 'offset'
+    std::pair<uint64, uint64> GetNext(uint64 offset) const;
+    std::pair<uint64, uint64> GetPrevious(uint64 offset) const;
+};
+
 class FindDialog : public Window, public Handlers::OnCheckInterface
 {
   private:
@@ -97,8 +208,15 @@ class FindDialog : public Window, public Handlers::OnCheckInterface
     uint64 length{ 0 };
 
     UnicodeStringBuilder usb;
+    SearchEngine engine;
+    FindAllTask findAll;
+    bool findAllMode{ false }; // next/previous match are taken from the "Find all" results
     std::pair<uint64, uint64> match;
     bool newRequest{ true };
+    bool ParseBinaryPattern(std::vector<int16>& pattern);
+    bool PrepareEngine(SearchEngine& target);
+    // starts the search on a worker thread and returns (the matches are taken from GetFindAllResults as they are found)
+    bool FindAll();
     bool ProcessInput(uint64 end = GView::Utils::INVALID_OFFSET, bool last = false);
 
   public:
@@ -125,8 +243,24 @@ class FindDialog : public Window, public Handlers::OnCheckInterface
         CHECK(alingTextToUpperLeftCorner.IsValid(), false, "");
         return alingTextToUpperLeftCorner->IsChecked();
     }
+    // matches from the last "Find all" (empty if a single match search was issued after it)
+    const FindAllTask& GetFindAllResults() const
+    {
+        return findAll;
+    }
+    bool IsFindAllMode() const
+    {
+        return findAllMode;
+    }
+    // the matches found until now are kept
+    void StopFindAll()
+    {
+        findAll.Cancel();
+    }
     bool HasResults() const
     {
+        if (findAllMode)
+            return findAll.GetResultsCount() > 0;
         const auto& [start, length] = match;
         CHECK(start != GView::Utils::INVALID_OFFSET && length > 0, false, "");
         return true;
@@ -145,6 +279,7 @@ namespace Commands
     constexpr int BUFFERVIEW_CMD_FINDNEXT          = 0xBF07;
     constexpr int BUFFERVIEW_CMD_FINDPREVIOUS      = 0xBF08;
     constexpr int BUFFERVIEW_CMD_DISSASM_DIALOG    = 0xBF09;
+    constexpr int BUFFERVIEW_CMD_STOP_FIND_ALL     = 0xBF0A;
     /*
     constexpr int32 VIEW_COMMAND_ACTIVATE_COMPARE{ 0xBF10 };
     constexpr int32 VIEW_COMMAND_DEACTIVATE_COMPARE{ 0xBF11 };
@@ -282,16 +417,36 @@ class Instance : public View::ViewControl, public GView::Utils::SelectionZoneInt
     CharacterBuffer chars;
     uint32 currentAdrressMode{ 0 };
     String addressModesList;
-    BufferColor bufColor;
     bool showColorNotFocused{ true };
 
     static Config config;
 
     FindDialog findDialog;
+    struct {
+        GView::Utils::ZonesList zones; // matches from the last "Find all" (highlighted)
+        size_t count{ 0 };
+        uint32 id{ 0 };
+        uint64 processed{ 0 }; // progress shown by the last repaint
+        bool running{ false };
+    } findResults;
+
+    // Colors (and characters) of the bytes from the view, computed once for every paint: every provider (zones, strings,
+    // the type plugin, the buffer color callback, "Find all" results, the highlighted selection) colors the entire view
+    // with a list of runs and the runs are applied in the order of their priority.
+    struct {
+        uint64 start{ 0 };
+        uint32 size{ 0 };
+        std::vector<uint8> bytes;        // the view + a few bytes after it (the providers do not read the cache)
+        std::vector<ColorPair> colors;   // one for every byte from the view
+        std::vector<uint16> characters;  // the character shown for every byte from the view (SPACE_CHARACTER for none)
+        std::vector<BufferColor> runs;   // runs from the current provider
+        std::vector<GView::Utils::Zone> zones;
+    } colorMap;
 
     int PrintSelectionInfo(uint32 selectionID, int x, int y, uint32 width, Renderer& r);
     int PrintCursorPosInfo(int x, int y, uint32 width, bool addSeparator, Renderer& r);
     int PrintCursorZone(int x, int y, uint32 width, Renderer& r);
+    int PrintFindAllInfo(int x, int y, uint32 width, Renderer& r);
     int Print8bitValue(int x, int height, AppCUI::Utils::BufferView buffer, Renderer& r);
     int Print16bitValue(int x, int height, AppCUI::Utils::BufferView buffer, Renderer& r);
     int Print32bitValue(int x, int height, AppCUI::Utils::BufferView buffer, Renderer& r);
@@ -319,7 +474,11 @@ class Instance : public View::ViewControl, public GView::Utils::SelectionZoneInt
     bool SetStringAsciiMask(string_view stringRepresentation);
 
     ColorPair OffsetToColorZone(uint64 offset);
-    ColorPair OffsetToColor(uint64 offset);
+    void ComputeColorMap();
+    void ApplyColorRuns(const std::vector<BufferColor>& runs);
+    void ApplyColorZones(const std::vector<GView::Utils::Zone>& zones);
+    void ComputeStringsColors();
+    void UpdateFindResultsZones();
 
     void AnalyzeMousePosition(int x, int y, MousePositionInfo& mpInfo);
 
@@ -364,6 +523,7 @@ class Instance : public View::ViewControl, public GView::Utils::SelectionZoneInt
 
     // scrollbar data
     virtual void OnUpdateScrollBars() override;
+    virtual bool OnFrameUpdate() override;
 
     // property interface
     bool GetPropertyValue(uint32 id, PropertyValue& value) override;
@@ -0,0 +1,172 @@
+#include "BufferViewer.hpp"
+
+namespace GView::View::BufferViewer
+{
+FindAllTask::~FindAllTask()
+{
+    Cancel();
+}
+bool FindAllTask::Start(GView::Utils::DataCache& cache, std::vector<std::pair<uint64, uint64>> ranges)
+{
+    Cancel();
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->results.clear();
+        this->truncated = false;
+        this->canceled  = false;
+        this->running   = true;
+        this->id++;
+    }
+    this->size = 0;
+    for (const auto& range : ranges)
+        this->size += range.second;
+    this->processed = 0;
+    this->stop      = false;
+    this->worker    = std::thread([this, &cache, ranges = std::move(ranges)]() { Run(cache, ranges); });
+    return true;
+}
+bool FindAllTask::AddMatch(uint64 start, uint64 length)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (this->results.size() >= MAX_RESULTS)
+    {
+        this->truncated = true;
+        this->stop      = true;
+        return false;
+    }
+    this->results.emplace_back(start, length);
+    return true;
+}
+void FindAllTask::Run(GView::Utils::DataCache& cache, const std::vector<std::pair<uint64, uint64>>& ranges)
+{
+    // The range is read with a SequentialReader (the DataCache itself is not thread safe).
+    // Consecutive chunks do not overlap => the last 'overlap' bytes of a chunk are kept in 'seam' and
+    // the matches that start there are searched in 'seam' + the beginning of the next chunk.
+    const auto overlap = static_cast<uint64>(this->engine.GetOverlap());
+    std::vector<std::pair<uint64, uint64>> found;
+    std::vector<uint8> seam;
+
+    const auto Report = [&](uint64 base, uint64 limit, uint64& nextAllowed)
+    {
+        // only the matches that start before 'limit' are reported (the rest are handled with the next chunk)
+        for (const auto& [start, length] : found)
+        {
+            if (start >= limit)
+                break;
+            CHECK(AddMatch(base + start, length), false, "");
+            nextAllowed = base + start + length;
+        }
+        return true;
+    };
+
+    for (const auto& [rangeStart, rangeSize] : ranges)
+    {
+        GView::Utils::DataCache::SequentialReader reader(cache, rangeStart, rangeSize);
+        auto nextAllowed = rangeStart; // reported matches do not overlap
+        auto seamOffset  = rangeStart;
+        seam.clear();
+
+        for (auto chunk = reader.Next(); !chunk.Empty(); chunk = reader.Next())
+        {
+            CHECKBK(this->stop == false, "");
+            const auto chunkOffset = reader.GetChunkOffset();
+
+            if (!seam.empty())
+            {
+                const auto carry = seam.size();
+                const auto head  = std::min<>(chunk.GetLength(), overlap);
+                seam.insert(seam.end(), chunk.GetData(), chunk.GetData() + head);
+                found.clear();
+                this->engine.FindAll(BufferView(seam.data(), seam.size()), nextAllowed > seamOffset ? nextAllowed - seamOffset : 0, found);
+                CHECKBK(Report(seamOffset, carry, nextAllowed), "");
+            }
+
+            // the tail is kept for the next chunk (and stays aligned to 2 bytes relative to the range, for UTF-16)
+            auto tail = std::min<>(chunk.GetLength(), overlap);
+            tail += (chunk.GetLength() - tail) & 1;
+            found.clear();
+            this->engine.FindAll(chunk, nextAllowed > chunkOffset ? nextAllowed - chunkOffset : 0, found);
+            CHECKBK(Report(chunkOffset, chunk.GetLength() - tail, nextAllowed), "");
+
+            seamOffset = chunkOffset + chunk.GetLength() - tail;
+            seam.assign(chunk.GetData() + chunk.GetLength() - tail, chunk.GetData() + chunk.GetLength());
+            this->processed += chunk.GetLength();
+        }
+        CHECKBK(this->stop == false, "");
+
+        // matches from the tail of the last chunk
+        if (!seam.empty())
+        {
+            found.clear();
+            this->engine.FindAll(BufferView(seam.data(), seam.size()), nextAllowed > seamOffset ? nextAllowed - seamOffset : 0, found);
+            CHECKBK(Report(seamOffset, seam.size(), nextAllowed), "");
+        }
+        CHECKBK(reader.HasFailed() == false, "Fail to read range [0x%llX, size: 0x%llX]", rangeStart, rangeSize);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->running  = false;
+        this->canceled = this->stop && !this->truncated; // stopped before the end of the ranges
+    }
+}
+void FindAllTask::Cancel()
+{
+    this->stop = true;
+    if (this->worker.joinable())
+        this->worker.join();
+}
+void FindAllTask::Clear()
+{
+    Cancel();
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->results.clear();
+    this->truncated = false;
+    this->canceled  = false;
+    this->id++;
+}
+bool FindAllTask::IsRunning() const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->running;
+}
+bool FindAllTask::IsCanceled() const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->canceled;
+}
+bool FindAllTask::IsTruncated() const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->truncated;
+}
+size_t FindAllTask::GetResultsCount() const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->results.size();
+}
+void FindAllTask::CopyResults(size_t from, std::vector<std::pair<uint64, uint64>>& output) const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (from < this->results.size())
+        output.insert(output.end(), this->results.begin() + from, this->results.end());
+}
+std::pair<uint64, uint64> FindAllTask::GetNext(uint64 offset) const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    const auto it = std::lower_bound(
+          this->results.begin(), this->results.end(), offset, [](const std::pair<uint64, uint64>& match, uint64 value) { return match.first < value; });
+    if (it == this->results.end())
+        return { GView::Utils::INVALID_OFFSET, 0 };
+    return *it;
+}
+std::pair<uint64, uint64> FindAllTask::GetPrevious(uint64 offset) const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    const auto it = std::upper_bound(
+          this->results.begin(), this->results.end(), offset, [](uint64 value, const std::pair<uint64, uint64>& match) { return value < match.first; });
+    if (it == this->results.begin())
+        return { GView::Utils::INVALID_OFFSET, 0 };
+    return *(it - 1);
+}
+} // namespace GView::View::BufferViewer
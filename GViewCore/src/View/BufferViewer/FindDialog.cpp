@@ -1,13 +1,13 @@
 #include "BufferViewer.hpp"
 
 #include <array>
-#include <regex>
 #include <charconv>
 
 namespace GView::View::BufferViewer
 {
 constexpr int32 BTN_ID_OK     = 1;
 constexpr int32 BTN_ID_CANCEL = 2;
+constexpr int32 BTN_ID_FIND_ALL = 16;
 
 constexpr int32 RADIOBOX_ID_TEXT                  = 3;
 constexpr int32 RADIOBOX_ID_BINARY                = 4;
@@ -32,7 +32,7 @@ constexpr int32 GROUPD_ID_BUFFER_ACTION  = 5;
 constexpr uint32 DIALOG_HEIGHT_TEXT_FORMAT      = 18;
 constexpr uint32 DESCRIPTION_HEIGHT_TEXT_FORMAT = 3;
 constexpr std::string_view TEXT_FORMAT_TITLE    = "Text Pattern";
-constexpr std::string_view TEXT_FORMAT_BODY     = "Plain text or regex (ECMAScript) to find. Alt+I to focus on input text field.";
+constexpr std::string_view TEXT_FORMAT_BODY     = "Plain text or regex (RE2 syntax) to find. Alt+I to focus on input text field.";
 
 constexpr std::string_view BINARY_FORMAT_TITLE = "Binary Pattern";
 constexpr std::array<std::string_view, 4> BINARY_FORMAT_BODY{ "Binary pattern to find. Alt+I to focus on input text field.",
@@ -46,7 +46,7 @@ constexpr uint32 DESCRIPTION_HEIGHT_BINARY_FORMAT = DESCRIPTION_HEIGHT_TEXT_FORM
 constexpr std::string_view ANYTHING_PATTERN{ "???" };
 
 FindDialog::FindDialog()
-    : Window("Find", "d:c,w:30%,h:18", WindowFlags::ProcessReturn | WindowFlags::Sizeable), currentPos(GView::Utils::INVALID_OFFSET),
+    : Window("Find", "d:c,w:40%,h:18", WindowFlags::ProcessReturn | WindowFlags::Sizeable), currentPos(GView::Utils::INVALID_OFFSET),
       position(GView::Utils::INVALID_OFFSET), match({ GView::Utils::INVALID_OFFSET, 0 })
 {
     description = Factory::CanvasViewer::Create(
@@ -98,8 +98,9 @@ FindDialog::FindDialog()
     alingTextToUpperLeftCorner->SetChecked(true);
     alingTextToUpperLeftCorner->Handlers()->OnCheck = this;
 
-    Factory::Button::Create(this, "&OK", "x:25%,y:100%,a:b,w:12", BTN_ID_OK);
-    Factory::Button::Create(this, "&Cancel", "x:75%,y:100%,a:b,w:12", BTN_ID_CANCEL);
+    Factory::Button::Create(this, "&OK", "x:20%,y:100%,a:b,w:12", BTN_ID_OK);
+    Factory::Button::Create(this, "Find &all", "x:50%,y:100%,a:b,w:12", BTN_ID_FIND_ALL);
+    Factory::Button::Create(this, "&Cancel", "x:80%,y:100%,a:b,w:12", BTN_ID_CANCEL);
 
     SetDescription();
     Update();
@@ -116,9 +117,16 @@ bool FindDialog::OnEvent(Reference<Control>, Event eventType, int ID)
             return true;
         case BTN_ID_OK:
             Exit(Dialogs::Result::Ok);
-            newRequest = true;
+            newRequest  = true;
+            findAllMode = false;
+            findAll.Clear();
             CHECK(ProcessInput(), false, "");
             return true;
+        case BTN_ID_FIND_ALL:
+            Exit(Dialogs::Result::Ok);
+            newRequest = true;
+            CHECK(FindAll(), false, "");
+            return true;
         }
     }
 
@@ -126,7 +134,9 @@ bool FindDialog::OnEvent(Reference<Control>, Event eventType, int ID)
     {
     case Event::WindowAccept:
         Exit(Dialogs::Result::Ok);
-        newRequest = true;
+        newRequest  = true;
+        findAllMode = false;
+        findAll.Clear();
         CHECK(ProcessInput(), false, "");
         return true;
     case Event::WindowClose:
@@ -297,12 +307,24 @@ void FindDialog::UpdateData(uint64 currentPos, Reference<GView::Object> object)
 std::pair<uint64, uint64> FindDialog::GetNextMatch(uint64 currentPos)
 {
     this->currentPos = currentPos;
+    if (findAllMode)
+    {
+        match = findAll.GetNext(currentPos);
+        return match;
+    }
     ProcessInput();
     return match;
 }
 
 std::pair<uint64, uint64> FindDialog::GetPreviousMatch(uint64 currentPos)
 {
+    if (findAllMode)
+    {
+        this->currentPos = currentPos;
+        match            = findAll.GetPrevious(currentPos);
+        return match;
+    }
+
     const auto initialCurrentPos = this->currentPos;
     while (true)
     {
@@ -380,10 +402,87 @@ bool ValidateHex(std::string_view number)
     return true;
 }
 
-bool FindDialog::ProcessInput(uint64 end, bool last)
+bool FindDialog::ParseBinaryPattern(std::vector<int16>& pattern)
+{
+    std::string input;
+    usb.ToString(input);
+
+    pattern.clear();
+    pattern.reserve(input.size() / 2 + 1);
+
+    uint64 last    = 0;
+    uint64 current = input.find_first_of(' ', last);
+    do
+    {
+        if (current == std::string::npos)
+        {
+            current = input.size();
+        }
+
+        std::string_view number{ input.data() + last, current - last };
+
+        if (textDec->IsChecked())
+        {
+            if (ValidateDecimal(number) == false)
+            {
+                Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
+                return false;
+            }
+
+            if (number[0] == '?')
+            {
+                pattern.push_back(-1);
+            }
+            else
+            {
+                uint8 n;
+                const std::from_chars_result resultFrom = std::from_chars(number.data(), number.data() + number.size(), n);
+                if (resultFrom.ec == std::errc::invalid_argument || resultFrom.ec == std::errc::result_out_of_range)
+                {
+                    Dialogs::MessageBox::ShowError("Error!", "Invalid input - conversion failed!");
+                    return false;
+                }
+                pattern.push_back(n);
+            }
+        }
+        else
+        {
+            if (number.size() > 2)
+            {
+                Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
+                return false;
+            }
+
+            if (ValidateHex(number) == false)
+            {
+                Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
+                return false;
+            }
+
+            if (number[0] == '?')
+            {
+                pattern.push_back(-1);
+            }
+            else
+            {
+                uint8 n;
+                const std::from_chars_result resultFrom = std::from_chars(number.data(), number.data() + number.size(), n, 16);
+                if (resultFrom.ec == std::errc::invalid_argument || resultFrom.ec == std::errc::result_out_of_range)
+                {
+                    Dialogs::MessageBox::ShowError("Error!", "Invalid input - conversion failed!");
+                    return false;
+                }
+                pattern.push_back(n);
+            }
+        }
+        last = current + 1;
+    } while ((current = input.find_first_of(' ', last)) && last < input.size());
+
+    return true;
+}
+
+bool FindDialog::PrepareEngine(SearchEngine& target)
 {
-    CHECK(currentPos != GView::Utils::INVALID_OFFSET, false, "");
-    CHECK(object.IsValid(), false, "");
     CHECK(input.IsValid(), false, "");
 
     if (input->GetText().Len() == 0)
@@ -395,11 +494,82 @@ bool FindDialog::ProcessInput(uint64 end, bool last)
     CHECK(usb.Set(input->GetText()), false, "");
     CHECK(usb.Len() > 0, false, "");
 
+    if (textOption->IsChecked())
+    {
+        if (textRegex->IsChecked())
+        {
+            std::string expression;
+            usb.ToString(expression);
+            if (!target.InitRegex(expression, textUnicode->IsChecked(), ignoreCase->IsChecked()))
+            {
+                Dialogs::MessageBox::ShowError("Error!", std::string("Invalid regular expression: ").append(target.GetRegexError()));
+                return false;
+            }
+        }
+        else
+        {
+            CHECK(target.InitText(usb.ToStringView(), textUnicode->IsChecked(), ignoreCase->IsChecked()), false, "");
+        }
+    }
+    else
+    {
+        std::vector<int16> pattern;
+        CHECK(ParseBinaryPattern(pattern), false, "");
+        CHECK(target.InitBytes(pattern), false, "");
+    }
+    return true;
+}
+
+bool FindDialog::FindAll()
+{
+    CHECK(object.IsValid(), false, "");
+    // the engine is used by the worker of the previous search => that one must end before the engine is changed
+    findAll.Cancel();
+    CHECK(PrepareEngine(findAll.GetEngine()), false, "");
+    match       = { GView::Utils::INVALID_OFFSET, 0 };
+    newRequest  = false;
+    findAllMode = true;
+
+    // the whole file (or every selection) is searched; the ranges must be sorted and must not overlap
+    std::vector<std::pair<uint64, uint64>> ranges;
+    if (searchSelection->IsChecked())
+    {
+        std::vector<std::pair<uint64, uint64>> zones;
+        for (auto i = 0U; i < this->object->GetContentType()->GetSelectionZonesCount(); i++)
+        {
+            const auto zone = this->object->GetContentType()->GetSelectionZone(i);
+            zones.emplace_back(zone.start, zone.end + 1);
+        }
+        std::sort(zones.begin(), zones.end());
+        for (const auto& [start, end] : zones)
+        {
+            if (!ranges.empty() && start <= ranges.back().first + ranges.back().second)
+                ranges.back().second = std::max<>(ranges.back().second, end - ranges.back().first);
+            else
+                ranges.emplace_back(start, end - start);
+        }
+    }
+    else
+    {
+        ranges.emplace_back(0ULL, object->GetData().GetSize());
+    }
+
+    // the search runs on a worker thread => the view highlights the matches (and shows the progress) as they are found
+    CHECK(findAll.Start(object->GetData(), std::move(ranges)), false, "");
+    return true;
+}
+
+bool FindDialog::ProcessInput(uint64 end, bool last)
+{
+    CHECK(currentPos != GView::Utils::INVALID_OFFSET, false, "");
+    CHECK(object.IsValid(), false, "");
+
     if (newRequest)
     {
         match      = { GView::Utils::INVALID_OFFSET, 0 };
         newRequest = false;
     }
+    CHECK(PrepareEngine(engine), false, "");
 
     std::vector<TypeInterface::SelectionZone> selectedZones;
     for (auto i = 0U; i < this->object->GetContentType()->GetSelectionZonesCount(); i++)
@@ -437,251 +607,44 @@ bool FindDialog::ProcessInput(uint64 end, bool last)
         format = "[0x%.16llX/0x%.16llX] bytes...";
     }
 
-    const auto block = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : object->GetData().GetCacheSize();
-
-    const auto SearchInAsciiChunk = [&](uint64 offset, uint64 left, const std::regex& pattern)
+    // consecutive chunks overlap so that a match that crosses a chunk boundary is not lost
+    auto processed           = 0ULL;
+    const auto SearchInRange = [&](uint64 offset, uint64 size)
     {
-        do
+        auto chunks = object->GetData().Chunks(offset, size, engine.GetOverlap());
+        for (auto it = chunks.begin(); it != chunks.end(); ++it)
         {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
-
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
+            CHECK(ProgressStatus::Update(processed + (it.GetOffset() - offset), ls.Format(format, processed + (it.GetOffset() - offset), objectSize)) == false,
+                  false,
+                  "");
 
-            const auto buffer = object->GetData().Get(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
-
-            const auto initialStart = reinterpret_cast<char const*>(buffer.GetData());
-            auto start              = reinterpret_cast<char const*>(buffer.GetData());
-            const auto end          = reinterpret_cast<char const*>(start + buffer.GetLength());
-            std::cmatch matches{};
-            while (std::regex_search(start, end, matches, pattern))
+            uint64 start, length;
+            if (engine.Find(*it, last, start, length))
             {
-                match = std::pair<uint64, uint64>{ offset + (start - initialStart) + matches.position(), matches.length() };
-                start += matches.position() + matches.length();
+                match = std::pair<uint64, uint64>{ it.GetOffset() + start, length };
                 CHECKBK(last, "");
             }
-
-            offset += sizeToRead;
-        } while (left > 0);
-
-        return true;
-    };
-
-    const auto SearchInUnicodeChunk = [&](uint64 offset, uint64 left, const std::wregex& pattern)
-    {
-        do
-        {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
-
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
-
-            const auto buffer = object->GetData().Get(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
-
-            auto initialStart = reinterpret_cast<wchar_t const*>(buffer.GetData());
-            auto start        = reinterpret_cast<wchar_t const*>(buffer.GetData());
-            const auto end    = reinterpret_cast<wchar_t const*>(start + buffer.GetLength());
-            std::wcmatch matches{};
-            while (std::regex_search(start, end, matches, pattern))
-            {
-                match = std::pair<uint64, uint64>{ offset + (start - initialStart) * sizeof(wchar_t) + matches.position(), matches.length() };
-                start += matches.position() + matches.length();
-                CHECKBK(last, "");
-            }
-
-            offset += sizeToRead;
-        } while (left > 0);
-
+        }
+        CHECK(chunks.HasFailed() == false, false, "");
+        processed += size;
         return true;
     };
 
-    if (textOption->IsChecked())
+    if (computeForFile)
     {
-        if (textAscii->IsChecked())
-        {
-            std::string ascii;
-            usb.ToString(ascii);
-
-            if (textRegex->IsChecked() == false)
-            {
-                const static std::regex specialChars{ R"([-[\]{}()*+?.,\^$|#\s])" };
-                ascii = std::regex_replace(ascii, specialChars, R"(\$&)");
-            }
-
-            const std::regex pattern(
-                  ascii,
-                  (ignoreCase->IsChecked() ? std::regex_constants::icase | std::regex_constants::ECMAScript | std::regex_constants::optimize
-                                           : std::regex_constants::ECMAScript | std::regex_constants::optimize));
-
-            if (computeForFile)
-            {
-                auto offset = currentPos;
-                auto left   = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : (object->GetData().GetSize() - currentPos);
-
-                CHECK(SearchInAsciiChunk(offset, left, pattern), false, "");
-                CHECK(HasResults() == false, true, "");
-            }
-            else
-            {
-                for (const auto& zone : selectedZones)
-                {
-                    auto offset = zone.start;
-                    auto left   = zone.end - zone.start + 1;
-
-                    CHECK(SearchInAsciiChunk(offset, left, pattern), false, "");
-                    CHECK(HasResults() == false, true, "");
-                }
-            }
-        }
-        else
-        {
-            std::wstring unicode{ reinterpret_cast<const wchar_t*>(usb.ToStringView().data()), usb.ToStringView().size() };
-
-            if (textRegex->IsChecked() == false)
-            {
-                const static std::wregex specialChars{ LR"([-[\]{}()*+?.,\^$|#\s])" };
-                unicode = std::regex_replace(unicode, specialChars, LR"(\$&)");
-            }
-
-            const std::wregex pattern(
-                  reinterpret_cast<wchar_t const* const>(usb.ToStringView().data()),
-                  (ignoreCase->IsChecked() ? std::regex_constants::icase | std::regex_constants::ECMAScript | std::regex_constants::optimize
-                                           : std::regex_constants::ECMAScript | std::regex_constants::optimize));
-
-            if (computeForFile)
-            {
-                auto offset = currentPos;
-                auto left   = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : (object->GetData().GetSize() - currentPos);
-
-                CHECK(SearchInUnicodeChunk(offset, left, pattern), false, "");
-                CHECK(HasResults() == false, true, "");
-            }
-            else
-            {
-                for (const auto& zone : selectedZones)
-                {
-                    auto offset = zone.start;
-                    auto left   = zone.end - zone.start + 1;
+        auto offset = currentPos;
+        auto left   = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : (object->GetData().GetSize() - currentPos);
 
-                    CHECK(SearchInUnicodeChunk(offset, left, pattern), false, "");
-                    CHECK(HasResults() == false, true, "");
-                }
-            }
-        }
+        CHECK(SearchInRange(offset, left), false, "");
+        CHECK(HasResults() == false, true, "");
     }
     else
     {
-        std::string input;
-        usb.ToString(input);
-
-        std::string regexPayload;
-        regexPayload.reserve(input.size() * 2);
-
-        uint64 last    = 0;
-        uint64 current = input.find_first_of(' ', last);
-        do
-        {
-            if (current == std::string::npos)
-            {
-                current = input.size();
-            }
-
-            std::string_view number{ input.data() + last, current - last };
-
-            if (textDec->IsChecked())
-            {
-                if (ValidateDecimal(number) == false)
-                {
-                    Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
-                    return false;
-                }
-
-                if (number[0] == '?')
-                {
-                    regexPayload.append("[\\x00-\\xFF]");
-                }
-                else
-                {
-                    uint8 n;
-                    const std::from_chars_result resultFrom = std::from_chars(number.data(), number.data() + number.size(), n);
-                    if (resultFrom.ec == std::errc::invalid_argument || resultFrom.ec == std::errc::result_out_of_range)
-                    {
-                        Dialogs::MessageBox::ShowError("Error!", "Invalid input - conversion failed!");
-                        return false;
-                    }
-
-                    char hex[10]                        = { 0 };
-                    const std::to_chars_result resultTo = std::to_chars(std::begin(hex), std::end(hex), n, 16);
-                    if (resultTo.ec == std::errc::invalid_argument || resultTo.ec == std::errc::result_out_of_range)
-                    {
-                        Dialogs::MessageBox::ShowError("Error!", "Invalid input - conversion failed!");
-                        return false;
-                    }
-                    regexPayload.append("\\x");
-                    if (hex[1] == 0)
-                    {
-                        regexPayload.append("0");
-                    }
-                    regexPayload.append(hex);
-                }
-            }
-            else
-            {
-                if (number.size() > 2)
-                {
-                    Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
-                    return false;
-                }
-
-                if (ValidateHex(number) == false)
-                {
-                    Dialogs::MessageBox::ShowError("Error!", "Invalid input!");
-                    return false;
-                }
-
-                if (number[0] == '?')
-                {
-                    regexPayload.append("[\\x00-\\xFF]");
-                }
-                else
-                {
-                    regexPayload.append("\\x");
-                    if (number.size() == 1)
-                    {
-                        regexPayload.append("0");
-                    }
-                    regexPayload.append(number);
-                }
-            }
-            last = current + 1;
-        } while ((current = input.find_first_of(' ', last)) && last < input.size());
-
-        const std::regex pattern(
-              regexPayload,
-              (ignoreCase->IsChecked() ? std::regex_constants::icase | std::regex_constants::ECMAScript | std::regex_constants::optimize
-                                       : std::regex_constants::ECMAScript | std::regex_constants::optimize));
-
-        if (computeForFile)
+        for (const auto& zone : selectedZones)
         {
-            auto offset = currentPos;
-            auto left   = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : (object->GetData().GetSize() - currentPos);
-
-            CHECK(SearchInAsciiChunk(offset, left, pattern), false, "");
+            CHECK(SearchInRange(zone.start, zone.end - zone.start + 1), false, "");
             CHECK(HasResults() == false, true, "");
         }
-        else
-        {
-            for (const auto& zone : selectedZones)
-            {
-                auto offset = zone.start;
-                auto left   = zone.end - zone.start + 1;
-
-                CHECK(SearchInAsciiChunk(offset, left, pattern), false, "");
-                CHECK(HasResults() == false, true, "");
-            }
-        }
     }
 
     return false;
@@ -38,6 +38,9 @@ bool DefaultAsciiMask[256] = {
     constexpr int32 VIEW_COMMAND_DEACTIVATE_SYNC{ 0xBF13 };
 */
 
+constexpr uint32 COLOR_MAP_LOOKAHEAD = 256; // bytes after the view (a selection has up to 256 bytes)
+constexpr uint16 SPACE_CHARACTER     = 0x100; // shown after the characters of an unicode string
+
 Config Instance::config;
 
 Instance::Instance(Reference<GView::Object> _obj, Settings* _settings)
@@ -47,7 +50,6 @@ Instance::Instance(Reference<GView::Object> _obj, Settings* _settings)
 
     memcpy(this->StringInfo.AsciiMask, DefaultAsciiMask, 256);
 
-    this->bufColor.Reset();
     this->ResetStringInfo();
 
     // settings
@@ -368,6 +370,9 @@ bool Instance::ShowFindDialog()
     findDialog.UpdateData(this->cursor.GetCurrentPosition(), this->obj);
     CHECK(findDialog.Show() == Dialogs::Result::Ok, true, "");
 
+    if (findDialog.IsFindAllMode()) {
+        return true; // the search runs in background (the matches are highlighted and counted in the cursor information as they are found)
+    }
     const auto [start, length] = findDialog.GetNextMatch(this->cursor.GetCurrentPosition());
     if (start != GView::Utils::INVALID_OFFSET && length != GView::Utils::INVALID_OFFSET) {
         if (findDialog.AlignToUpperRightCorner()) {
@@ -527,91 +532,140 @@ ColorPair Instance::OffsetToColorZone(uint64 offset)
 
     return Cfg.Text.Inactive;
 }
-ColorPair Instance::OffsetToColor(uint64 offset)
+void Instance::UpdateFindResultsZones()
 {
-    // current selection
-    if ((this->CurrentSelection.size) && (this->CurrentSelection.highlight)) {
-        if ((offset >= this->CurrentSelection.start) && (offset < this->CurrentSelection.end))
-            return Cfg.Selection.SimilarText;
-
-        auto b = this->obj->GetData().Get(offset, this->CurrentSelection.size, true);
-        if (b.IsValid()) {
-            if (b[0] == this->CurrentSelection.buffer[0]) {
-                if (memcmp(b.begin(), this->CurrentSelection.buffer, this->CurrentSelection.size) == 0) {
-                    this->CurrentSelection.start = offset;
-                    this->CurrentSelection.end   = offset + this->CurrentSelection.size;
-                    return Cfg.Selection.SimilarText;
-                }
+    // matches from "Find all" are appended to the zones list as they are found
+    const auto& results = findDialog.GetFindAllResults();
+    if (results.GetID() != this->findResults.id) {
+        this->findResults.zones.Clear();
+        this->findResults.count = 0;
+        this->findResults.id    = results.GetID();
+    }
+
+    std::vector<std::pair<uint64, uint64>> matches;
+    results.CopyResults(this->findResults.count, matches);
+    for (const auto& [start, length] : matches) {
+        this->findResults.zones.Add(start, start + length - 1, Cfg.Selection.SimilarText, "Find result");
+    }
+    this->findResults.count += matches.size();
+}
+void Instance::ApplyColorRuns(const std::vector<BufferColor>& runs)
+{
+    auto& map      = this->colorMap;
+    const auto end = map.start + map.size;
+    for (const auto& run : runs) {
+        if ((run.Empty()) || (run.end < map.start) || (run.start >= end))
+            continue;
+        const auto from = std::max<>(run.start, map.start);
+        const auto to   = run.end >= end - 1 ? end : run.end + 1;
+        std::fill(map.colors.begin() + (from - map.start), map.colors.begin() + (to - map.start), run.color);
+    }
+}
+void Instance::ApplyColorZones(const std::vector<GView::Utils::Zone>& zones)
+{
+    auto& map      = this->colorMap;
+    const auto end = map.start + map.size;
+    for (const auto& zone : zones) {
+        if ((zone.interval.high < map.start) || (zone.interval.low >= end))
+            continue;
+        const auto from = std::max<>(zone.interval.low, map.start);
+        const auto to   = zone.interval.high >= end - 1 ? end : zone.interval.high + 1;
+        std::fill(map.colors.begin() + (from - map.start), map.colors.begin() + (to - map.start), zone.color);
+    }
+}
+void Instance::ComputeStringsColors()
+{
+    // consecutive strings (and the data between them); a string that starts before the view is kept from the previous paint
+    auto& map      = this->colorMap;
+    const auto end = map.start + map.size;
+    auto offset    = map.start;
+    if ((offset < StringInfo.start) || (offset >= StringInfo.end))
+        UpdateStringInfo(offset);
+
+    while ((offset < end) && (StringInfo.start <= offset) && (offset < StringInfo.end)) {
+        const auto stringEnd = std::min<>(StringInfo.end, end);
+        if (StringInfo.type != StringType::None) {
+            const auto color = StringInfo.type == StringType::Ascii ? config.Colors.Ascii : config.Colors.Unicode;
+            std::fill(map.colors.begin() + (offset - map.start), map.colors.begin() + (stringEnd - map.start), color);
+        }
+        if (StringInfo.type == StringType::Unicode) {
+            // the characters are shown in the first half of the string (and spaces after them)
+            const auto buf = this->obj->GetData().Get(StringInfo.start, static_cast<uint32>(StringInfo.end - StringInfo.start) + 1, false);
+            for (auto ofs = offset; ofs < stringEnd; ofs++) {
+                const auto pos                  = (ofs - StringInfo.start) << 1;
+                map.characters[ofs - map.start] = ofs > StringInfo.middle ? SPACE_CHARACTER : (pos < buf.GetLength() ? buf[pos] : 0);
             }
         }
+        offset = StringInfo.end;
+        if (offset < end)
+            UpdateStringInfo(offset);
     }
+}
+void Instance::ComputeColorMap()
+{
+    auto& map             = this->colorMap;
+    auto& cache           = this->obj->GetData();
+    const auto remaining  = cache.GetSize() - std::min<>(cursor.GetStartView(), cache.GetSize());
+    const auto viewSize   = std::min<>(static_cast<uint64>(Layout.charactersPerLine) * Layout.visibleRows, remaining);
+    const auto bytesCount = std::min<>(viewSize + COLOR_MAP_LOOKAHEAD, remaining);
+
+    // the providers get a copy of the view (they can use the cache for other reads)
+    const auto buf = cache.Get(cursor.GetStartView(), static_cast<uint32>(bytesCount), false);
+    map.start      = cursor.GetStartView();
+    map.bytes.assign(buf.begin(), buf.end());
+    map.size = static_cast<uint32>(std::min<>(viewSize, static_cast<uint64>(map.bytes.size())));
+    map.colors.assign(map.size, Cfg.Text.Inactive);
+    map.characters.assign(map.bytes.begin(), map.bytes.begin() + map.size);
+    if (map.size == 0)
+        return;
 
-    // color
+    // from the lowest priority to the highest one
     if (settings) {
         if (showObjectsHighlighting) {
-            if (auto z = this->settings->zListObjects.OffsetToZone(offset)) {
-                return z->color;
+            // only the objects are shown
+            settings->zListObjects.GetCachedZones(map.zones);
+            ApplyColorZones(map.zones);
+        } else {
+            settings->zList.GetCachedZones(map.zones);
+            ApplyColorZones(map.zones);
+            if (this->StringInfo.showAscii || this->StringInfo.showUnicode)
+                ComputeStringsColors();
+            if (showTypeObjects && settings->positionToColorCallback) {
+                settings->positionToColorCallback->GetColorsForBuffer(map.start, BufferView(map.bytes.data(), map.bytes.size()), map.size, map.runs);
+                ApplyColorRuns(map.runs);
             }
-            return Cfg.Text.Inactive;
-        }
-
-        if ((showCodeExecution || showSyncCompare) && settings->bufferColorCallback) {
-            if ((offset >= bufColor.start) && (offset <= bufColor.end))
-                return bufColor.color;
-
-            if (cursor.GetStartView() <= offset) {
-                auto b = this->obj->GetData().Get(offset, 1, true);
-                if (b.IsValid()) {
-                    if (settings->bufferColorCallback->GetColorForByteAt(
-                              offset,
-                              ViewData{ .viewStartOffset   = cursor.GetStartView(),
-                                        .viewSize          = static_cast<uint64>(Layout.charactersPerLine) * Layout.visibleRows,
-                                        .cursorStartOffset = cursor.GetCurrentPosition(),
-                                        .byte              = b.GetData()[0] },
-                              bufColor.color)) {
-                        bufColor.start = offset;
-                        bufColor.end   = offset;
-                        return bufColor.color;
-                    }
-                }
+            if ((showCodeExecution || showSyncCompare) && settings->bufferColorCallback) {
+                const ViewData vd{ .viewStartOffset   = cursor.GetStartView(),
+                                   .viewSize          = static_cast<uint64>(Layout.charactersPerLine) * Layout.visibleRows,
+                                   .cursorStartOffset = cursor.GetCurrentPosition() };
+                settings->bufferColorCallback->GetColorsForBuffer(map.start, BufferView(map.bytes.data(), map.size), vd, map.runs);
+                ApplyColorRuns(map.runs);
             }
-            // no color provided for the specific buffer --> check show types
         }
+    }
 
-        if (showTypeObjects && settings->positionToColorCallback) {
-            if ((offset >= bufColor.start) && (offset <= bufColor.end))
-                return bufColor.color;
-            if (settings->positionToColorCallback->GetColorForBuffer(offset, this->obj->GetData().Get(offset, 16, false), bufColor))
-                return bufColor.color;
-
-            // no color provided for the specific buffer --> check strings and zones
-        }
+    // "Find all" matches
+    if (this->findResults.count > 0) {
+        this->findResults.zones.GetCachedZones(map.zones);
+        ApplyColorZones(map.zones);
     }
 
-    // check strings
-    if (this->StringInfo.showAscii || this->StringInfo.showUnicode) {
-        if ((offset >= StringInfo.start) && (offset < StringInfo.end)) {
-            switch (StringInfo.type) {
-            case StringType::Ascii:
-                return config.Colors.Ascii;
-            case StringType::Unicode:
-                return config.Colors.Unicode;
-            }
-        } else {
-            UpdateStringInfo(offset);
-            if ((offset >= StringInfo.start) && (offset < StringInfo.end)) {
-                switch (StringInfo.type) {
-                case StringType::Ascii:
-                    return config.Colors.Ascii;
-                case StringType::Unicode:
-                    return config.Colors.Unicode;
-                }
+    // current selection (and the other places where the same bytes are)
+    if ((this->CurrentSelection.size) && (this->CurrentSelection.highlight)) {
+        const auto size = this->CurrentSelection.size;
+        for (auto idx = 0U; idx < map.size; idx++) {
+            const auto offset = map.start + idx;
+            if ((offset < this->CurrentSelection.start) || (offset >= this->CurrentSelection.end)) {
+                if ((idx + size > map.bytes.size()) || (map.bytes[idx] != this->CurrentSelection.buffer[0]))
+                    continue;
+                if (memcmp(map.bytes.data() + idx, this->CurrentSelection.buffer, size) != 0)
+                    continue;
+                this->CurrentSelection.start = offset;
+                this->CurrentSelection.end   = offset + size;
             }
+            map.colors[idx] = Cfg.Selection.SimilarText;
         }
     }
-
-    // not a string --> check the zone
-    return OffsetToColorZone(offset);
 }
 
 void Instance::UpdateViewSizes()
@@ -823,17 +877,12 @@ void Instance::WriteLineTextToChars(DrawLineInfo& dli)
         const auto startCh  = dli.chText;
         const auto ofsStart = dli.offset;
         while (dli.start < dli.end) {
-            cp = OffsetToColor(dli.offset);
+            const auto idx = dli.offset - colorMap.start;
+            cp             = idx < colorMap.size ? colorMap.colors[idx] : Cfg.Text.Inactive;
             if (selection.Contains(dli.offset))
                 cp = Cfg.Selection.Editor;
-            if (StringInfo.type == StringType::Unicode) {
-                if (dli.offset > StringInfo.middle)
-                    dli.chText->Code = ' ';
-                else
-                    dli.chText->Code = codePage[obj->GetData().GetFromCache(((dli.offset - StringInfo.start) << 1) + StringInfo.start)];
-            } else {
-                dli.chText->Code = codePage[*dli.start];
-            }
+            const auto ch     = idx < colorMap.size ? colorMap.characters[idx] : *dli.start;
+            dli.chText->Code  = ch == SPACE_CHARACTER ? ' ' : codePage[static_cast<uint8>(ch)];
             dli.chText->Color = cp;
             dli.chText++;
             dli.start++;
@@ -863,8 +912,9 @@ void Instance::WriteLineNumbersToChars(DrawLineInfo& dli)
     auto end   = start + (dli.end - dli.start);
 
     while (dli.start < dli.end) {
+        const auto idx = dli.offset - colorMap.start;
         if (active) {
-            cp = OffsetToColor(dli.offset);
+            cp = idx < colorMap.size ? colorMap.colors[idx] : Cfg.Text.Inactive;
 
             if (selection.Contains(dli.offset)) {
                 cp = Cfg.Selection.Editor;
@@ -986,15 +1036,9 @@ void Instance::WriteLineNumbersToChars(DrawLineInfo& dli)
         c->Color = cp;
         c++;
 
-        if (active) {
-            if (StringInfo.type == StringType::Unicode) {
-                if (dli.offset > StringInfo.middle)
-                    dli.chText->Code = ' ';
-                else
-                    dli.chText->Code = codePage[obj->GetData().GetFromCache(((dli.offset - StringInfo.start) << 1) + StringInfo.start)];
-            } else {
-                dli.chText->Code = codePage[*dli.start];
-            }
+        if ((active) && (idx < colorMap.size)) {
+            const auto ch    = colorMap.characters[idx];
+            dli.chText->Code = ch == SPACE_CHARACTER ? ' ' : codePage[static_cast<uint8>(ch)];
         } else {
             dli.chText->Code = codePage[*dli.start];
         }
@@ -1032,10 +1076,18 @@ void Instance::Paint(Renderer& renderer)
     WriteHeaders(renderer);
 
     const auto& startView = cursor.GetStartView();
+    const auto endView    = ((uint64) Layout.charactersPerLine) * Layout.visibleRows + startView - 1;
+    UpdateFindResultsZones();
+    if (this->findResults.count > 0) {
+        this->findResults.zones.SetCache({ startView, endView });
+    }
     if (showObjectsHighlighting) {
-        settings->zListObjects.SetCache({ startView, ((uint64) Layout.charactersPerLine) * (Layout.visibleRows - 1ull) + startView });
+        settings->zListObjects.SetCache({ startView, endView });
     } else {
-        settings->zList.SetCache({ startView, ((uint64) Layout.charactersPerLine) * (Layout.visibleRows - 1ull) + startView });
+        settings->zList.SetCache({ startView, endView });
+    }
+    if (this->showColorNotFocused || this->HasFocus()) {
+        ComputeColorMap();
     }
 
     DrawLineInfo dli;
@@ -1133,6 +1185,9 @@ bool Instance::OnUpdateCommandBar(AppCUI::Application::CommandBar& commandBar)
         commandBar.SetCommand(config.Keys.FindNext, "FindNext", BUFFERVIEW_CMD_FINDNEXT);
         commandBar.SetCommand(config.Keys.FindPrevious, "FindPrevious", BUFFERVIEW_CMD_FINDPREVIOUS);
     }
+    if (findDialog.IsFindAllMode() && findDialog.GetFindAllResults().IsRunning()) {
+        commandBar.SetCommand(Key::Escape, "StopFindAll", BUFFERVIEW_CMD_STOP_FIND_ALL);
+    }
 
     commandBar.SetCommand(config.Keys.DissasmDialog, "Dissasm", BUFFERVIEW_CMD_DISSASM_DIALOG);
 
@@ -1175,6 +1230,12 @@ bool Instance::OnKeyEvent(AppCUI::Input::Key keyCode, char16 charCode)
     //    }
     //}
 
+    // Escape stops only a running "Find all" (otherwise it keeps its usual meaning)
+    if ((keyCode == Key::Escape) && (!select) && (findDialog.IsFindAllMode()) && (findDialog.GetFindAllResults().IsRunning())) {
+        findDialog.StopFindAll();
+        return true;
+    }
+
     switch (keyCode) {
     case Key::Down:
         MoveTo(this->cursor.GetCurrentPosition() + this->Layout.charactersPerLine, select);
@@ -1421,6 +1482,12 @@ bool Instance::OnEvent(Reference<Control>, Event eventType, int ID)
 
         return true;
     }
+    case BUFFERVIEW_CMD_STOP_FIND_ALL:
+        if (findDialog.IsFindAllMode() && findDialog.GetFindAllResults().IsRunning()) {
+            findDialog.StopFindAll();
+            return true;
+        }
+        return false;
     case BUFFERVIEW_CMD_DISSASM_DIALOG:
         this->ShowDissasmDialog();
         return true;
@@ -1556,6 +1623,29 @@ int Instance::PrintCursorZone(int x, int y, uint32 width, Renderer& r)
     r.WriteSpecialCharacter(x + width, y, SpecialChars::BoxVerticalSingleLine, this->CursorColors.Line);
     return x + width + 1;
 }
+int Instance::PrintFindAllInfo(int x, int y, uint32 width, Renderer& r)
+{
+    // "Find all" runs in background => its status is refreshed with every paint
+    if (!findDialog.IsFindAllMode())
+        return x;
+    const auto& results = findDialog.GetFindAllResults();
+    const auto count    = (uint64) results.GetResultsCount();
+    LocalString<64> tmp;
+    if (results.IsRunning())
+        tmp.Format("Found: %llu (%u%%)", count, results.GetProgress());
+    else if (results.IsTruncated())
+        tmp.Format("Found: %llu (max)", count);
+    else if (results.IsCanceled())
+        tmp.Format("Found: %llu (stopped)", count);
+    else if (count == 0)
+        tmp.Set("Pattern not found");
+    else
+        tmp.Format("Found: %llu", count);
+
+    r.WriteSingleLineText(x, y, width, tmp, this->CursorColors.Highlighted);
+    r.WriteSpecialCharacter(x + width, y, SpecialChars::BoxVerticalSingleLine, this->CursorColors.Line);
+    return x + width + 1;
+}
 int Instance::Print8bitValue(int x, int height, AppCUI::Utils::BufferView buffer, Renderer& r)
 {
     if (buffer.GetLength() == 0)
@@ -1802,6 +1892,9 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         x = Print32bitBEValue(x, height, buf, r);
         break;
     }
+    if (height > 0) {
+        PrintFindAllInfo(x, 0, 24, r);
+    }
 }
 
 //======================================================================[Mouse events]========================
@@ -1897,6 +1990,25 @@ void Instance::OnUpdateScrollBars()
 {
     this->UpdateVScrollBar(this->cursor.GetCurrentPosition() + 1, this->obj->GetData().GetSize());
 }
+bool Instance::OnFrameUpdate()
+{
+    // "Find all" runs in background => the view is repainted (the new matches are merged in Paint) only when the search
+    // progressed, found new matches or ended
+    const auto& results = findDialog.GetFindAllResults();
+    const auto running  = findDialog.IsFindAllMode() && results.IsRunning();
+    if (running != this->findResults.running) {
+        this->findResults.running   = running;
+        this->findResults.processed = results.GetProcessed();
+        return true;
+    }
+    if (!running)
+        return false;
+    const auto processed = results.GetProcessed();
+    if (processed == this->findResults.processed && results.GetResultsCount() == this->findResults.count)
+        return false;
+    this->findResults.processed = processed;
+    return true;
+}
 
 //======================================================================[PROPERTY]============================
 enum class PropertyID : uint32 {
@@ -0,0 +1,425 @@
+#include "BufferViewer.hpp"
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    include <emmintrin.h>
+#    define SEARCH_ENGINE_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define SEARCH_ENGINE_NEON
+#endif
+
+namespace GView::View::BufferViewer
+{
+constexpr uint32 REGEX_MAX_MATCH_SIZE = 0x1000; // a regex match longer than this might be split between two chunks
+
+inline uint8 ToLower(uint8 c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (c | 0x20) : c;
+}
+inline uint8 ToUpper(uint8 c)
+{
+    return ((c >= 'a') && (c <= 'z')) ? (c & 0xDF) : c;
+}
+
+bool SearchEngine::InitBytes(const std::vector<int16>& pattern)
+{
+    CHECK(pattern.size() > 0, false, "");
+
+    this->type = Type::Bytes;
+    this->regex.reset();
+    this->value.resize(pattern.size());
+    this->alternative.resize(pattern.size());
+    this->mask.resize(pattern.size());
+    this->hasFixedBytes = false;
+    for (auto idx = 0U; idx < static_cast<uint32>(pattern.size()); idx++)
+    {
+        const auto fixed       = pattern[idx] >= 0;
+        this->value[idx]       = fixed ? static_cast<uint8>(pattern[idx]) : 0;
+        this->alternative[idx] = this->value[idx];
+        this->mask[idx]        = fixed ? 0xFF : 0;
+        if (fixed)
+        {
+            if (!this->hasFixedBytes)
+                this->firstFixed = idx;
+            this->lastFixed     = idx;
+            this->hasFixedBytes = true;
+        }
+    }
+    return true;
+}
+bool SearchEngine::InitText(std::u16string_view text, bool unicode, bool ignoreCase)
+{
+    CHECK(text.size() > 0, false, "");
+
+    std::vector<int16> pattern;
+    if (unicode)
+    {
+        // UTF-16 (LE)
+        pattern.reserve(text.size() * 2);
+        for (auto ch : text)
+        {
+            pattern.push_back(static_cast<int16>(ch & 0xFF));
+            pattern.push_back(static_cast<int16>(ch >> 8));
+        }
+    }
+    else
+    {
+        // UTF-8 (plain ASCII for the usual case)
+        pattern.reserve(text.size());
+        for (auto ch : text)
+        {
+            if (ch < 0x80)
+            {
+                pattern.push_back(static_cast<int16>(ch));
+            }
+            else if (ch < 0x800)
+            {
+                pattern.push_back(static_cast<int16>(0xC0 | (ch >> 6)));
+                pattern.push_back(static_cast<int16>(0x80 | (ch & 0x3F)));
+            }
+            else
+            {
+                pattern.push_back(static_cast<int16>(0xE0 | (ch >> 12)));
+                pattern.push_back(static_cast<int16>(0x80 | ((ch >> 6) & 0x3F)));
+                pattern.push_back(static_cast<int16>(0x80 | (ch & 0x3F)));
+            }
+        }
+    }
+    CHECK(InitBytes(pattern), false, "");
+
+    if (ignoreCase)
+    {
+        // only ASCII letters are folded (for UTF-16 the high byte of such a character is always 0)
+        const auto step = unicode ? 2U : 1U;
+        for (auto idx = 0U; idx < static_cast<uint32>(this->value.size()); idx += step)
+        {
+            if ((unicode) && (this->value[idx + 1] != 0))
+                continue;
+            const auto c = this->value[idx];
+            if (c >= 0x80)
+                continue;
+            this->value[idx]       = ToLower(c);
+            this->alternative[idx] = ToUpper(c);
+        }
+    }
+    return true;
+}
+bool SearchEngine::InitRegex(std::string_view expression, bool unicode, bool ignoreCase)
+{
+    CHECK(expression.size() > 0, false, "");
+
+    // the whole expression is captured (Matcher::Match reports the first captured group)
+    std::string captured;
+    captured.reserve(expression.size() + 2);
+    captured += '(';
+    captured += expression;
+    captured += ')';
+
+    this->regex = std::make_unique<GView::Regex::Matcher>();
+    CHECK(this->regex->Init(captured, unicode, !ignoreCase), false, "");
+    this->type = unicode ? Type::UnicodeRegex : Type::Regex;
+    return true;
+}
+std::string_view SearchEngine::GetRegexError() const
+{
+    return this->regex ? this->regex->GetError() : std::string_view{};
+}
+uint32 SearchEngine::GetOverlap() const
+{
+    switch (this->type)
+    {
+    case Type::Bytes:
+        return static_cast<uint32>(this->value.size()) - 1;
+    case Type::Regex:
+        return REGEX_MAX_MATCH_SIZE;
+    case Type::UnicodeRegex:
+        return REGEX_MAX_MATCH_SIZE * 2;
+    default:
+        return 0;
+    }
+}
+bool SearchEngine::MatchAt(const uint8* p) const
+{
+    const auto count = this->value.size();
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        const auto c = p[idx] & this->mask[idx];
+        if ((c != this->value[idx]) && (c != this->alternative[idx]))
+            return false;
+    }
+    return true;
+}
+bool SearchEngine::FindBytes(const uint8* p, uint64 size, bool last, uint64& position) const
+{
+    const auto patternSize = static_cast<uint64>(this->value.size());
+    if (size < patternSize)
+        return false;
+    const auto count = size - patternSize + 1; // number of positions where the pattern can start
+
+    if (!this->hasFixedBytes)
+    {
+        // only wildcards
+        position = last ? count - 1 : 0;
+        return true;
+    }
+
+    // the first and the last fixed bytes filter the candidates, MatchAt validates them
+    const auto a      = this->firstFixed;
+    const auto b      = this->lastFixed;
+    const auto Filter = [&](uint64 pos)
+    {
+        const auto c1 = p[pos + a];
+        const auto c2 = p[pos + b];
+        return ((c1 == this->value[a]) || (c1 == this->alternative[a])) && ((c2 == this->value[b]) || (c2 == this->alternative[b]));
+    };
+    uint64 pos = 0;
+
+#if defined(SEARCH_ENGINE_SSE2) || defined(SEARCH_ENGINE_NEON)
+    constexpr uint64 BLOCK = 16;
+#    if defined(SEARCH_ENGINE_SSE2)
+    const auto firstValue       = _mm_set1_epi8(static_cast<char>(this->value[a]));
+    const auto firstAlternative = _mm_set1_epi8(static_cast<char>(this->alternative[a]));
+    const auto lastValue        = _mm_set1_epi8(static_cast<char>(this->value[b]));
+    const auto lastAlternative  = _mm_set1_epi8(static_cast<char>(this->alternative[b]));
+    // one bit for each of the 16 positions starting at 'start' where both anchors match
+    const auto Candidates = [&](uint64 start) -> uint32
+    {
+        const auto x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + start + a));
+        const auto y  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + start + b));
+        const auto m1 = _mm_or_si128(_mm_cmpeq_epi8(x, firstValue), _mm_cmpeq_epi8(x, firstAlternative));
+        const auto m2 = _mm_or_si128(_mm_cmpeq_epi8(y, lastValue), _mm_cmpeq_epi8(y, lastAlternative));
+        return static_cast<uint32>(_mm_movemask_epi8(_mm_and_si128(m1, m2)));
+    };
+#    else
+    const auto firstValue       = vdupq_n_u8(this->value[a]);
+    const auto firstAlternative = vdupq_n_u8(this->alternative[a]);
+    const auto lastValue        = vdupq_n_u8(this->value[b]);
+    const auto lastAlternative  = vdupq_n_u8(this->alternative[b]);
+    const auto Candidates       = [&](uint64 start) -> uint32
+    {
+        const auto x  = vld1q_u8(p + start + a);
+        const auto y  = vld1q_u8(p + start + b);
+        const auto m1 = vorrq_u8(vceqq_u8(x, firstValue), vceqq_u8(x, firstAlternative));
+        const auto m2 = vorrq_u8(vceqq_u8(y, lastValue), vceqq_u8(y, lastAlternative));
+        const auto m  = vandq_u8(m1, m2);
+        if (vmaxvq_u8(m) == 0)
+            return 0;
+        uint8 lanes[BLOCK];
+        vst1q_u8(lanes, m);
+        uint32 result = 0;
+        for (auto idx = 0U; idx < BLOCK; idx++)
+            result |= (lanes[idx] & 1U) << idx;
+        return result;
+    };
+#    endif
+
+    if (!last)
+    {
+        for (; pos + BLOCK <= count; pos += BLOCK)
+        {
+            for (auto bits = Candidates(pos); bits != 0; bits &= bits - 1)
+            {
+                const auto candidate = pos + std::countr_zero(bits);
+                if (MatchAt(p + candidate))
+                {
+                    position = candidate;
+                    return true;
+                }
+            }
+        }
+    }
+    else
+    {
+        auto end = count;
+        for (; end >= BLOCK; end -= BLOCK)
+        {
+            const auto start = end - BLOCK;
+            for (auto bits = Candidates(start); bits != 0; bits &= ~(1U << (31 - std::countl_zero(bits))))
+            {
+                const auto candidate = start + (31 - std::countl_zero(bits));
+                if (MatchAt(p + candidate))
+                {
+                    position = candidate;
+                    return true;
+                }
+            }
+        }
+        // the remaining positions (at the beginning of the buffer) are checked below
+        for (auto candidate = end; candidate > 0; candidate--)
+        {
+            if ((Filter(candidate - 1)) && (MatchAt(p + candidate - 1)))
+            {
+                position = candidate - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+
+    if (!last)
+    {
+        for (; pos < count; pos++)
+        {
+            if ((Filter(pos)) && (MatchAt(p + pos)))
+            {
+                position = pos;
+                return true;
+            }
+        }
+    }
+    else
+    {
+        for (auto candidate = count; candidate > 0; candidate--)
+        {
+            if ((Filter(candidate - 1)) && (MatchAt(p + candidate - 1)))
+            {
+                position = candidate - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+BufferView SearchEngine::ConvertToUTF8(BufferView buffer)
+{
+    // RE2 works with UTF-8 => convert the UTF-16 buffer (and keep a map back to the original offsets)
+    const auto* p    = buffer.GetData();
+    const auto count = buffer.GetLength() >> 1;
+    this->utf8.clear();
+    this->offsets.clear();
+    this->utf8.reserve(count);
+    this->offsets.reserve(count + 1);
+    for (uint64 idx = 0; idx < count; idx++)
+    {
+        const auto ch     = static_cast<char16>(p[idx * 2] | (p[idx * 2 + 1] << 8));
+        const auto offset = static_cast<uint32>(idx * 2);
+        if (ch < 0x80)
+        {
+            this->utf8 += static_cast<char>(ch);
+            this->offsets.push_back(offset);
+        }
+        else if (ch < 0x800)
+        {
+            this->utf8 += static_cast<char>(0xC0 | (ch >> 6));
+            this->utf8 += static_cast<char>(0x80 | (ch & 0x3F));
+            this->offsets.insert(this->offsets.end(), 2, offset);
+        }
+        else
+        {
+            this->utf8 += static_cast<char>(0xE0 | (ch >> 12));
+            this->utf8 += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+            this->utf8 += static_cast<char>(0x80 | (ch & 0x3F));
+            this->offsets.insert(this->offsets.end(), 3, offset);
+        }
+    }
+    this->offsets.push_back(static_cast<uint32>(count * 2));
+    return BufferView(reinterpret_cast<const uint8*>(this->utf8.data()), this->utf8.size());
+}
+bool SearchEngine::FindRegex(BufferView buffer, bool last, uint64& start, uint64& length)
+{
+    auto found  = false;
+    uint64 from = 0;
+    uint64 s, e;
+    while (from < buffer.GetLength())
+    {
+        if (this->regex->Match(BufferView(buffer.GetData() + from, buffer.GetLength() - from), s, e) == false)
+            break;
+        if (e == s)
+        {
+            from += s + 1; // empty matches are skipped
+            continue;
+        }
+        start  = from + s;
+        length = e - s;
+        found  = true;
+        if (!last)
+            break;
+        from += e;
+    }
+    return found;
+}
+void SearchEngine::FindAllRegex(BufferView buffer, std::vector<std::pair<uint64, uint64>>& matches)
+{
+    uint64 from = 0;
+    uint64 s, e;
+    while (from < buffer.GetLength())
+    {
+        if (this->regex->Match(BufferView(buffer.GetData() + from, buffer.GetLength() - from), s, e) == false)
+            break;
+        if (e > s)
+            matches.emplace_back(from + s, e - s);
+        from += std::max<>(e, s + 1); // empty matches are skipped
+    }
+}
+bool SearchEngine::Find(BufferView buffer, bool last, uint64& start, uint64& length)
+{
+    if (buffer.Empty())
+        return false;
+
+    switch (this->type)
+    {
+    case Type::Bytes:
+        if (FindBytes(buffer.GetData(), buffer.GetLength(), last, start))
+        {
+            length = this->value.size();
+            return true;
+        }
+        return false;
+    case Type::Regex:
+        return FindRegex(buffer, last, start, length);
+    case Type::UnicodeRegex:
+    {
+        uint64 s, l;
+        if (FindRegex(ConvertToUTF8(buffer), last, s, l) == false)
+            return false;
+        start  = this->offsets[s];
+        length = this->offsets[s + l] - start;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+void SearchEngine::FindAll(BufferView buffer, uint64 from, std::vector<std::pair<uint64, uint64>>& matches)
+{
+    if (from >= buffer.GetLength())
+        return;
+
+    const auto first = matches.size();
+    const BufferView part(buffer.GetData() + from, buffer.GetLength() - from);
+    switch (this->type)
+    {
+    case Type::Bytes:
+    {
+        const auto patternSize = static_cast<uint64>(this->value.size());
+        uint64 position, next = 0;
+        while (FindBytes(part.GetData() + next, part.GetLength() - next, false, position))
+        {
+            matches.emplace_back(next + position, patternSize);
+            next += position + patternSize;
+        }
+        break;
+    }
+    case Type::Regex:
+        FindAllRegex(part, matches);
+        break;
+    case Type::UnicodeRegex:
+        FindAllRegex(ConvertToUTF8(part), matches);
+        for (auto idx = first; idx < matches.size(); idx++)
+        {
+            auto& [start, length] = matches[idx];
+            const auto end        = this->offsets[start + length];
+            start                 = this->offsets[start];
+            length                = end - start;
+        }
+        break;
+    default:
+        return;
+    }
+    for (auto idx = first; idx < matches.size(); idx++)
+        matches[idx].first += from;
+}
+} // namespace GView::View::BufferViewer
@@ -66,6 +66,26 @@ void Settings::SetPositionToColorCallback(Reference<PositionToColorInterface> cb
     ((SettingsData*) (this->data))->positionToColorCallback = cbk;
 }
 
+void PositionToColorInterface::GetColorsForBuffer(uint64 offset, BufferView buf, uint32 size, std::vector<BufferColor>& runs)
+{
+    // every byte gets the same 16 bytes window that GetColorForBuffer was always called with
+    constexpr uint32 WINDOW_SIZE = 16;
+
+    runs.clear();
+    BufferColor color;
+    size = std::min<>(size, static_cast<uint32>(buf.GetLength()));
+    for (auto idx = 0U; idx < size; idx++) {
+        if (!runs.empty() && offset + idx <= runs.back().end) {
+            continue;
+        }
+        color.Reset();
+        const auto window = BufferView(buf.GetData() + idx, std::min<>(WINDOW_SIZE, static_cast<uint32>(buf.GetLength()) - idx));
+        if (GetColorForBuffer(offset + idx, window, color) && color.IsValue()) {
+            runs.push_back(color);
+        }
+    }
+}
+
 void Settings::SetEntryPointOffset(uint64 offset)
 {
     ((SettingsData*) (this->data))->entryPointOffset = offset;
@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <fstream>
 
 #include "DissasmCache.hpp"
 #include "DissasmViewer.hpp"
@@ -7,24 +8,55 @@
 using namespace GView::View::DissasmViewer;
 using namespace AppCUI::Input;
 
-void DissasmCache::ClearCache(bool forceClear)
+constexpr uint64 FINGERPRINT_SAMPLED_PAGES = 16;
+constexpr uint64 FINGERPRINT_PAGE_SIZE     = 0x1000;
+constexpr uint64 MAX_CACHE_FILE_SIZE       = 0xFFFFFFFF;
+
+static_assert(sizeof(DissasmFunctionsTable::Function) == 12);
+static_assert(sizeof(DissasmFunctionsTable::BasicBlock) == 8);
+static_assert(sizeof(DissasmFunctionsTable::Branch) == 16);
+
+static inline uint64 AlignCacheOffset(uint64 offset)
 {
-    if (!hasCache && !forceClear)
-        return;
-    zonesData.clear();
-    if (cacheFile.is_open())
-        cacheFile.close();
-    zonesData.clear();
+    return (offset + 7) & ~static_cast<uint64>(7);
 }
 
-bool DissasmCache::AddRegion(std::string regionName, const AppCUI::uint8* data, AppCUI::uint32 size)
+// the first and the last page are always hashed
+bool DissasmCache::ComputeFingerprint(Reference<GView::Object> obj, DissasmCacheFingerprint& fingerprint)
 {
-    if (zonesData.contains(regionName))
+    auto& cache          = obj->GetData();
+    fingerprint.fileSize = cache.GetSize();
+
+    std::error_code err;
+    const auto objPath        = obj->GetPath();
+    const auto lastWriteTime  = std::filesystem::last_write_time(std::filesystem::path(objPath.begin(), objPath.end()), err);
+    fingerprint.lastWriteTime = err ? 0 : static_cast<uint64>(lastWriteTime.time_since_epoch().count());
+
+    GView::Hashes::CRC64 crc64{};
+    if (!crc64.Init(GView::Hashes::CRC64Type::ECMA_182))
         return false;
-    DissasmCacheEntry entry = { std::make_unique<uint8[]>(size), size };
-    memcpy(entry.data.get(), data, size);
-    zonesData[std::move(regionName)] = std::move(entry);
-    return true;
+    const auto pagesCount = std::min<uint64>(FINGERPRINT_SAMPLED_PAGES, (fingerprint.fileSize + FINGERPRINT_PAGE_SIZE - 1) / FINGERPRINT_PAGE_SIZE);
+    const auto lastPage   = fingerprint.fileSize - std::min<uint64>(fingerprint.fileSize, FINGERPRINT_PAGE_SIZE);
+    for (uint64 index = 0; index < pagesCount; index++) {
+        const auto offset = pagesCount == 1 ? 0 : lastPage * index / (pagesCount - 1);
+        const auto page   = cache.Get(offset, static_cast<uint32>(std::min<uint64>(FINGERPRINT_PAGE_SIZE, fingerprint.fileSize - offset)), true);
+        if (!page.IsValid() || !crc64.Update(page))
+            return false;
+    }
+    return crc64.Final(fingerprint.sampledPagesHash);
+}
+
+void DissasmCache::ClearCache(bool forceClear)
+{
+    if (!hasCache && !forceClear)
+        return;
+    hasCache = false;
+    header   = nullptr;
+    data     = nullptr;
+    dataSize = 0;
+    mappedFile.reset();
+    fileBuffer.clear();
+    fileBuffer.shrink_to_fit();
 }
 
 std::filesystem::path DissasmCache::GetCacheFilePath(std::u16string_view fileLocation, bool cacheSameLocationAsAnalyzedFile)
@@ -37,104 +69,239 @@ std::filesystem::path DissasmCache::GetCacheFilePath(std::u16string_view fileLoc
     return path;
 }
 
-bool DissasmCache::SaveCacheFile(std::u16string_view location)
+bool DissasmCache::SaveCacheFile(std::u16string_view location, const std::vector<uint8>& content)
 {
-    if (zonesData.empty())
+    if (content.empty())
         return false;
     const std::filesystem::path filePath(location.begin(), location.end());
-    cacheFile.open(filePath, std::ios::out | std::ios::binary);
+    std::ofstream cacheFile(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
     if (!cacheFile.is_open())
         return false;
-    const uint32 zonesCount = (uint32) zonesData.size();
-    uint32 entrySize;
-    cacheFile.write((const char*) &zonesCount, sizeof(zonesCount));
-    for (auto& [name, entry] : zonesData) {
-        entrySize = (uint32) name.size();
-        cacheFile.write((const char*) &entrySize, sizeof(entrySize));
-        cacheFile.write(name.data(), entrySize);
-
-        entrySize = entry.size;
-        cacheFile.write((const char*) &entrySize, sizeof(entrySize));
-        cacheFile.write(reinterpret_cast<const char*>(entry.data.get()), entry.size);
-    }
-    cacheFile.close();
-    return true;
+    cacheFile.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    return cacheFile.good();
 }
 
 bool DissasmCache::LoadCacheFile(std::u16string_view location)
 {
+    ClearCache(true);
     const std::filesystem::path filePath(location.begin(), location.end());
-    cacheFile.open(filePath, std::ios::in | std::ios::binary);
-    if (!cacheFile.is_open())
-        return false;
-    cacheFile.seekg(0, std::ios::end);
-    const auto fileSize = cacheFile.tellg();
-    cacheFile.seekg(0, std::ios::beg);
-    if (fileSize == -1)
+    std::error_code err;
+    const auto fileSize = std::filesystem::file_size(filePath, err);
+    if (err || fileSize < sizeof(DissasmCacheHeader) || fileSize > MAX_CACHE_FILE_SIZE)
         return false;
-    if (fileSize == 0)
-        return true;
-    std::vector<uint8> buffer;
-    buffer.resize((uint32) fileSize);
-    cacheFile.read(reinterpret_cast<char*>(buffer.data()), fileSize);
-    cacheFile.close();
-
-    if (fileSize < sizeof(uint32))
-        return false;
-
-    uint32 offset     = 0;
-    uint32 zonesCount = 0;
-    memcpy(&zonesCount, buffer.data() + offset, sizeof(zonesCount));
-    offset += sizeof(zonesCount);
 
-    while (offset < buffer.size()) {
-        if (zonesCount-- == 0)
+    // the records are read in place => the file is mapped (or read at once if it can not be mapped)
+    // the arrays of a code zone are copied in the zone when it is loaded (TryLoadDataFromCache)
+    auto file  = std::make_unique<AppCUI::OS::File>();
+    auto cache = std::make_unique<GView::Utils::DataCache>();
+    if (file->OpenRead(filePath) && cache->Init(std::move(file), 0) && cache->MapFile(filePath)) {
+        const auto view = cache->Get(0, static_cast<uint32>(fileSize), true);
+        if (!view.IsValid())
             return false;
-        uint32 entrySize;
-        memcpy(&entrySize, buffer.data() + offset, sizeof(entrySize));
-        offset += sizeof(entrySize);
-        if (offset + entrySize > buffer.size())
+        data       = view.GetData();
+        dataSize   = view.GetLength();
+        mappedFile = std::move(cache);
+    } else {
+        std::ifstream cacheFile(filePath, std::ios::in | std::ios::binary);
+        if (!cacheFile.is_open())
             return false;
-        const auto entryDataName = buffer.data() + offset;
-        offset += entrySize;
-        if (offset > buffer.size())
+        fileBuffer.resize(static_cast<size_t>(fileSize));
+        if (!cacheFile.read(reinterpret_cast<char*>(fileBuffer.data()), static_cast<std::streamsize>(fileSize)))
             return false;
-        std::string_view entryName = { (const char*) entryDataName, entrySize };
+        data     = fileBuffer.data();
+        dataSize = fileBuffer.size();
+    }
 
-        if (offset + sizeof(uint32) > buffer.size())
-            return false;
-        memcpy(&entrySize, buffer.data() + offset, sizeof(entrySize));
-        offset += sizeof(entrySize);
-        if (offset + entrySize > buffer.size())
-            return false;
-        const auto entryData = buffer.data() + offset;
-        offset += entrySize;
-        if (offset > buffer.size())
-            return false;
+    const auto fileHeader = reinterpret_cast<const DissasmCacheHeader*>(data);
+    if (fileHeader->magic != DISSASM_CACHE_MAGIC || fileHeader->version != DISSASM_CACHE_VERSION)
+        return false;
+    if (!GetArray<DissasmCacheDisassemblyZone>({ fileHeader->disassemblyZonesOffset, fileHeader->disassemblyZonesCount }))
+        return false;
+    if (!GetArray<DissasmCacheCodeZone>({ fileHeader->codeZonesOffset, fileHeader->codeZonesCount }))
+        return false;
+    if (!GetArray<char>({ fileHeader->labelsOffset, fileHeader->labelsSize }) || !GetArray<char>({ fileHeader->commentsOffset, fileHeader->commentsSize }))
+        return false;
+    header = fileHeader;
+    return true;
+}
 
-        auto newCacheEntry = DissasmCacheEntry{ std::make_unique<uint8[]>(entrySize), entrySize };
-        memcpy(newCacheEntry.data.get(), entryData, entrySize);
-        zonesData.emplace(entryName, std::move(newCacheEntry));
+const DissasmCacheDisassemblyZone* DissasmCache::GetDisassemblyZones() const
+{
+    if (!header)
+        return nullptr;
+    return GetArray<DissasmCacheDisassemblyZone>({ header->disassemblyZonesOffset, header->disassemblyZonesCount });
+}
+
+const DissasmCacheCodeZone* DissasmCache::FindCodeZone(uint64 startLineIndex) const
+{
+    if (!header)
+        return nullptr;
+    const auto zones = GetArray<DissasmCacheCodeZone>({ header->codeZonesOffset, header->codeZonesCount });
+    const auto end   = zones + header->codeZonesCount;
+    const auto it    = std::lower_bound(zones, end, startLineIndex, [](const DissasmCacheCodeZone& zone, uint64 value) { return zone.startLineIndex < value; });
+    if (it == end || it->startLineIndex != startLineIndex)
+        return nullptr;
+    return it;
+}
+
+bool DissasmCache::GetLabel(const DissasmCacheString& name, std::string_view& label) const
+{
+    if (!header || static_cast<uint64>(name.offset) + name.size > header->labelsSize)
+        return false;
+    label = { reinterpret_cast<const char*>(data + header->labelsOffset + name.offset), name.size };
+    return true;
+}
+
+bool DissasmCache::GetComment(const DissasmCacheString& text, std::string_view& comment) const
+{
+    if (!header || static_cast<uint64>(text.offset) + text.size > header->commentsSize)
+        return false;
+    comment = { reinterpret_cast<const char*>(data + header->commentsOffset + text.offset), text.size };
+    return true;
+}
+
+template <typename T>
+DissasmCacheArray DissasmCacheWriter::AddArray(const T* values, size_t count)
+{
+    const DissasmCacheArray array = { arrays.size(), count };
+    if (count > 0) {
+        const auto bytes = reinterpret_cast<const uint8*>(values);
+        arrays.insert(arrays.end(), bytes, bytes + count * sizeof(T));
+        arrays.resize(AlignCacheOffset(arrays.size()));
     }
+    return array;
+}
+
+bool DissasmCacheWriter::AddString(std::string& pool, std::string_view value, DissasmCacheString& result)
+{
+    if (pool.size() + value.size() > MAX_CACHE_FILE_SIZE)
+        return false;
+    result = { static_cast<uint32>(pool.size()), static_cast<uint32>(value.size()) };
+    pool.append(value);
     return true;
 }
 
-bool DisassemblyZone::ToBuffer(std::vector<uint8>& buffer, Reference<GView::Object> obj) const
+void DissasmCacheWriter::AddDisassemblyZone(uint64 start, const DisassemblyZone& zone)
+{
+    disassemblyZones.push_back({ start, zone.startingZonePoint, zone.size, zone.entryPoint, static_cast<uint32>(zone.language), 0 });
+}
+
+bool DissasmCacheWriter::AddCodeZone(const DissasmCodeZone& zone)
 {
-    Hashes::OpenSSLHash hash(Hashes::OpenSSLHashKind::Md5);
-    const auto zoneData = obj->GetData().Get(startingZonePoint, (uint32) size, false);
-    if (zoneData.Empty())
+    // the annotations of a zone split in collapsible zones are spread over them => only the zones that were not split are saved
+    if (!zone.isInit || !zone.dissasmType.internalTypes.empty() || zone.cachedCodeOffsets.empty())
         return false;
-    if (!hash.Update(zoneData.GetData(), (uint32) zoneData.GetLength()))
+
+    std::vector<DissasmCacheComment> comments;
+    comments.reserve(zone.dissasmType.commentsData.comments.size());
+    for (const auto& [line, text] : zone.dissasmType.commentsData.comments) {
+        auto& comment = comments.emplace_back(DissasmCacheComment{ line, {} });
+        if (!AddString(this->comments, text, comment.text))
+            return false;
+    }
+    std::vector<DissasmCacheAnnotation> annotations;
+    annotations.reserve(zone.dissasmType.annotations.size());
+    for (const auto& [line, details] : zone.dissasmType.annotations) {
+        auto& annotation = annotations.emplace_back(DissasmCacheAnnotation{ details.second, line, {}, 0 });
+        if (!AddString(labels, details.first, annotation.name))
+            return false;
+    }
+    std::vector<DissasmCacheCheckpoint> checkpoints;
+    checkpoints.reserve(zone.cachedCodeOffsets.size());
+    for (const auto& checkpoint : zone.cachedCodeOffsets)
+        checkpoints.push_back({ checkpoint.offset, checkpoint.line, 0 });
+
+    DissasmCacheCodeZone record = {};
+    record.startLineIndex       = zone.startLineIndex;
+    record.startingZonePoint    = zone.zoneDetails.startingZonePoint;
+    record.size                 = zone.zoneDetails.size;
+    record.entryPoint           = zone.zoneDetails.entryPoint;
+    record.linesCount           = zone.linesIndex.GetLinesCount();
+    record.totalLines           = zone.dissasmType.indexZoneEnd - 2; // InitZone: the lines, +1 for the title, +1 for the end
+    record.comments             = AddArray(comments.data(), comments.size());
+    record.annotations          = AddArray(annotations.data(), annotations.size());
+    record.checkpoints          = AddArray(checkpoints.data(), checkpoints.size());
+    record.anchors              = AddArray(zone.linesIndex.GetAnchors().data(), zone.linesIndex.GetAnchors().size());
+    record.sizes                = AddArray(zone.linesIndex.GetSizes().data(), zone.linesIndex.GetSizes().size());
+    record.functions            = AddArray(zone.functionsTable.functions.data(), zone.functionsTable.functions.size());
+    record.blocks               = AddArray(zone.functionsTable.blocks.data(), zone.functionsTable.blocks.size());
+    record.branches             = AddArray(zone.functionsTable.branches.data(), zone.functionsTable.branches.size());
+    codeZones.push_back(record);
+    return true;
+}
+
+bool DissasmCacheWriter::AddCachedCodeZone(const DissasmCache& cache, const DissasmCacheCodeZone& zone)
+{
+    const auto comments    = cache.GetArray<DissasmCacheComment>(zone.comments);
+    const auto annotations = cache.GetArray<DissasmCacheAnnotation>(zone.annotations);
+    const auto checkpoints = cache.GetArray<DissasmCacheCheckpoint>(zone.checkpoints);
+    const auto anchors     = cache.GetArray<uint64>(zone.anchors);
+    const auto sizes       = cache.GetArray<uint8>(zone.sizes);
+    const auto functions   = cache.GetArray<DissasmFunctionsTable::Function>(zone.functions);
+    const auto blocks      = cache.GetArray<DissasmFunctionsTable::BasicBlock>(zone.blocks);
+    const auto branches    = cache.GetArray<DissasmFunctionsTable::Branch>(zone.branches);
+    if (!comments || !annotations || !checkpoints || !anchors || !sizes || !functions || !blocks || !branches)
         return false;
-    const auto hashValue = hash.GetHexValue();
-    buffer.reserve(hashValue.size() + sizeof(DisassemblyZone));
-    buffer.clear();
-    buffer.insert(buffer.end(), hashValue.data(), hashValue.data() + hashValue.size());
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8*>(this), reinterpret_cast<const uint8*>(this) + sizeof(DisassemblyZone));
+
+    // the strings are moved to the pools of the new file
+    std::string_view value;
+    std::vector<DissasmCacheComment> newComments(comments, comments + zone.comments.count);
+    for (auto& comment : newComments) {
+        if (!cache.GetComment(comment.text, value) || !AddString(this->comments, value, comment.text))
+            return false;
+    }
+    std::vector<DissasmCacheAnnotation> newAnnotations(annotations, annotations + zone.annotations.count);
+    for (auto& annotation : newAnnotations) {
+        if (!cache.GetLabel(annotation.name, value) || !AddString(labels, value, annotation.name))
+            return false;
+    }
+
+    DissasmCacheCodeZone record = zone;
+    record.comments             = AddArray(newComments.data(), newComments.size());
+    record.annotations          = AddArray(newAnnotations.data(), newAnnotations.size());
+    record.checkpoints          = AddArray(checkpoints, zone.checkpoints.count);
+    record.anchors              = AddArray(anchors, zone.anchors.count);
+    record.sizes                = AddArray(sizes, zone.sizes.count);
+    record.functions            = AddArray(functions, zone.functions.count);
+    record.blocks               = AddArray(blocks, zone.blocks.count);
+    record.branches             = AddArray(branches, zone.branches.count);
+    codeZones.push_back(record);
     return true;
 }
 
+void DissasmCacheWriter::Build(const DissasmCacheFingerprint& fingerprint, std::vector<uint8>& output)
+{
+    std::sort(disassemblyZones.begin(), disassemblyZones.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+    std::sort(codeZones.begin(), codeZones.end(), [](const auto& a, const auto& b) { return a.startLineIndex < b.startLineIndex; });
+
+    DissasmCacheHeader header     = {};
+    header.magic                  = DISSASM_CACHE_MAGIC;
+    header.version                = DISSASM_CACHE_VERSION;
+    header.fingerprint            = fingerprint;
+    header.disassemblyZonesCount  = static_cast<uint32>(disassemblyZones.size());
+    header.codeZonesCount         = static_cast<uint32>(codeZones.size());
+    header.disassemblyZonesOffset = AlignCacheOffset(sizeof(DissasmCacheHeader));
+    header.codeZonesOffset        = header.disassemblyZonesOffset + disassemblyZones.size() * sizeof(DissasmCacheDisassemblyZone);
+    const auto arraysOffset       = header.codeZonesOffset + codeZones.size() * sizeof(DissasmCacheCodeZone);
+    header.labelsOffset           = arraysOffset + arrays.size();
+    header.labelsSize             = labels.size();
+    header.commentsOffset         = header.labelsOffset + labels.size();
+    header.commentsSize           = comments.size();
+
+    for (auto& zone : codeZones) {
+        for (auto array : { &zone.comments, &zone.annotations, &zone.checkpoints, &zone.anchors, &zone.sizes, &zone.functions, &zone.blocks, &zone.branches })
+            array->offset += arraysOffset;
+    }
+
+    output.resize(static_cast<size_t>(header.commentsOffset + comments.size()));
+    memcpy(output.data(), &header, sizeof(header));
+    std::copy(disassemblyZones.begin(), disassemblyZones.end(), reinterpret_cast<DissasmCacheDisassemblyZone*>(output.data() + header.disassemblyZonesOffset));
+    std::copy(codeZones.begin(), codeZones.end(), reinterpret_cast<DissasmCacheCodeZone*>(output.data() + header.codeZonesOffset));
+    std::copy(arrays.begin(), arrays.end(), output.begin() + arraysOffset);
+    std::copy(labels.begin(), labels.end(), output.begin() + header.labelsOffset);
+    std::copy(comments.begin(), comments.end(), output.begin() + header.commentsOffset);
+}
+
 void Instance::LoadCacheData()
 {
     if (!config.EnableDeepScanDissasmOnStart)
@@ -155,174 +322,144 @@ void Instance::SaveCacheData()
 {
     if (!config.EnableDeepScanDissasmOnStart)
         return;
-    cacheData.ClearCache(); // TODO: optimise this better? maybe clear cache after loading
-    if (!settings->SaveToCache(cacheData, obj))
+    DissasmCacheWriter writer;
+    if (!settings->SaveToCache(writer))
         return;
 
-    std::vector<uint8> buffer;
-    LocalString<64> zoneName;
     for (auto& zone : settings->parseZones) {
         if (zone->zoneType != DissasmParseZoneType::DissasmCodeParseZone)
             continue;
-        const auto* dissasmZone = (DissasmCodeZone*) zone.get();
-        if (!dissasmZone->ToBuffer(buffer))
-            return;
-        zoneName.SetFormat("DissasmParseZoneType.%llu", zone->startLineIndex);
-        if (!cacheData.AddRegion(zoneName.GetText(), buffer.data(), (uint32) buffer.size()))
+        // a zone that can not be saved now keeps the data from the current cache file
+        if (writer.AddCodeZone(*static_cast<const DissasmCodeZone*>(zone.get())))
+            continue;
+        const auto cachedZone = cacheData.FindCodeZone(zone->startLineIndex);
+        if (cachedZone && !writer.AddCachedCodeZone(cacheData, *cachedZone))
             return;
     }
 
+    DissasmCacheFingerprint fingerprint;
+    if (!DissasmCache::ComputeFingerprint(obj, fingerprint))
+        return;
+    std::vector<uint8> content;
+    writer.Build(fingerprint, content);
+
+    // the cache file is mapped => it is released before it is replaced and loaded again after
+    cacheData.ClearCache(true);
     const std::filesystem::path path = DissasmCache::GetCacheFilePath(obj->GetPath(), config.CacheSameLocationAsAnalyzedFile);
-    cacheData.SaveCacheFile(path.u16string());
+    if (DissasmCache::SaveCacheFile(path.u16string(), content))
+        LoadCacheData();
 }
 
-bool SettingsData::SaveToCache(DissasmCache& cache, Reference<GView::Object> obj)
+bool SettingsData::SaveToCache(DissasmCacheWriter& writer)
 {
-    std::vector<uint8> buffer;
-    LocalString<64> zoneName;
-    for (auto& [start, zone] : disassemblyZones) {
-        if (!zone.ToBuffer(buffer, obj))
-            return false;
-        zoneName.SetFormat("DisassemblyZone.%llu", start);
-        if (!cache.AddRegion(zoneName.GetText(), buffer.data(), (uint32) buffer.size()))
-            return false;
-    }
+    for (auto& [start, zone] : disassemblyZones)
+        writer.AddDisassemblyZone(start, zone);
     return true;
 }
 
 bool SettingsData::ValidateCacheData(DissasmCache& cache, Reference<GView::Object> obj)
 {
-    std::vector<uint8> buffer;
-    LocalString<64> zoneName;
-    for (auto& [start, zone] : disassemblyZones) {
-        zoneName.SetFormat("DisassemblyZone.%llu", start);
-        if (!cache.zonesData.contains(zoneName.GetText()))
-            return false;
-        const auto& entry = cache.zonesData[zoneName.GetText()];
-        if (!zone.ToBuffer(buffer, obj))
-            return false;
-        if (entry.size != buffer.size())
-            return false;
-        auto data1 = entry.data.get();
-        auto data2 = buffer.data();
-        if (memcmp(entry.data.get(), buffer.data(), buffer.size()) != 0)
-            return false;
-    }
-    return true;
-}
-
-bool DissasmCodeZone::ToBuffer(std::vector<uint8>& buffer) const
-{
-    uint32 reserveSize = 0;
-    for (const auto& comment : dissasmType.commentsData.comments) {
-        reserveSize += sizeof(comment.first) + sizeof(uint32) + comment.second.size();
-    }
-    for (const auto& annotation : dissasmType.annotations) {
-        reserveSize += sizeof(annotation.first) + sizeof(uint32) + annotation.second.first.size() + sizeof(annotation.second.second);
-    }
-    buffer.reserve(reserveSize);
-
-    // comments
-    uint32 entriesCount = (uint32) dissasmType.commentsData.comments.size();
-    uint32 entryStringSizeCount;
-    buffer.insert(buffer.end(), (const char*) &entriesCount, (const char*) &entriesCount + sizeof(entriesCount));
-    for (const auto& comment : dissasmType.commentsData.comments) {
-        buffer.insert(buffer.end(), (const char*) &comment.first, (const char*) &comment.first + sizeof(comment.first));
-        entryStringSizeCount = (uint32) comment.second.size();
-        buffer.insert(buffer.end(), (const char*) &entryStringSizeCount, (const char*) &entryStringSizeCount + sizeof(entryStringSizeCount));
-        buffer.insert(buffer.end(), comment.second.data(), comment.second.data() + entryStringSizeCount);
-    }
-
-    // annotations
-    entriesCount = (uint32) dissasmType.annotations.size();
-    buffer.insert(buffer.end(), (const char*) &entriesCount, (const char*) &entriesCount + sizeof(entriesCount));
-    for (const auto& annotation : dissasmType.annotations) {
-        buffer.insert(buffer.end(), (const char*) &annotation.first, (const char*) &annotation.first + sizeof(annotation.first));
-
-        entryStringSizeCount = (uint32) annotation.second.first.size();
-        buffer.insert(buffer.end(), (const char*) &entryStringSizeCount, (const char*) &entryStringSizeCount + sizeof(entryStringSizeCount));
-        buffer.insert(buffer.end(), annotation.second.first.data(), annotation.second.first.data() + entryStringSizeCount);
+    if (!cache.header)
+        return false;
+    DissasmCacheFingerprint fingerprint;
+    if (!DissasmCache::ComputeFingerprint(obj, fingerprint) || fingerprint != cache.header->fingerprint)
+        return false;
 
-        buffer.insert(buffer.end(), (const char*) &annotation.second.second, (const char*) &annotation.second.second + sizeof(annotation.second.second));
+    const auto cachedZones = cache.GetDisassemblyZones();
+    if (!cachedZones || cache.header->disassemblyZonesCount != disassemblyZones.size())
+        return false;
+    auto cachedZone = cachedZones;
+    for (const auto& [start, zone] : disassemblyZones) {
+        if (cachedZone->start != start || cachedZone->startingZonePoint != zone.startingZonePoint || cachedZone->size != zone.size ||
+            cachedZone->entryPoint != zone.entryPoint || cachedZone->language != static_cast<uint32>(zone.language))
+            return false;
+        cachedZone++;
     }
-
     return true;
 }
 
-bool DissasmCodeZone::TryLoadDataFromCache(DissasmCache& cache)
+bool DissasmCodeZone::TryLoadDataFromCache(DissasmCache& cache, uint32& totalLines)
 {
     if (!cache.hasCache)
-        return true;
-    if (zoneType != DissasmParseZoneType::DissasmCodeParseZone)
         return false;
-    LocalString<64> zoneName;
-    zoneName.SetFormat("DissasmParseZoneType.%llu", startLineIndex);
-
-    auto it = cache.zonesData.find(zoneName.GetText());
-    if (it == cache.zonesData.end())
+    const auto record = cache.FindCodeZone(startLineIndex);
+    if (!record || record->startingZonePoint != zoneDetails.startingZonePoint || record->size != zoneDetails.size ||
+        record->entryPoint != zoneDetails.entryPoint)
         return false;
-    auto dataPtr          = it->second.data.get();
-    const auto dataPtrEnd = dataPtr + it->second.size;
 
-    if (dataPtr + sizeof(uint32) > dataPtrEnd)
+    const auto comments    = cache.GetArray<DissasmCacheComment>(record->comments);
+    const auto annotations = cache.GetArray<DissasmCacheAnnotation>(record->annotations);
+    const auto checkpoints = cache.GetArray<DissasmCacheCheckpoint>(record->checkpoints);
+    const auto anchors     = cache.GetArray<uint64>(record->anchors);
+    const auto sizes       = cache.GetArray<uint8>(record->sizes);
+    const auto functions   = cache.GetArray<DissasmFunctionsTable::Function>(record->functions);
+    const auto blocks      = cache.GetArray<DissasmFunctionsTable::BasicBlock>(record->blocks);
+    const auto branches    = cache.GetArray<DissasmFunctionsTable::Branch>(record->branches);
+    if (!comments || !annotations || !checkpoints || !anchors || !sizes || !functions || !blocks || !branches)
         return false;
-
-    std::vector<uint8> buffer;
-    buffer.reserve(512);
-
-    uint32 commentsCount = *(uint32*) dataPtr;
-    dataPtr += sizeof(uint32);
-
-    while (commentsCount > 0) {
-        if (dataPtr + sizeof(uint32) > dataPtrEnd)
-            return false;
-        const uint32 offset = *(uint32*) dataPtr;
-        dataPtr += sizeof(uint32);
-
-        if (dataPtr + sizeof(uint32) > dataPtrEnd)
+    const auto linesCount = record->linesCount;
+    if (linesCount == 0 || record->sizes.count != linesCount || record->checkpoints.count == 0 ||
+        record->anchors.count != (static_cast<uint64>(linesCount) + DissasmLinesIndex::ANCHOR_LINES - 1) / DissasmLinesIndex::ANCHOR_LINES)
+        return false;
+    if (record->totalLines != static_cast<uint64>(linesCount) + record->annotations.count)
+        return false;
+    for (uint64 index = 0; index < record->annotations.count; index++) {
+        if (annotations[index].line >= record->totalLines || (index > 0 && annotations[index].line <= annotations[index - 1].line))
             return false;
-        const uint32 commLen = *(uint32*) dataPtr;
-        if (dataPtr + commLen > dataPtrEnd)
+    }
+    for (uint64 index = 0; index < record->comments.count; index++) {
+        if (comments[index].line >= record->totalLines || (index > 0 && comments[index].line <= comments[index - 1].line))
             return false;
-        dataPtr += sizeof(uint32);
-        buffer.clear();
-        buffer.insert(buffer.end(), dataPtr, dataPtr + commLen);
-        dataPtr += commLen;
-
-        dissasmType.commentsData.comments[offset] = std::string((const char*)buffer.data(), commLen);
-        --commentsCount;
     }
-
-    if (dataPtr + sizeof(uint32) > dataPtrEnd)
+    // the checkpoints are file offsets (the first one is the first asm line), the anchors are relative to the first asm line
+    const uint64 zoneEnd = record->startingZonePoint + record->size;
+    if (checkpoints[0].line != 0 || checkpoints[0].offset < record->startingZonePoint)
         return false;
-    uint32 annotationsCount = *(uint32*) dataPtr;
-    dataPtr += sizeof(uint32);
-    while (annotationsCount > 0) {
-        if (dataPtr + sizeof(uint32) > dataPtrEnd)
+    for (uint64 index = 0; index < record->checkpoints.count; index++) {
+        if (checkpoints[index].offset > zoneEnd || checkpoints[index].line > linesCount)
             return false;
-        const uint32 offset = *(uint32*) dataPtr;
-        dataPtr += sizeof(uint32);
-
-        if (dataPtr + sizeof(uint32) > dataPtrEnd)
+        if (index > 0 && (checkpoints[index].offset <= checkpoints[index - 1].offset || checkpoints[index].line <= checkpoints[index - 1].line))
             return false;
-        const uint32 annLen = *(uint32*) dataPtr;
-        if (dataPtr + annLen > dataPtrEnd)
+    }
+    for (uint64 index = 0; index < record->anchors.count; index++) {
+        if (anchors[index] >= zoneEnd - checkpoints[0].offset || (index > 0 && anchors[index] <= anchors[index - 1]))
             return false;
-        dataPtr += sizeof(uint32);
-
-        buffer.clear();
-        buffer.insert(buffer.end(), dataPtr, dataPtr + annLen);
-        dataPtr += annLen;
-
-        if (dataPtr + sizeof(uint64) > dataPtrEnd)
+    }
+    for (uint64 index = 0; index < record->functions.count; index++) {
+        if (static_cast<uint64>(functions[index].firstBlock) + functions[index].blocksCount > record->blocks.count)
             return false;
-        const uint64 annValue = *(uint64*) dataPtr;
-        dataPtr += sizeof(uint64);
-        --annotationsCount;
+    }
+    for (uint64 index = 0; index < record->branches.count; index++) {
+        if (branches[index].line >= linesCount || (index > 0 && branches[index].line <= branches[index - 1].line))
+            return false;
+    }
 
-        std::string annName((const char*)buffer.data(), annLen);
-        dissasmType.annotations[offset] = { std::move(annName), annValue };
+    // the zone is changed only if every record is valid
+    std::string_view value;
+    decltype(dissasmType.commentsData.comments) newComments;
+    for (uint64 index = 0; index < record->comments.count; index++) {
+        if (!cache.GetComment(comments[index].text, value))
+            return false;
+        newComments.emplace_hint(newComments.end(), comments[index].line, value);
+    }
+    AnnotationContainer newAnnotations;
+    for (uint64 index = 0; index < record->annotations.count; index++) {
+        if (!cache.GetLabel(annotations[index].name, value))
+            return false;
+        newAnnotations.emplace_hint(newAnnotations.end(), annotations[index].line, AnnotationDetails{ std::string(value), annotations[index].value });
     }
 
+    cachedCodeOffsets.clear();
+    cachedCodeOffsets.reserve(record->checkpoints.count);
+    for (uint64 index = 0; index < record->checkpoints.count; index++)
+        cachedCodeOffsets.push_back({ checkpoints[index].offset, checkpoints[index].line });
+    linesIndex.Assign(anchors, record->anchors.count, sizes, linesCount);
+    functionsTable.functions.assign(functions, functions + record->functions.count);
+    functionsTable.blocks.assign(blocks, blocks + record->blocks.count);
+    functionsTable.branches.assign(branches, branches + record->branches.count);
+    dissasmType.commentsData.comments = std::move(newComments);
+    dissasmType.annotations           = std::move(newAnnotations);
+    annotationsLines.clear();
+    totalLines = record->totalLines;
     return true;
-}
\ No newline at end of file
+}
@@ -1,30 +1,158 @@
 #pragma once
-#include <fstream>
-#include <unordered_map>
+#include <filesystem>
+#include <string_view>
 
-#include <AppCUI/include/AppCUI.hpp>
+#include "GView.hpp"
 
 namespace GView::View::DissasmViewer
 {
-struct DissasmCacheEntry
-{
-    std::unique_ptr<AppCUI::uint8[]> data;
-    AppCUI::uint32 size;
+struct DisassemblyZone;
+struct DissasmCodeZone;
+
+/*
+    The cache file is used in place (memory mapped when possible), every record has a fixed layout:
+    - DissasmCacheHeader: the fingerprint of the analyzed file and where the other sections are
+    - the disassembly zones table (sorted by start) and the code zones table (sorted by startLineIndex)
+    - the arrays of every code zone (comments, annotations, offsets checkpoints, lines index, functions, blocks and branches)
+    - the labels pool (the names of the annotations) and the comments pool
+    Every section and array starts at an offset aligned to 8 bytes (the values are stored as little endian).
+*/
+constexpr uint32 DISSASM_CACHE_MAGIC   = 0x43445647; // "GVDC"
+constexpr uint32 DISSASM_CACHE_VERSION = 2;
+
+struct DissasmCacheFingerprint {
+    uint64 fileSize;
+    uint64 lastWriteTime;
+    uint64 sampledPagesHash; // CRC64 of some pages spread over the file
+
+    bool operator==(const DissasmCacheFingerprint& other) const = default;
+};
+
+struct DissasmCacheHeader {
+    uint32 magic;
+    uint32 version;
+    DissasmCacheFingerprint fingerprint;
+    uint32 disassemblyZonesCount;
+    uint32 codeZonesCount;
+    uint64 disassemblyZonesOffset;
+    uint64 codeZonesOffset;
+    uint64 labelsOffset;
+    uint64 labelsSize;
+    uint64 commentsOffset;
+    uint64 commentsSize;
+};
+
+struct DissasmCacheArray {
+    uint64 offset; // from the start of the file
+    uint64 count;
+};
+
+struct DissasmCacheString {
+    uint32 offset; // from the start of the pool
+    uint32 size;
+};
+
+struct DissasmCacheDisassemblyZone {
+    uint64 start;
+    uint64 startingZonePoint;
+    uint64 size;
+    uint64 entryPoint;
+    uint32 language;
+    uint32 reserved;
+};
+
+struct DissasmCacheComment {
+    uint32 line;
+    DissasmCacheString text; // from the comments pool
 };
 
+struct DissasmCacheAnnotation {
+    uint64 value;
+    uint32 line;
+    DissasmCacheString name; // from the labels pool
+    uint32 reserved;
+};
+
+struct DissasmCacheCheckpoint {
+    uint64 offset;
+    uint32 line;
+    uint32 reserved;
+};
+
+struct DissasmCacheCodeZone {
+    uint64 startLineIndex;
+    uint64 startingZonePoint;
+    uint64 size;
+    uint64 entryPoint;
+    uint32 linesCount; // the asm lines from the lines index
+    uint32 totalLines; // the asm lines and the annotations (without the title)
+    DissasmCacheArray comments;    // DissasmCacheComment
+    DissasmCacheArray annotations; // DissasmCacheAnnotation
+    DissasmCacheArray checkpoints; // DissasmCacheCheckpoint
+    DissasmCacheArray anchors;     // uint64
+    DissasmCacheArray sizes;       // uint8
+    DissasmCacheArray functions;   // DissasmFunctionsTable::Function
+    DissasmCacheArray blocks;      // DissasmFunctionsTable::BasicBlock
+    DissasmCacheArray branches;    // DissasmFunctionsTable::Branch
+};
+
+static_assert(sizeof(DissasmCacheHeader) == 88);
+static_assert(sizeof(DissasmCacheDisassemblyZone) == 40);
+static_assert(sizeof(DissasmCacheComment) == 12);
+static_assert(sizeof(DissasmCacheAnnotation) == 24);
+static_assert(sizeof(DissasmCacheCheckpoint) == 16);
+static_assert(sizeof(DissasmCacheCodeZone) == 168);
+
 struct DissasmCache {
-    bool hasCache;
-    std::fstream cacheFile;
-    std::unordered_map<std::string, DissasmCacheEntry> zonesData;
+    bool hasCache{ false };
+    std::unique_ptr<GView::Utils::DataCache> mappedFile; // the cache file, if it could be memory mapped
+    std::vector<uint8> fileBuffer;                        // the content of the cache file, if it could not be mapped
+    const uint8* data{ nullptr };
+    uint64 dataSize{ 0 };
+    const DissasmCacheHeader* header{ nullptr };
 
     void ClearCache(bool forceClear = false);
 
+    // the size and the last write time of the file and a hash of some pages spread over it
+    static bool ComputeFingerprint(Reference<GView::Object> obj, DissasmCacheFingerprint& fingerprint);
     static std::filesystem::path GetCacheFilePath(std::u16string_view fileLocation, bool cacheSameLocationAsAnalyzedFile);
-    bool AddRegion(std::string regionName, const AppCUI::uint8* data, AppCUI::uint32 size);
-
-    bool SaveCacheFile(std::u16string_view location);
+    static bool SaveCacheFile(std::u16string_view location, const std::vector<uint8>& content);
     bool LoadCacheFile(std::u16string_view location);
+
+    // nullptr if the array is not inside the file
+    template <typename T>
+    const T* GetArray(const DissasmCacheArray& array) const
+    {
+        if (array.count == 0)
+            return reinterpret_cast<const T*>(data);
+        if (array.offset % alignof(T) != 0 || array.offset > dataSize || array.count > (dataSize - array.offset) / sizeof(T))
+            return nullptr;
+        return reinterpret_cast<const T*>(data + array.offset);
+    }
+    const DissasmCacheDisassemblyZone* GetDisassemblyZones() const;
+    const DissasmCacheCodeZone* FindCodeZone(uint64 startLineIndex) const;
+    bool GetLabel(const DissasmCacheString& name, std::string_view& label) const;
+    bool GetComment(const DissasmCacheString& text, std::string_view& comment) const;
 };
 
+// builds the content of a cache file (the records are added in memory and written at once)
+class DissasmCacheWriter
+{
+    std::vector<DissasmCacheDisassemblyZone> disassemblyZones;
+    std::vector<DissasmCacheCodeZone> codeZones;
+    std::vector<uint8> arrays; // the offsets of the arrays are relative to this section until Build
+    std::string labels;
+    std::string comments;
+
+    template <typename T>
+    DissasmCacheArray AddArray(const T* values, size_t count);
+    bool AddString(std::string& pool, std::string_view value, DissasmCacheString& result);
+
+  public:
+    void AddDisassemblyZone(uint64 start, const DisassemblyZone& zone);
+    bool AddCodeZone(const DissasmCodeZone& zone);
+    bool AddCachedCodeZone(const DissasmCache& cache, const DissasmCacheCodeZone& zone);
+    void Build(const DissasmCacheFingerprint& fingerprint, std::vector<uint8>& output);
+};
 
-} // namespace GView::View::DissasmViewer
\ No newline at end of file
+} // namespace GView::View::DissasmViewer
@@ -4,93 +4,27 @@
 using namespace GView::View::DissasmViewer;
 
 constexpr size_t DISSASM_INSTRUCTION_OFFSET_MARGIN = 500;
+constexpr uint32 MAX_INSTRUCTION_SIZE              = 15; // bytes (x86/x64)
 
 const uint8 HEX_MAPPER[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,  0,  0,  0,  0, 0, 0,
                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0,  0,  0,  0,  0,  0, 0, 0,
                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13, 14, 15 };
 
 inline bool ExtractCallsToInsertFunctionNames(
-      vector<AsmOffsetLine>& offsets,
-      DissasmCodeZone* zone,
-      Reference<GView::Object> obj,
-      int internalArchitecture,
-      uint32& totalLines,
-      uint64 maxLocationMemoryMappingSize)
+      DissasmCodeZone* zone, Reference<GView::Object> obj, const std::map<uint64, std::string>* knownFunctions, uint32& totalLines)
 {
-    csh handle;
-    const auto resCode = cs_open(CS_ARCH_X86, static_cast<cs_mode>(internalArchitecture), &handle);
-    if (resCode != CS_ERR_OK) {
-        // WriteErrorToScreen(dli, cs_strerror(resCode));
-        return false;
-    }
-
-    cs_insn* insn = cs_malloc(handle);
-
     DisassemblyZone& zoneDetails = zone->zoneDetails;
     const auto instructionData   = obj->GetData().Get(zoneDetails.startingZonePoint, static_cast<uint32>(zoneDetails.size), false);
-
-    uint32 linesToDecode = totalLines;
-    size_t size          = zoneDetails.size;
-    uint64 address       = offsets[0].offset - zoneDetails.startingZonePoint;
-    auto data            = instructionData.GetData() + address;
+    if (!instructionData.IsValid())
+        return false;
 
     std::vector<std::pair<uint64, std::string>> callsFound;
-    std::unordered_map<uint64, bool> callsMap; // true for offset, false for sub
-    callsFound.reserve(16);
-    bool foundCall     = false;
-    uint64 callAddress = 0;
-    while (cs_disasm_iter(handle, &data, &size, &address, insn) && linesToDecode > 0) {
-        linesToDecode--;
-        const bool isJump = insn->mnemonic[0] == 'j';
-        if (*(uint32*) insn->mnemonic == callOP || isJump) {
-            uint64 value;
-            const bool foundValue = CheckExtractInsnHexValue(insn->op_str, value, maxLocationMemoryMappingSize);
-            if (foundValue && value < zoneDetails.startingZonePoint + zoneDetails.size) {
-                if (value < offsets[0].offset)
-                    value += offsets[0].offset;
-                const char* prefix = isJump ? "offset_0x" : "sub_0x";
-                const auto it      = callsMap.find(value);
-                if (it != callsMap.end()) {
-                    if (isJump == it->second)
-                        continue;
-                }
-                auto callName = FormatFunctionName(value, prefix);
-                callsFound.emplace_back(value, callName.GetText());
-                callsMap.insert({ value, isJump });
-            }
-        } else {
-            const auto mnemonicVal = *(uint32*) insn->mnemonic;
-            if (foundCall) {
-                if (mnemonicVal == movOP && strcmp(insn->op_str, "ebp, esp") == 0) {
-                    if (callAddress < offsets[0].offset)
-                        callAddress += offsets[0].offset;
-                    const auto it = callsMap.find(callAddress);
-                    if (it != callsMap.end()) {
-                        if (!it->second)
-                            continue;
-                    }
-                    const char* prefix = "sub_0x";
-                    auto callName      = FormatFunctionName(callAddress, prefix);
-                    callsFound.emplace_back(callAddress, callName.GetText());
-                    callsMap.insert({ callAddress, true });
-                }
-                foundCall = false;
-            } else {
-                if (mnemonicVal == pushOP) {
-                    if (strcmp(insn->op_str, "ebp") == 0) {
-                        callAddress = insn->address;
-                        foundCall   = true;
-                    }
-                }
-            }
-        }
-    }
+    const std::map<uint64, std::string> noFunctions;
+    if (!zone->DeepScan(instructionData, knownFunctions ? *knownFunctions : noFunctions, callsFound))
+        return false;
 
-    if (callsFound.empty()) {
-        cs_free(insn, 1);
-        cs_close(&handle);
+    if (callsFound.empty())
         return false;
-    }
 
     auto val = callsFound[0].first;
 
@@ -144,20 +78,22 @@ inline bool ExtractCallsToInsertFunctionNames(
         uint32 diffLines       = 0;
         auto callInsn          = GetCurrentInstructionByOffset(callValue, zone, obj, diffLines);
         if (callInsn) {
-            zone->dissasmType.annotations.insert({ diffLines + extraLines, { call.second, callValue - offsets[0].offset } });
-            cs_free(callInsn, 1);
+            zone->dissasmType.annotations.insert({ diffLines + extraLines, { call.second, callValue - zone->cachedCodeOffsets[0].offset } });
             extraLines++;
         }
     }
-    totalLines += static_cast<uint32>(callsFound.size());
-    cs_free(insn, 1);
-    cs_close(&handle);
+    totalLines += extraLines; // a line for every annotation (the calls whose instruction was not found have none)
 
     return true;
 }
 
 inline bool populateOffsetsVector(
-      vector<AsmOffsetLine>& offsets, DisassemblyZone& zoneDetails, GView::Object& obj, int internalArchitecture, uint32& totalLines)
+      vector<AsmOffsetLine>& offsets,
+      DissasmLinesIndex& linesIndex,
+      DisassemblyZone& zoneDetails,
+      GView::Object& obj,
+      int internalArchitecture,
+      uint32& totalLines)
 {
     csh handle;
     const auto resCode = cs_open(CS_ARCH_X86, static_cast<cs_mode>(internalArchitecture), &handle);
@@ -276,11 +212,15 @@ inline bool populateOffsetsVector(
     uint32 lineIndex = 0;
     offsets.clear();
     offsets.push_back({ minimalValue, 0 });
+    linesIndex.Clear();
 
     constexpr uint32 alOpStr         = 7102752u; //* (uint32*) " al";
     uint32 continuousAddInstructions = 0;
+    uint64 firstAddOffset            = 0; // the 'add' instructions are added to the lines index only if they are not the padding at the end
+    uint8 addSize                    = 0;
 
     while (cs_disasm_iter(handle, &data, &size, &address, insn)) {
+        const uint64 lineOffset = insn->address + zoneDetails.startingZonePoint - minimalValue;
         lineIndex++;
         if (address - lastOffset >= DISSASM_INSTRUCTION_OFFSET_MARGIN) {
             lastOffset                = address;
@@ -289,13 +229,27 @@ inline bool populateOffsetsVector(
         }
 
         if (*(uint32*) insn->mnemonic == addOP && insn->op_str[0] == 'b' && *(uint32*) &insn->op_str[15] == alOpStr) {
+            if (continuousAddInstructions == 0) {
+                firstAddOffset = lineOffset;
+                addSize        = static_cast<uint8>(insn->size);
+            }
             if (++continuousAddInstructions == addInstructionsStop) {
                 lineIndex -= continuousAddInstructions;
+                continuousAddInstructions = 0;
+                // the padding is not part of the zone => neither are the checkpoints from it
+                while (offsets.size() > 1 && offsets.back().line > lineIndex)
+                    offsets.pop_back();
                 break;
             }
-        } else
-            continuousAddInstructions = 0;
+            continue;
+        }
+        for (uint32 index = 0; index < continuousAddInstructions; index++)
+            linesIndex.Add(firstAddOffset + index * addSize, addSize);
+        continuousAddInstructions = 0;
+        linesIndex.Add(lineOffset, static_cast<uint8>(insn->size));
     }
+    for (uint32 index = 0; index < continuousAddInstructions; index++)
+        linesIndex.Add(firstAddOffset + index * addSize, addSize);
 
     totalLines = lineIndex;
     cs_free(insn, 1);
@@ -303,6 +257,124 @@ inline bool populateOffsetsVector(
     return true;
 }
 
+DissasmDecoder::~DissasmDecoder()
+{
+    Close();
+}
+
+bool DissasmDecoder::Open(int internalArchitecture, DrawLineInfo* dli)
+{
+    if (insn)
+        return true;
+    const auto resCode = cs_open(CS_ARCH_X86, static_cast<cs_mode>(internalArchitecture), &handle);
+    if (resCode != CS_ERR_OK) {
+        if (dli)
+            dli->WriteErrorToScreen(cs_strerror(resCode));
+        return false;
+    }
+    insn = cs_malloc(handle);
+    if (!insn) {
+        if (dli)
+            dli->WriteErrorToScreen("ERROR: failed to allocate an instruction!");
+        cs_close(&handle);
+        return false;
+    }
+    return true;
+}
+
+void DissasmDecoder::Close()
+{
+    if (insn) {
+        cs_free(insn, 1);
+        cs_close(&handle);
+        insn = nullptr;
+    }
+    nextLine = INVALID_LINE;
+}
+
+const cs_insn* DissasmDecodedLinesCache::Get(uint32 line)
+{
+    const auto it = lines.find(line);
+    if (it == lines.end())
+        return nullptr;
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->insn;
+}
+
+const cs_insn* DissasmDecodedLinesCache::Add(uint32 line, const cs_insn& insn)
+{
+    auto it = lines.find(line);
+    if (it == lines.end()) {
+        if (entries.size() >= MAX_ENTRIES) {
+            // the least recently used entry is reused
+            lines.erase(entries.back().line);
+            entries.splice(entries.begin(), entries, std::prev(entries.end()));
+        } else {
+            entries.emplace_front();
+        }
+        it = lines.insert({ line, entries.begin() }).first;
+    } else {
+        entries.splice(entries.begin(), entries, it->second);
+    }
+
+    auto& entry       = entries.front();
+    entry.line        = line;
+    entry.insn        = insn;
+    entry.insn.detail = nullptr; // owned by the decoder
+    return &entry.insn;
+}
+
+void DissasmDecodedLinesCache::Clear()
+{
+    entries.clear();
+    lines.clear();
+}
+
+void DissasmLinesIndex::Clear()
+{
+    anchors.clear();
+    sizes.clear();
+}
+
+void DissasmLinesIndex::Add(uint64 offset, uint8 size)
+{
+    if (sizes.size() % ANCHOR_LINES == 0)
+        anchors.push_back(offset);
+    sizes.push_back(size);
+}
+
+void DissasmLinesIndex::Assign(const uint64* anchorsData, size_t anchorsCount, const uint8* sizesData, size_t linesCount)
+{
+    anchors.assign(anchorsData, anchorsData + anchorsCount);
+    sizes.assign(sizesData, sizesData + linesCount);
+}
+
+uint64 DissasmLinesIndex::GetOffset(uint32 line) const
+{
+    assert(line < sizes.size());
+    auto offset = anchors[line / ANCHOR_LINES];
+    for (auto index = line - line % ANCHOR_LINES; index < line; index++)
+        offset += sizes[index];
+    return offset;
+}
+
+bool DissasmLinesIndex::FindLine(uint64 offset, uint32& line) const
+{
+    if (anchors.empty() || offset < anchors[0])
+        return false;
+    const auto it = std::upper_bound(anchors.begin(), anchors.end(), offset);
+    line          = static_cast<uint32>(it - anchors.begin() - 1) * ANCHOR_LINES;
+
+    auto lineOffset     = anchors[line / ANCHOR_LINES];
+    const auto lastLine = std::min<uint32>(line + ANCHOR_LINES, GetLinesCount());
+    for (; line < lastLine; line++) {
+        if (offset < lineOffset + sizes[line])
+            return true;
+        lineOffset += sizes[line];
+    }
+    return false; // after the last instruction
+}
+
 bool GView::View::DissasmViewer::DissasmCodeZone::InitZone(DissasmCodeZoneInitData& initData)
 {
     // TODO: move this on init
@@ -326,15 +398,23 @@ bool GView::View::DissasmViewer::DissasmCodeZone::InitZone(DissasmCodeZoneInitDa
     }
     }
 
+    // the zone is decoded again from its start
+    decoder.Close();
+    decodedLines.Clear();
+    functionsTable.Clear();
+
     uint32 totalLines = 0;
-    if (!populateOffsetsVector(cachedCodeOffsets, zoneDetails, initData.obj, internalArchitecture, totalLines)) {
-        initData.dli->WriteErrorToScreen("ERROR: failed to populate offsets vector!");
-        return false;
-    }
-    if (initData.enableDeepScanDissasmOnStart &&
-        !ExtractCallsToInsertFunctionNames(cachedCodeOffsets, this, initData.obj, internalArchitecture, totalLines, initData.maxLocationMemoryMappingSize)) {
-        initData.dli->WriteErrorToScreen("ERROR: failed to populate offsets vector!");
-        return false;
+    // the cache has the offsets, the lines index, the labels and the functions of the zone => no need for the deep scan
+    const bool loadedFromCache = initData.enableDeepScanDissasmOnStart && initData.cache && TryLoadDataFromCache(*initData.cache, totalLines);
+    if (!loadedFromCache) {
+        if (!populateOffsetsVector(cachedCodeOffsets, linesIndex, zoneDetails, initData.obj, internalArchitecture, totalLines)) {
+            initData.dli->WriteErrorToScreen("ERROR: failed to populate offsets vector!");
+            return false;
+        }
+        if (initData.enableDeepScanDissasmOnStart && !ExtractCallsToInsertFunctionNames(this, initData.obj, initData.knownFunctions, totalLines)) {
+            initData.dli->WriteErrorToScreen("ERROR: failed to populate offsets vector!");
+            return false;
+        }
     }
     totalLines++; //+1 for title
     initData.adjustedZoneSize = totalLines;
@@ -354,7 +434,8 @@ bool GView::View::DissasmViewer::DissasmCodeZone::InitZone(DissasmCodeZoneInitDa
         initData.dli->WriteErrorToScreen("ERROR: extract valid data from file!");
         return false;
     }
-    asmData = const_cast<uint8*>(instructionData.GetData());
+    asmData          = const_cast<uint8*>(instructionData.GetData());
+    decoder.nextLine = DissasmDecoder::INVALID_LINE;
 
     const uint32 preReverseSize = std::min<uint32>(initData.visibleRows, extendedSize);
     asmPreCacheData.cachedAsmLines.reserve(preReverseSize);
@@ -370,6 +451,52 @@ bool GView::View::DissasmViewer::DissasmCodeZone::InitZone(DissasmCodeZoneInitDa
     return true;
 }
 
+bool DissasmCodeZone::SeekAsmLine(uint32 line, Reference<GView::Object> obj, DrawLineInfo* dli)
+{
+    // the data is read from the anchor of the line => the other lines from the same anchor reuse it
+    const uint32 anchorLine   = line - line % DissasmLinesIndex::ANCHOR_LINES;
+    const uint64 anchorOffset = linesIndex.GetOffset(anchorLine);
+    if (anchorLine != lastClosestLine || !lastData.IsValid()) {
+        // only the instructions of the anchor are read
+        const uint64 spanSize = std::min<uint64>(zoneDetails.size - anchorOffset, DissasmLinesIndex::ANCHOR_LINES * MAX_INSTRUCTION_SIZE);
+        lastData              = obj->GetData().Get(cachedCodeOffsets[0].offset + anchorOffset, static_cast<uint32>(spanSize), false);
+        if (!lastData.IsValid()) {
+            if (dli)
+                dli->WriteErrorToScreen("ERROR: extract valid data from file!");
+            lastClosestLine  = DissasmDecoder::INVALID_LINE;
+            decoder.nextLine = DissasmDecoder::INVALID_LINE;
+            return false;
+        }
+        lastClosestLine = anchorLine;
+    }
+
+    asmAddress         = linesIndex.GetOffset(line);
+    asmSize            = lastData.GetLength() - (asmAddress - anchorOffset);
+    asmData            = lastData.GetData() + (asmAddress - anchorOffset);
+    offsetCacheMaxLine = 0; // asmData is not from a checkpoint range
+    decoder.nextLine   = line;
+    return true;
+}
+
+void DissasmCodeZone::UpdateLinesPassed(DissasmCodeInternalType& type, uint32 line)
+{
+    auto it = annotationsLines.find(&type);
+    if (it == annotationsLines.end()) {
+        std::vector<uint32> lines;
+        lines.reserve(type.annotations.size());
+        for (const auto& annotation : type.annotations)
+            lines.push_back(annotation.first);
+        it = annotationsLines.insert({ &type, std::move(lines) }).first;
+    }
+
+    // the position of a line in the sorted annotations is the number of annotations before it
+    const auto& lines    = it->second;
+    const auto first     = std::lower_bound(lines.begin(), lines.end(), type.indexZoneStart);
+    const auto last      = std::upper_bound(first, lines.end(), line);
+    type.textLinesPassed = static_cast<uint32>(last - first);
+    type.asmLinesPassed  = line + 1 - type.indexZoneStart - type.textLinesPassed;
+}
+
 void DissasmCodeZone::ReachZoneLine(uint32 line)
 {
     changedLevel = false;
@@ -407,18 +534,8 @@ void DissasmCodeZone::ReachZoneLine(uint32 line)
     }
 
     DissasmCodeInternalType& currentType = types.back();
-    // TODO: do a faster search using a binary search using the annotations and start from there
-    // TODO: maybe use some caching here?
     if (reAdapt || levelNow < levelToReach && levelNow + 1 != levelToReach || levelNow > levelToReach && levelNow - 1 != levelToReach) {
-        currentType.textLinesPassed = 0;
-        currentType.asmLinesPassed  = 0;
-        for (uint32 i = currentType.indexZoneStart; i <= levelToReach; i++) {
-            if (currentType.annotations.contains(i)) {
-                currentType.textLinesPassed++;
-                continue;
-            }
-            currentType.asmLinesPassed++;
-        }
+        UpdateLinesPassed(currentType, levelToReach);
     } else {
         if (currentType.annotations.contains(levelToReach))
             currentType.textLinesPassed++;
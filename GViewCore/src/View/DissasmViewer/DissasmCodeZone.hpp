@@ -5,6 +5,102 @@
 namespace GView::View::DissasmViewer
 {
 
+// capstone context that lives as long as the zone (the handle and the instruction buffer are reused for every decoded instruction)
+struct DissasmDecoder {
+    static constexpr uint32 INVALID_LINE = UINT32_MAX;
+
+    csh handle{ 0 };
+    cs_insn* insn{ nullptr };
+    uint32 nextLine{ INVALID_LINE }; // asm line of the instruction from the zone asmData (INVALID_LINE if asmData was moved by someone else)
+
+    DissasmDecoder()                                 = default;
+    DissasmDecoder(const DissasmDecoder&)            = delete;
+    DissasmDecoder& operator=(const DissasmDecoder&) = delete;
+    ~DissasmDecoder();
+
+    bool Open(int internalArchitecture, DrawLineInfo* dli = nullptr);
+    void Close();
+};
+
+// the most recently decoded instructions of a zone, by their asm line (collapsing zones or adding annotations does not change the asm lines)
+class DissasmDecodedLinesCache
+{
+    struct Entry {
+        uint32 line;
+        cs_insn insn;
+    };
+    std::list<Entry> entries; // the most recently used first
+    std::unordered_map<uint32, std::list<Entry>::iterator> lines;
+
+  public:
+    static constexpr size_t MAX_ENTRIES = 1024;
+
+    const cs_insn* Get(uint32 line);
+    const cs_insn* Add(uint32 line, const cs_insn& insn);
+    void Clear();
+};
+
+// the offset of every asm line of a zone (relative to the first one): the size of every instruction and the offset of every ANCHOR_LINES lines
+class DissasmLinesIndex
+{
+    std::vector<uint64> anchors;
+    std::vector<uint8> sizes;
+
+  public:
+    static constexpr uint32 ANCHOR_LINES = 64;
+
+    void Clear();
+    void Add(uint64 offset, uint8 size);
+    uint64 GetOffset(uint32 line) const;
+    bool FindLine(uint64 offset, uint32& line) const;
+    uint32 GetLinesCount() const
+    {
+        return static_cast<uint32>(sizes.size());
+    }
+    const std::vector<uint64>& GetAnchors() const
+    {
+        return anchors;
+    }
+    const std::vector<uint8>& GetSizes() const
+    {
+        return sizes;
+    }
+    void Assign(const uint64* anchorsData, size_t anchorsCount, const uint8* sizesData, size_t linesCount);
+};
+
+// the functions of a zone found by the deep scan, with their basic blocks (by asm lines), and the known targets of the calls and the jumps
+struct DissasmFunctionsTable {
+    struct BasicBlock {
+        uint32 line;
+        uint32 linesCount;
+
+        bool operator==(const BasicBlock& other) const = default;
+    };
+    struct Function {
+        uint32 line;
+        uint32 firstBlock;
+        uint32 blocksCount;
+
+        bool operator==(const Function& other) const = default;
+    };
+    struct Branch {
+        uint32 line;
+        uint32 indirect; // 1 if the target is read from memory ([target]), 0 if the target is a line of the zone
+        uint64 target;   // the offset of the target from the first line of the zone or the memory operand
+
+        bool operator==(const Branch& other) const = default;
+    };
+
+    std::vector<Function> functions; // sorted by line
+    std::vector<BasicBlock> blocks;  // the blocks of every function (sorted by line)
+    std::vector<Branch> branches;    // sorted by line
+
+    void Clear();
+    const Function* GetFunction(uint32 line) const;  // the function that starts at the line
+    const Function* FindFunction(uint32 line) const; // the function with a block that contains the line
+    const Branch* GetBranch(uint32 line) const;      // the call or the jump from the line (if its target is known)
+};
+
 struct DissasmCodeZone : public ParseZone {
     enum class CollapseExpandType : uint8 { Collapse, Expand, NegateCurrentState };
     uint32 lastDrawnLine; // optimization not to recompute buffer every time
@@ -23,8 +119,13 @@ struct DissasmCodeZone : public ParseZone {
     DissasmCodeInternalType dissasmType;
 
     DissasmAsmPreCacheData asmPreCacheData;
+    DissasmDecoder decoder;
+    DissasmDecodedLinesCache decodedLines;
 
     std::vector<AsmOffsetLine> cachedCodeOffsets;
+    DissasmLinesIndex linesIndex;
+    DissasmFunctionsTable functionsTable;
+    std::unordered_map<const DissasmCodeInternalType*, std::vector<uint32>> annotationsLines; // the sorted lines of the annotations of every type
     DisassemblyZone zoneDetails;
     int internalArchitecture; // used for dissasm libraries
     bool isInit;
@@ -32,6 +133,8 @@ struct DissasmCodeZone : public ParseZone {
     InternalTypeNewLevelChangeData newLevelChangeData;
 
     void ResetZoneCaching();
+    bool SeekAsmLine(uint32 line, Reference<GView::Object> obj, DrawLineInfo* dli = nullptr);
+    void UpdateLinesPassed(DissasmCodeInternalType& type, uint32 line);
     bool AddCollapsibleZone(uint32 zoneLineStart, uint32 zoneLineEnd);
     bool CanAddNewZone(uint32 zoneLineStart, uint32 zoneLineEnd) const
     {
@@ -43,6 +146,13 @@ struct DissasmCodeZone : public ParseZone {
     bool RemoveCollapsibleZone(uint32 zoneLine);
 
     bool InitZone(DissasmCodeZoneInitData& initData);
+    // knownFunctions - file offsets of functions that are not called from the zone (for example exports) => their names
+    // linesPerWorker - the lines decoded by every thread (0 - split the lines between the hardware threads)
+    bool DeepScan(
+          BufferView instructionData,
+          const std::map<uint64, std::string>& knownFunctions,
+          std::vector<std::pair<uint64, std::string>>& callsFound,
+          uint32 linesPerWorker = 0);
     void ReachZoneLine(uint32 line);
 
     bool ResetTypesReferenceList();
@@ -53,8 +163,7 @@ struct DissasmCodeZone : public ParseZone {
     bool RemoveComment(uint32 line, bool showErr = true);
     DissasmAsmPreCacheLine GetCurrentAsmLine(uint32 currentLine, Reference<GView::Object> obj, DissasmInsnExtractLineParams* params);
 
-    bool ToBuffer(std::vector<uint8>& buffer) const;
-    bool TryLoadDataFromCache(DissasmCache& cache);
+    bool TryLoadDataFromCache(DissasmCache& cache, uint32& totalLines);
 };
 
 } // namespace GView::View::DissasmViewer
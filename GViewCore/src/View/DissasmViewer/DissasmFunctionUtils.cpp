@@ -151,9 +151,30 @@ AsmOffsetLine SearchForClosestAsmOffsetLineByOffset(const std::vector<AsmOffsetL
     return values[left];
 }
 
-cs_insn* GetCurrentInstructionByOffset(
+const cs_insn* GetCurrentInstructionByOffset(
       uint64 offsetToReach, DissasmCodeZone* zone, Reference<GView::Object> obj, uint32& diffLines, DrawLineInfo* dli)
 {
+    auto& decoder = zone->decoder;
+    if (!decoder.Open(zone->internalArchitecture, dli))
+        return nullptr;
+
+    const uint64 zoneOffset = offsetToReach >= zone->cachedCodeOffsets[0].offset ? offsetToReach - zone->cachedCodeOffsets[0].offset : offsetToReach;
+    if (zone->linesIndex.FindLine(zoneOffset, diffLines)) {
+        // the line of the offset is known => only its instruction is decoded
+        if (!zone->SeekAsmLine(diffLines, obj, dli))
+            return nullptr;
+        if (!cs_disasm_iter(decoder.handle, &zone->asmData, (size_t*) &zone->asmSize, &zone->asmAddress, decoder.insn)) {
+            if (dli)
+                dli->WriteErrorToScreen("Failed to dissasm!");
+            decoder.nextLine = DissasmDecoder::INVALID_LINE;
+            return nullptr;
+        }
+        decoder.nextLine++;
+        return decoder.insn;
+    }
+
+    // asmData is moved => the next line is decoded again from its checkpoint
+    decoder.nextLine       = DissasmDecoder::INVALID_LINE;
     const auto closestData = SearchForClosestAsmOffsetLineByOffset(zone->cachedCodeOffsets, offsetToReach);
     zone->lastClosestLine  = closestData.line;
     zone->asmAddress       = closestData.offset - zone->cachedCodeOffsets[0].offset;
@@ -171,33 +192,17 @@ cs_insn* GetCurrentInstructionByOffset(
 
     zone->asmData = const_cast<uint8*>(zone->lastData.GetData());
 
-    // TODO: keep the handle open and insn open until the program ends
-    csh handle;
-    const auto resCode = cs_open(CS_ARCH_X86, static_cast<cs_mode>(zone->internalArchitecture), &handle);
-    if (resCode != CS_ERR_OK) {
-        if (dli)
-            dli->WriteErrorToScreen(cs_strerror(resCode));
-        cs_close(&handle);
-        return nullptr;
-    }
-
-    diffLines     = 0;
-    cs_insn* insn = cs_malloc(handle);
-    if (offsetToReach >= zone->cachedCodeOffsets[0].offset)
-        offsetToReach -= zone->cachedCodeOffsets[0].offset;
-    while (zone->asmAddress <= offsetToReach) {
-        if (!cs_disasm_iter(handle, &zone->asmData, (size_t*) &zone->asmSize, &zone->asmAddress, insn)) {
+    diffLines = 0;
+    while (zone->asmAddress <= zoneOffset) {
+        if (!cs_disasm_iter(decoder.handle, &zone->asmData, (size_t*) &zone->asmSize, &zone->asmAddress, decoder.insn)) {
             if (dli)
                 dli->WriteErrorToScreen("Failed to dissasm!");
-            cs_free(insn, 1);
-            cs_close(&handle);
             return nullptr;
         }
         diffLines++;
     }
     diffLines += closestData.line - 1;
-    cs_close(&handle);
-    return insn;
+    return decoder.insn;
 }
 
 AsmOffsetLine SearchForClosestAsmOffsetLineByLine(const std::vector<AsmOffsetLine>& values, uint64 searchedLine, uint32* index)
@@ -11,7 +11,7 @@ constexpr uint32 movOP  = 7761773u;    //*((uint32*) "mov");
 bool CheckExtractInsnHexValue(const char* op_str, AppCUI::uint64& value, AppCUI::uint64 maxSize);
 AppCUI::Utils::LocalString<64> FormatFunctionName(AppCUI::uint64 functionAddress, const char* prefix);
 
-cs_insn* GetCurrentInstructionByOffset(
+const cs_insn* GetCurrentInstructionByOffset(
       uint64 offsetToReach,
       GView::View::DissasmViewer::DissasmCodeZone* zone,
       Reference<GView::Object> obj,
@@ -0,0 +1,385 @@
+#include "DissasmCodeZone.hpp"
+#include "DissasmFunctionUtils.hpp"
+
+#include <thread>
+#include <atomic>
+#include <map>
+#include <unordered_set>
+
+using namespace GView::View::DissasmViewer;
+
+constexpr uint32 MIN_LINES_PER_WORKER = 0x4000;
+constexpr uint64 UNKNOWN_ADDRESS      = UINT64_MAX;
+
+/*
+    The deep scan decodes every asm line once, in parallel: the lines are split in ranges (the lines index gives the offset
+    where a range starts) and every thread has its own capstone handle (with details) and takes one range at a time.
+    The operands come from the details:
+    - a call or a jump to an immediate value is a branch to a line of the zone
+    - a call or a jump through an absolute memory operand ([value], no registers) is a branch as well, but the value is
+      where the target is stored => it is not followed and it does not start a function
+    - the calls and the jumps are found by their capstone groups (CS_GRP_CALL / CS_GRP_JUMP)
+    - "push ebp" followed by "mov ebp, esp" ("push rbp" / "mov rbp, rsp" for x64; the calls and the jumps between them
+      are ignored) is a prologue
+    A prologue depends on the instructions before it => a range is followed from both of its starts (after a "push ebp"
+    or not) until they reach the same state and the right one is picked when the ranges are merged (in order).
+
+    The functions (the entry point, the known functions, the call targets and the prologues) are then followed by recursive
+    descent over the decoded lines (the threads take one function at a time): a basic block ends with a jump or a return,
+    the jump targets and the lines after the conditional jumps start new blocks. A function ends where the next one starts
+    (the jumps outside of it are not followed) => the functions are disjoint ranges of lines.
+
+    The labels come from the table: "sub_" (or the known name) for the functions, "offset_" for the other jump targets and
+    "sub_" / "offset_" for the memory operands of the indirect calls and jumps. The view draws the branches from the table.
+*/
+
+enum LineFlow : uint8 {
+    FlowNone            = 0,
+    FlowCall            = 1,
+    FlowJump            = 2,
+    FlowConditionalJump = 3,
+    FlowReturn          = 4,
+};
+
+enum class ScanEventStart : uint8 { Any, AfterOther, AfterPush }; // the start of the range the prologue belongs to
+
+struct ScanEvent {
+    uint64 address; // UNKNOWN_ADDRESS for the "push ebp" from the previous range
+    ScanEventStart start;
+};
+
+struct ScanRange {
+    uint32 firstLine, lastLine;
+    std::vector<ScanEvent> prologues;
+    std::vector<DissasmFunctionsTable::Branch> branches; // the target of a direct branch is a sweep address
+    bool afterPush[2];                                   // the state at the end of the range, for both starts
+    uint64 pushAddress[2];
+    bool opened;
+};
+
+static uint32 GetThreadsCount()
+{
+    return std::max<>(std::thread::hardware_concurrency(), 1U);
+}
+
+static uint32 GetLinesPerWorker(uint32 count)
+{
+    const auto workers = static_cast<uint32>(std::min<uint64>(std::max<uint64>(count / MIN_LINES_PER_WORKER, 1), GetThreadsCount()));
+    return (count + workers - 1) / workers;
+}
+
+static inline bool IsRegisterOperand(const cs_x86_op& op, x86_reg reg)
+{
+    return op.type == X86_OP_REG && op.reg == reg;
+}
+
+static inline bool IsAbsoluteMemoryOperand(const cs_x86_op& op)
+{
+    return op.type == X86_OP_MEM && op.mem.segment == X86_REG_INVALID && op.mem.base == X86_REG_INVALID && op.mem.index == X86_REG_INVALID;
+}
+
+static void ScanLines(
+      const DissasmCodeZone* zone, BufferView instructionData, uint64 firstAddress, csh handle, cs_insn* insn, std::vector<uint8>& flows, ScanRange& worker)
+{
+    // the addresses are the same as in a sweep from the start of the zone (the immediate values depend on them)
+    uint64 address    = firstAddress + zone->linesIndex.GetOffset(worker.firstLine);
+    const uint8* data = instructionData.GetData() + address;
+    size_t size       = address < instructionData.GetLength() ? instructionData.GetLength() - static_cast<size_t>(address) : 0;
+
+    // [0] - the range starts after another instruction, [1] - after a "push ebp" (from the previous range)
+    bool afterPush[2]     = { false, true };
+    uint64 pushAddress[2] = { 0, UNKNOWN_ADDRESS };
+    bool sameState        = worker.firstLine == 0;
+    // the frame pointer and the stack pointer of the prologue
+    const auto is64         = zone->internalArchitecture == CS_MODE_64;
+    const auto framePointer = is64 ? X86_REG_RBP : X86_REG_EBP;
+    const auto stackPointer = is64 ? X86_REG_RSP : X86_REG_ESP;
+
+    for (auto line = worker.firstLine; line < worker.lastLine; line++) {
+        if (!cs_disasm_iter(handle, &data, &size, &address, insn))
+            break;
+
+        const auto& x86 = insn->detail->x86;
+        uint8 flow      = FlowNone;
+        if (cs_insn_group(handle, insn, CS_GRP_CALL))
+            flow = FlowCall;
+        else if (cs_insn_group(handle, insn, CS_GRP_RET))
+            flow = FlowReturn;
+        else if (cs_insn_group(handle, insn, CS_GRP_JUMP))
+            flow = insn->id == X86_INS_JMP ? FlowJump : FlowConditionalJump;
+        flows[line] = flow;
+
+        if (flow == FlowCall || flow == FlowJump || flow == FlowConditionalJump) {
+            if (x86.op_count == 1 && x86.operands[0].type == X86_OP_IMM)
+                worker.branches.push_back({ line, 0, static_cast<uint64>(x86.operands[0].imm) });
+            else if (x86.op_count == 1 && IsAbsoluteMemoryOperand(x86.operands[0]))
+                worker.branches.push_back({ line, 1, static_cast<uint64>(x86.operands[0].mem.disp) });
+            continue;
+        }
+
+        const bool isPushEbp = insn->id == X86_INS_PUSH && x86.op_count == 1 && IsRegisterOperand(x86.operands[0], framePointer);
+        const bool isMovEbpEsp = insn->id == X86_INS_MOV && x86.op_count == 2 && IsRegisterOperand(x86.operands[0], framePointer) &&
+                                 IsRegisterOperand(x86.operands[1], stackPointer);
+        for (uint32 start = 0; start < (sameState ? 1u : 2u); start++) {
+            if (afterPush[start]) {
+                if (isMovEbpEsp) {
+                    const auto eventStart = sameState ? ScanEventStart::Any : (start == 0 ? ScanEventStart::AfterOther : ScanEventStart::AfterPush);
+                    worker.prologues.push_back({ pushAddress[start], eventStart });
+                }
+                afterPush[start] = false;
+            } else if (isPushEbp) {
+                afterPush[start]   = true;
+                pushAddress[start] = insn->address;
+            }
+        }
+        if (!sameState && afterPush[0] == afterPush[1] && (!afterPush[0] || pushAddress[0] == pushAddress[1]))
+            sameState = true;
+    }
+    if (sameState) {
+        afterPush[1]   = afterPush[0];
+        pushAddress[1] = pushAddress[0];
+    }
+    for (uint32 start = 0; start < 2; start++) {
+        worker.afterPush[start]   = afterPush[start];
+        worker.pushAddress[start] = pushAddress[start];
+    }
+}
+
+static std::vector<DissasmFunctionsTable::BasicBlock> FollowFunction(
+      uint32 firstLine, uint32 endLine, const std::vector<uint8>& flows, const std::vector<std::pair<uint32, uint32>>& targets)
+{
+    std::map<uint32, uint32> leaders; // the first line of every block => its last line
+    std::vector<uint32> pending;
+    const auto addLeader = [&](uint32 line) {
+        if (line < firstLine || line >= endLine || leaders.contains(line))
+            return;
+        leaders[line] = line;
+        pending.push_back(line);
+    };
+
+    addLeader(firstLine);
+    while (!pending.empty()) {
+        const auto first = pending.back();
+        pending.pop_back();
+
+        auto line = first;
+        while (true) {
+            const auto flow = flows[line];
+            if (flow == FlowJump || flow == FlowConditionalJump) {
+                const auto it = std::lower_bound(
+                      targets.begin(), targets.end(), line, [](const std::pair<uint32, uint32>& target, uint32 value) { return target.first < value; });
+                if (it != targets.end() && it->first == line)
+                    addLeader(it->second);
+                if (flow == FlowConditionalJump)
+                    addLeader(line + 1);
+                break;
+            }
+            if (flow == FlowReturn || line + 1 >= endLine || leaders.contains(line + 1))
+                break;
+            line++;
+        }
+        leaders[first] = line;
+    }
+
+    // a block ends before the next one starts (a jump inside a block splits it)
+    std::vector<DissasmFunctionsTable::BasicBlock> blocks;
+    blocks.reserve(leaders.size());
+    for (auto it = leaders.begin(); it != leaders.end(); it++) {
+        auto last       = it->second;
+        const auto next = std::next(it);
+        if (next != leaders.end())
+            last = std::min<>(last, next->first - 1);
+        blocks.push_back({ it->first, last - it->first + 1 });
+    }
+    return blocks;
+}
+
+void DissasmFunctionsTable::Clear()
+{
+    functions.clear();
+    blocks.clear();
+    branches.clear();
+}
+
+const DissasmFunctionsTable::Function* DissasmFunctionsTable::GetFunction(uint32 line) const
+{
+    const auto it = std::lower_bound(functions.begin(), functions.end(), line, [](const Function& function, uint32 value) { return function.line < value; });
+    if (it == functions.end() || it->line != line)
+        return nullptr;
+    return &(*it);
+}
+
+const DissasmFunctionsTable::Function* DissasmFunctionsTable::FindFunction(uint32 line) const
+{
+    const auto it = std::upper_bound(functions.begin(), functions.end(), line, [](uint32 value, const Function& function) { return value < function.line; });
+    if (it == functions.begin())
+        return nullptr;
+    const auto& function = *(it - 1);
+    const auto b         = blocks.begin() + function.firstBlock;
+    const auto e         = b + function.blocksCount;
+    const auto block     = std::upper_bound(b, e, line, [](uint32 value, const BasicBlock& entry) { return value < entry.line; });
+    if (block == b || line >= (block - 1)->line + (block - 1)->linesCount)
+        return nullptr;
+    return &function;
+}
+
+const DissasmFunctionsTable::Branch* DissasmFunctionsTable::GetBranch(uint32 line) const
+{
+    const auto it = std::lower_bound(branches.begin(), branches.end(), line, [](const Branch& branch, uint32 value) { return branch.line < value; });
+    if (it == branches.end() || it->line != line)
+        return nullptr;
+    return &(*it);
+}
+
+bool DissasmCodeZone::DeepScan(
+      BufferView instructionData,
+      const std::map<uint64, std::string>& knownFunctions,
+      std::vector<std::pair<uint64, std::string>>& callsFound,
+      uint32 linesPerWorker)
+{
+    functionsTable.Clear();
+    const auto linesCount = linesIndex.GetLinesCount();
+    if (!instructionData.IsValid() || linesCount == 0)
+        return false;
+
+    const uint64 zoneStart    = cachedCodeOffsets[0].offset;
+    const uint64 firstAddress = zoneStart - zoneDetails.startingZonePoint;
+    std::vector<uint8> flows(linesCount, FlowNone);
+
+    if (linesPerWorker == 0)
+        linesPerWorker = GetLinesPerWorker(linesCount);
+    std::vector<ScanRange> ranges((linesCount + linesPerWorker - 1) / linesPerWorker);
+    for (size_t index = 0; index < ranges.size(); index++) {
+        ranges[index].firstLine = static_cast<uint32>(index * linesPerWorker);
+        ranges[index].lastLine  = static_cast<uint32>(std::min<uint64>(static_cast<uint64>(index + 1) * linesPerWorker, linesCount));
+        ranges[index].opened    = false;
+    }
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextRange{ 0 };
+    const auto scanThreads = std::min<size_t>(GetThreadsCount(), ranges.size());
+    for (size_t index = 0; index < scanThreads; index++) {
+        threads.emplace_back([&]() {
+            csh handle;
+            if (cs_open(CS_ARCH_X86, static_cast<cs_mode>(internalArchitecture), &handle) != CS_ERR_OK)
+                return;
+            cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
+            cs_insn* insn = cs_malloc(handle);
+            for (auto range = nextRange++; range < ranges.size(); range = nextRange++) {
+                ranges[range].opened = true;
+                ScanLines(this, instructionData, firstAddress, handle, insn, flows, ranges[range]);
+            }
+            cs_free(insn, 1);
+            cs_close(&handle);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+
+    // the addresses are from the sweep (relative to the start of the zone) => the lines of the functions and of the targets
+    const auto getLine = [this, firstAddress](uint64 address, uint32& line) {
+        return address >= firstAddress && linesIndex.FindLine(address - firstAddress, line);
+    };
+
+    std::vector<uint32> functionsLines;
+    std::vector<uint32> jumpsLines;
+    std::vector<std::pair<uint32, uint32>> targetsLines;
+    std::vector<std::pair<uint64, bool>> indirectTargets; // true for a jump
+    uint32 line;
+    if (getLine(zoneDetails.entryPoint - zoneStart + firstAddress, line))
+        functionsLines.push_back(line);
+
+    bool afterPush     = false;
+    uint64 pushAddress = 0;
+    for (const auto& range : ranges) {
+        if (!range.opened)
+            return false;
+        const auto start = afterPush ? ScanEventStart::AfterPush : ScanEventStart::AfterOther;
+        for (const auto& prologue : range.prologues) {
+            if (prologue.start != ScanEventStart::Any && prologue.start != start)
+                continue;
+            if (getLine(prologue.address == UNKNOWN_ADDRESS ? pushAddress : prologue.address, line))
+                functionsLines.push_back(line);
+        }
+        for (const auto& branch : range.branches) {
+            const bool isJump = flows[branch.line] != FlowCall;
+            if (branch.indirect) {
+                functionsTable.branches.push_back(branch);
+                if (branch.target < zoneDetails.startingZonePoint + zoneDetails.size)
+                    indirectTargets.emplace_back(branch.target, isJump);
+                continue;
+            }
+            if (!getLine(branch.target, line))
+                continue;
+            functionsTable.branches.push_back({ branch.line, 0, branch.target - firstAddress });
+            targetsLines.emplace_back(branch.line, line);
+            (isJump ? jumpsLines : functionsLines).push_back(line);
+        }
+
+        const auto index = afterPush ? 1 : 0;
+        if (range.pushAddress[index] != UNKNOWN_ADDRESS)
+            pushAddress = range.pushAddress[index];
+        afterPush = range.afterPush[index];
+    }
+
+    // the known functions are file offsets (the first name of a line is kept)
+    std::map<uint32, const std::string*> functionsNames;
+    for (const auto& [offset, name] : knownFunctions) {
+        if (offset < zoneStart || offset >= zoneDetails.startingZonePoint + zoneDetails.size)
+            continue;
+        if (getLine(offset - zoneDetails.startingZonePoint, line)) {
+            functionsLines.push_back(line);
+            functionsNames.insert({ line, &name });
+        }
+    }
+
+    std::sort(functionsLines.begin(), functionsLines.end());
+    functionsLines.erase(std::unique(functionsLines.begin(), functionsLines.end()), functionsLines.end());
+
+    std::vector<std::vector<DissasmFunctionsTable::BasicBlock>> functionsBlocks(functionsLines.size());
+    std::atomic<size_t> nextFunction{ 0 };
+    const auto descentThreads = std::min<size_t>(GetThreadsCount(), functionsLines.size());
+    for (size_t index = 0; index < descentThreads; index++) {
+        threads.emplace_back([&]() {
+            for (auto function = nextFunction++; function < functionsLines.size(); function = nextFunction++) {
+                const auto endLine        = function + 1 < functionsLines.size() ? functionsLines[function + 1] : linesCount;
+                functionsBlocks[function] = FollowFunction(functionsLines[function], endLine, flows, targetsLines);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    functionsTable.functions.reserve(functionsLines.size());
+    for (size_t index = 0; index < functionsLines.size(); index++) {
+        const auto& blocks = functionsBlocks[index];
+        functionsTable.functions.push_back(
+              { functionsLines[index], static_cast<uint32>(functionsTable.blocks.size()), static_cast<uint32>(blocks.size()) });
+        functionsTable.blocks.insert(functionsTable.blocks.end(), blocks.begin(), blocks.end());
+    }
+
+    // the labels of the lines are file offsets, a value can have a single label (the functions first)
+    std::unordered_set<uint64> labels;
+    callsFound.reserve(functionsLines.size() + jumpsLines.size() + indirectTargets.size());
+    for (const auto functionLine : functionsLines) {
+        const uint64 value = zoneStart + linesIndex.GetOffset(functionLine);
+        const auto name    = functionsNames.find(functionLine);
+        callsFound.emplace_back(value, name != functionsNames.end() ? *name->second : std::string(FormatFunctionName(value, "sub_0x").GetText()));
+        labels.insert(value);
+    }
+    std::sort(jumpsLines.begin(), jumpsLines.end());
+    jumpsLines.erase(std::unique(jumpsLines.begin(), jumpsLines.end()), jumpsLines.end());
+    for (const auto jumpLine : jumpsLines) {
+        const uint64 value = zoneStart + linesIndex.GetOffset(jumpLine);
+        if (labels.insert(value).second)
+            callsFound.emplace_back(value, FormatFunctionName(value, "offset_0x").GetText());
+    }
+    for (auto [value, isJump] : indirectTargets) {
+        if (value < zoneStart)
+            value += zoneStart;
+        if (labels.insert(value).second)
+            callsFound.emplace_back(value, FormatFunctionName(value, isJump ? "offset_0x" : "sub_0x").GetText());
+    }
+    return true;
+}
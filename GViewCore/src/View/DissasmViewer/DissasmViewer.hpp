@@ -38,8 +38,6 @@ namespace View
             uint64 size;
             uint64 entryPoint;
             DisassemblyLanguage language;
-
-            bool ToBuffer(std::vector<uint8>& buffer, Reference<GView::Object> obj) const;
         };
 
         enum class InternalDissasmType : uint8 {
@@ -75,6 +73,8 @@ namespace View
         enum class DissasmParseZoneType : uint8 { StructureParseZone, DissasmCodeParseZone, CollapsibleAndTextZone };
 
         struct ParseZone {
+            virtual ~ParseZone() = default;
+
             uint32 startLineIndex;
             uint32 endingLineIndex;
             uint32 extendedSize;
@@ -147,6 +147,7 @@ namespace View
             char* op_str;
             uint32 op_str_size;
             std::optional<uint64> hexValue;
+            std::optional<uint64> branchTarget; // the address of the line the call or the jump goes to (from the deep scan)
             uint8 flags;
             uint8 lineArrowToDraw;
             const void* mapping;
@@ -170,6 +171,8 @@ namespace View
                 op_str_size     = other.op_str_size;
                 op_str          = other.op_str;
                 other.op_str    = nullptr;
+                hexValue        = other.hexValue;
+                branchTarget    = other.branchTarget;
                 flags           = other.flags;
                 lineArrowToDraw = other.lineArrowToDraw;
                 mapping         = other.mapping;
@@ -186,6 +189,8 @@ namespace View
                 currentLine     = other.currentLine;
                 op_str_size     = other.op_str_size;
                 op_str          = strdup(other.op_str);
+                hexValue        = other.hexValue;
+                branchTarget    = other.branchTarget;
                 flags           = other.flags;
                 lineArrowToDraw = other.lineArrowToDraw;
                 mapping         = other.mapping;
@@ -366,6 +371,8 @@ namespace View
             Reference<GView::Object> obj;
             uint64 maxLocationMemoryMappingSize;
             uint32 visibleRows;
+            DissasmCache* cache; // the zone is loaded from the cache (without the deep scan) if it has it
+            const std::map<uint64, std::string>* knownFunctions;
         };
 
         struct InternalTypeNewLevelChangeData {
@@ -391,6 +398,7 @@ namespace View
 
             uint64 maxLocationMemoryMappingSize;
             std::unordered_map<uint64, MemoryMappingEntry> memoryMappings; // memory locations to functions
+            std::map<uint64, std::string> knownFunctions;                  // file offsets of functions (exports) to their names
             std::vector<uint64> offsetsToSearch;
             std::vector<std::unique_ptr<ParseZone>> parseZones;
             std::map<uint64, DissasmStructureType> dissasmTypeMapped; // mapped types against the offset of the file
@@ -398,7 +406,7 @@ namespace View
             std::unordered_map<TypeID, DissasmStructureType> userDesignedTypes; // user defined types
             Reference<BufferViewer::OffsetTranslateInterface> offsetTranslateCallback;
 
-            bool SaveToCache(DissasmCache& cache, Reference<GView::Object> obj);
+            bool SaveToCache(DissasmCacheWriter& writer);
             bool ValidateCacheData(DissasmCache& cache, Reference<GView::Object> obj);
             SettingsData();
         };
@@ -1352,8 +1352,7 @@ void Instance::ChangeZoneCollapseState(ParseZone* zoneToChange, uint32 line)
                         Dialogs::MessageBox::ShowError("Error", "Could not process ChangeZoneCollapseState!");
                         return;
                     }
-                    codeZone->asmPreCacheData.Clear();
-                    break;
+                    break; // the caches of the zone were reset by CollapseOrExtendZone
                 }
                 foundZone = true;
             }
@@ -32,6 +32,11 @@ void Settings::AddMemoryMapping(uint64 address, std::string_view name, MemoryMap
         INTERNAL_SETTINGS->maxLocationMemoryMappingSize = address;
 }
 
+void Settings::AddFunction(uint64 offset, std::string_view name)
+{
+    INTERNAL_SETTINGS->knownFunctions.insert({ offset, std::string(name) });
+}
+
 void Settings::AddVariable(uint64 offset, std::string_view name, VariableType type)
 {
     INTERNAL_SETTINGS->dissasmTypeMapped[offset] = { static_cast<InternalDissasmType>(type), name };
@@ -2,7 +2,11 @@
 #include "DissasmCodeZone.hpp"
 #include "x86_x64/DissasmX86.hpp"
 #include "DissasmFunctionUtils.hpp"
+#include "DissasmCache.hpp"
 #include <array>
+#include <filesystem>
+#include <random>
+#include <string>
 
 using namespace GView::View::DissasmViewer;
 
@@ -303,14 +307,15 @@ class DissasmTestInstance
     std::vector<GView::Object> objects;
     std::unique_ptr<DissasmCodeZone> zone;
 
-    DissasmTestInstance(const unsigned char* binaryData, size_t binaryDataSize)
+    DissasmTestInstance(
+          const unsigned char* binaryData, size_t binaryDataSize, DisassemblyLanguage language = DisassemblyLanguage::x86, uint64 entryPoint = 10)
     {
         instance = nullptr;
-        const bool initResult = init(binaryData, binaryDataSize);
+        const bool initResult = init(binaryData, binaryDataSize, language, entryPoint);
         assert(initResult);
     }
 
-    bool init(const unsigned char* binaryData, size_t binaryDataSize)
+    bool init(const unsigned char* binaryData, size_t binaryDataSize, DisassemblyLanguage language, uint64 entryPoint)
     {
         GView::Utils::DataCache cache              = GView::Utils::DataCache();
         std::unique_ptr<OS::MemoryFile> memoryFile = std::make_unique<OS::MemoryFile>();
@@ -326,19 +331,19 @@ class DissasmTestInstance
 
         objects.push_back(GView::Object(GView::Object::Type::MemoryBuffer, std::move(cache), nullptr, "dummy", "loc", 1));
 
-        initDissasmCodeZone(&objects[0]);
+        initDissasmCodeZone(&objects[0], language, entryPoint);
         return true;
     }
 
-    void initDissasmCodeZone(Reference<GView::Object> obj)
+    void initDissasmCodeZone(Reference<GView::Object> obj, DisassemblyLanguage language, uint64 entryPoint)
     {
         if (!obj.IsValid())
             obj = &objects[0];
         zone                                = std::make_unique<DissasmCodeZone>();
-        zone->zoneDetails.language          = DisassemblyLanguage::x86;
+        zone->zoneDetails.language          = language;
         zone->zoneDetails.startingZonePoint = 0;
-        zone->zoneDetails.size              = 5120;
-        zone->zoneDetails.entryPoint        = 10;
+        zone->zoneDetails.size              = obj->GetData().GetSize();
+        zone->zoneDetails.entryPoint        = entryPoint;
 
         DissasmCodeZoneInitData initData      = {};
         initData.enableDeepScanDissasmOnStart = true;
@@ -565,6 +570,141 @@ TEST_CASE("DissasmFunctions", "[Dissasm]Functions")
     REQUIRE(!CheckExtractInsnHexValue("mov [0x123], eax", value, 5));
 }
 
+TEST_CASE("LinesIndex", "[Dissasm]LinesIndex")
+{
+    // the sizes change from line to line => the offsets from an anchor are the sum of the sizes
+    constexpr uint64 firstOffset = 0x10;
+    DissasmLinesIndex linesIndex;
+    std::vector<uint64> offsets;
+    uint64 offset = firstOffset;
+    for (uint32 line = 0; line < 3 * DissasmLinesIndex::ANCHOR_LINES + 5; line++) {
+        const auto size = static_cast<uint8>(1 + line % 15);
+        linesIndex.Add(offset, size);
+        offsets.push_back(offset);
+        offset += size;
+    }
+    REQUIRE(linesIndex.GetLinesCount() == offsets.size());
+
+    uint32 line = 0;
+    for (const uint32 expectedLine : { 0u, 63u, 64u, 65u, 127u, 128u, static_cast<uint32>(offsets.size() - 1) }) {
+        REQUIRE(linesIndex.GetOffset(expectedLine) == offsets[expectedLine]);
+        REQUIRE(linesIndex.FindLine(offsets[expectedLine], line));
+        REQUIRE(line == expectedLine);
+        // the last byte of the instruction
+        const auto size = static_cast<uint64>(1 + expectedLine % 15);
+        REQUIRE(linesIndex.FindLine(offsets[expectedLine] + size - 1, line));
+        REQUIRE(line == expectedLine);
+    }
+    for (uint32 index = 0; index < offsets.size(); index++)
+        REQUIRE(linesIndex.GetOffset(index) == offsets[index]);
+
+    REQUIRE(!linesIndex.FindLine(firstOffset - 1, line));
+    REQUIRE(!linesIndex.FindLine(offset, line));
+    REQUIRE(!linesIndex.FindLine(offset + 0x100, line));
+}
+
+TEST_CASE("UpdateLinesPassed", "[Dissasm]LinesIndex")
+{
+    DissasmTestInstance dissasmInstance(exampleTest1BinaryCode, exampleTest1BinaryCodeSize);
+    auto& zone = *dissasmInstance.zone;
+    REQUIRE(!zone.dissasmType.annotations.empty());
+
+    // the annotations from the start of the type up to the line (including it) are the text lines passed
+    const auto checkType = [&zone](DissasmCodeInternalType& type) {
+        for (uint32 line = type.indexZoneStart; line < type.indexZoneEnd; line++) {
+            uint32 textLines = 0;
+            for (const auto& annotation : type.annotations) {
+                if (annotation.first >= type.indexZoneStart && annotation.first <= line)
+                    textLines++;
+            }
+            zone.UpdateLinesPassed(type, line);
+            if (type.textLinesPassed != textLines || type.asmLinesPassed != line + 1 - type.indexZoneStart - textLines)
+                return false;
+        }
+        return true;
+    };
+    REQUIRE(checkType(zone.dissasmType));
+
+    REQUIRE(dissasmInstance.AddCollpasibleZone(0, 5));
+    zone.ResetZoneCaching();
+    REQUIRE(zone.dissasmType.internalTypes.size() == 2);
+    REQUIRE(checkType(zone.dissasmType.internalTypes[0]));
+    REQUIRE(checkType(zone.dissasmType.internalTypes[1]));
+
+    // the annotations after a collapsed zone are moved => the lines passed must not come from the previous positions
+    const auto annotationsCount = zone.dissasmType.internalTypes[1].annotations.size();
+    REQUIRE(annotationsCount > 0);
+    REQUIRE(dissasmInstance.CheckCollapseOrExtendZone(1, DissasmCodeZone::CollapseExpandType::Collapse));
+    REQUIRE(zone.dissasmType.internalTypes[0].isCollapsed);
+    REQUIRE(zone.dissasmType.internalTypes[1].annotations.size() == annotationsCount);
+    REQUIRE(checkType(zone.dissasmType.internalTypes[0]));
+    REQUIRE(checkType(zone.dissasmType.internalTypes[1]));
+
+    REQUIRE(dissasmInstance.CheckCollapseOrExtendZone(1, DissasmCodeZone::CollapseExpandType::Expand));
+    REQUIRE(checkType(zone.dissasmType.internalTypes[0]));
+    REQUIRE(checkType(zone.dissasmType.internalTypes[1]));
+}
+
+TEST_CASE("DeepScanRanges", "[Dissasm]FunctionsAnalysis")
+{
+    DissasmTestInstance dissasmInstance(exampleTest1BinaryCode, exampleTest1BinaryCodeSize);
+    auto& zone                 = *dissasmInstance.zone;
+    const auto zoneStart       = zone.cachedCodeOffsets[0].offset;
+    const auto instructionData = dissasmInstance.objects[0].GetData().Get(zone.zoneDetails.startingZonePoint, static_cast<uint32>(zone.zoneDetails.size), false);
+    REQUIRE(instructionData.IsValid());
+
+    const std::map<uint64, std::string> noFunctions;
+    std::vector<std::pair<uint64, std::string>> singleCalls;
+    REQUIRE(zone.DeepScan(instructionData, noFunctions, singleCalls, zone.linesIndex.GetLinesCount()));
+    const auto singleTable = zone.functionsTable;
+
+    // 0x30: "push ebp", 0x31: "mov ebp, esp"
+    uint32 pushLine = 0;
+    REQUIRE(zone.linesIndex.FindLine(0x30 - zoneStart, pushLine));
+    REQUIRE(singleTable.GetFunction(pushLine));
+    REQUIRE(!singleTable.branches.empty());
+
+    SECTION("the prologue is split between two ranges")
+    {
+        for (const uint32 linesPerWorker : { pushLine + 1, pushLine, 1u, 2u, 7u, 64u }) {
+            std::vector<std::pair<uint64, std::string>> calls;
+            REQUIRE(zone.DeepScan(instructionData, noFunctions, calls, linesPerWorker));
+            REQUIRE(calls == singleCalls);
+            REQUIRE(zone.functionsTable.functions == singleTable.functions);
+            REQUIRE(zone.functionsTable.blocks == singleTable.blocks);
+            REQUIRE(zone.functionsTable.branches == singleTable.branches);
+        }
+    }
+
+    SECTION("a known function without callers")
+    {
+        // 0x43: "cmp dword ptr [ebp + 8], 1" (after a call)
+        uint32 knownLine = 0;
+        REQUIRE(zone.linesIndex.FindLine(0x43 - zoneStart, knownLine));
+        REQUIRE(!singleTable.GetFunction(knownLine));
+
+        const std::map<uint64, std::string> knownFunctions = { { 0x43, "exported" } };
+        std::vector<std::pair<uint64, std::string>> calls;
+        REQUIRE(zone.DeepScan(instructionData, knownFunctions, calls, 3));
+        REQUIRE(zone.functionsTable.GetFunction(knownLine));
+        REQUIRE(std::find(calls.begin(), calls.end(), std::pair<uint64, std::string>(0x43, "exported")) != calls.end());
+    }
+}
+
+TEST_CASE("DeepScanPrologueX64", "[Dissasm]FunctionsAnalysis")
+{
+    // 0x00: "ret", 0x01: "push rbp", 0x02: "mov rbp, rsp", 0x05: "pop rbp", 0x06: "ret"
+    const unsigned char code[] = { 0xC3, 0x55, 0x48, 0x89, 0xE5, 0x5D, 0xC3 };
+    DissasmTestInstance dissasmInstance(code, sizeof(code), DisassemblyLanguage::x64, 0);
+    auto& zone = *dissasmInstance.zone;
+
+    uint32 pushLine = 0;
+    REQUIRE(zone.linesIndex.GetLinesCount() == 5);
+    REQUIRE(zone.linesIndex.FindLine(1, pushLine));
+    REQUIRE(zone.functionsTable.GetFunction(0));
+    REQUIRE(zone.functionsTable.GetFunction(pushLine));
+}
+
 TEST_CASE("AddAndCollapseCollapsibleZones", "[Dissasm]CollapsibleZones")
 {
     DissasmTestInstance dissasmInstance(exampleTest1BinaryCode, exampleTest1BinaryCodeSize);
@@ -906,4 +1046,142 @@ TEST_CASE("ValidatingComments", "[Dissasm]Comments")
         REQUIRE(dissasmInstance.RemoveComment(5));
         REQUIRE(!dissasmInstance.HasComment(5));
     }
-}
\ No newline at end of file
+}
+// a file with a unique name from the temporary folder, removed at the end of the test (even if a check fails)
+struct TemporaryCacheFile {
+    std::filesystem::path path;
+    TemporaryCacheFile() : path(std::filesystem::temp_directory_path() / ("gview_tests_" + std::to_string(std::random_device{}()) + ".dissasm.cache"))
+    {
+    }
+    ~TemporaryCacheFile()
+    {
+        std::error_code err;
+        std::filesystem::remove(path, err);
+    }
+};
+
+TEST_CASE("CacheRoundTrip", "[Dissasm]Cache")
+{
+    DissasmTestInstance dissasmInstance(exampleTest1BinaryCode, exampleTest1BinaryCodeSize);
+    auto& zone = *dissasmInstance.zone;
+    REQUIRE(dissasmInstance.AddOrUpdateComment(2, "c2"));
+    REQUIRE(dissasmInstance.AddOrUpdateComment(40, "c40"));
+    REQUIRE(!zone.dissasmType.annotations.empty());
+    REQUIRE(!zone.functionsTable.functions.empty());
+
+    SettingsData settings;
+    settings.disassemblyZones[0] = zone.zoneDetails;
+    DissasmCacheWriter writer;
+    REQUIRE(settings.SaveToCache(writer));
+    REQUIRE(writer.AddCodeZone(zone));
+    DissasmCacheFingerprint fingerprint;
+    REQUIRE(DissasmCache::ComputeFingerprint(&dissasmInstance.objects[0], fingerprint));
+    std::vector<uint8> content;
+    writer.Build(fingerprint, content);
+
+    const TemporaryCacheFile cacheFile;
+    const auto path = cacheFile.path.u16string();
+    DissasmCache cache;
+
+    SECTION("the zone is restored")
+    {
+        REQUIRE(DissasmCache::SaveCacheFile(path, content));
+        REQUIRE(cache.LoadCacheFile(path));
+        REQUIRE(settings.ValidateCacheData(cache, &dissasmInstance.objects[0]));
+        cache.hasCache = true;
+
+        auto restored            = std::make_unique<DissasmCodeZone>();
+        restored->startLineIndex = zone.startLineIndex;
+        restored->zoneDetails    = zone.zoneDetails;
+        uint32 totalLines        = 0;
+        REQUIRE(restored->TryLoadDataFromCache(cache, totalLines));
+        REQUIRE(totalLines == zone.dissasmType.indexZoneEnd - 2);
+
+        REQUIRE(restored->dissasmType.commentsData.comments == zone.dissasmType.commentsData.comments);
+        REQUIRE(restored->dissasmType.annotations == zone.dissasmType.annotations);
+        REQUIRE(restored->cachedCodeOffsets.size() == zone.cachedCodeOffsets.size());
+        for (size_t index = 0; index < zone.cachedCodeOffsets.size(); index++) {
+            REQUIRE(restored->cachedCodeOffsets[index].offset == zone.cachedCodeOffsets[index].offset);
+            REQUIRE(restored->cachedCodeOffsets[index].line == zone.cachedCodeOffsets[index].line);
+        }
+        REQUIRE(restored->linesIndex.GetAnchors() == zone.linesIndex.GetAnchors());
+        REQUIRE(restored->linesIndex.GetSizes() == zone.linesIndex.GetSizes());
+        REQUIRE(restored->functionsTable.functions == zone.functionsTable.functions);
+        REQUIRE(restored->functionsTable.blocks == zone.functionsTable.blocks);
+        REQUIRE(restored->functionsTable.branches == zone.functionsTable.branches);
+    }
+
+    SECTION("a cache from another version is rejected")
+    {
+        reinterpret_cast<DissasmCacheHeader*>(content.data())->version = DISSASM_CACHE_VERSION + 1;
+        REQUIRE(DissasmCache::SaveCacheFile(path, content));
+        REQUIRE(!cache.LoadCacheFile(path));
+    }
+
+    SECTION("a cache of a changed file is rejected")
+    {
+        reinterpret_cast<DissasmCacheHeader*>(content.data())->fingerprint.sampledPagesHash ^= 1;
+        REQUIRE(DissasmCache::SaveCacheFile(path, content));
+        REQUIRE(cache.LoadCacheFile(path));
+        REQUIRE(!settings.ValidateCacheData(cache, &dissasmInstance.objects[0]));
+    }
+
+    SECTION("a cache with records outside the zone is rejected")
+    {
+        const auto header = reinterpret_cast<const DissasmCacheHeader*>(content.data());
+        auto& record      = *reinterpret_cast<DissasmCacheCodeZone*>(content.data() + header->codeZonesOffset);
+        const auto TryLoad = [&]() {
+            cache.ClearCache(true); // the file is mapped => it is released before it is replaced
+            REQUIRE(DissasmCache::SaveCacheFile(path, content));
+            REQUIRE(cache.LoadCacheFile(path));
+            REQUIRE(settings.ValidateCacheData(cache, &dissasmInstance.objects[0]));
+            cache.hasCache = true;
+
+            auto restored            = std::make_unique<DissasmCodeZone>();
+            restored->startLineIndex = zone.startLineIndex;
+            restored->zoneDetails    = zone.zoneDetails;
+            uint32 totalLines        = 0;
+            return restored->TryLoadDataFromCache(cache, totalLines);
+        };
+        REQUIRE(TryLoad());
+
+        SECTION("annotation")
+        {
+            reinterpret_cast<DissasmCacheAnnotation*>(content.data() + record.annotations.offset)[0].line = record.totalLines;
+            REQUIRE(!TryLoad());
+        }
+        SECTION("comment")
+        {
+            reinterpret_cast<DissasmCacheComment*>(content.data() + record.comments.offset)[record.comments.count - 1].line = record.totalLines;
+            REQUIRE(!TryLoad());
+        }
+        SECTION("checkpoint")
+        {
+            reinterpret_cast<DissasmCacheCheckpoint*>(content.data() + record.checkpoints.offset)[0].offset = record.startingZonePoint + record.size + 1;
+            REQUIRE(!TryLoad());
+        }
+        SECTION("anchor")
+        {
+            reinterpret_cast<uint64*>(content.data() + record.anchors.offset)[record.anchors.count - 1] = record.size;
+            REQUIRE(!TryLoad());
+        }
+        SECTION("lines count")
+        {
+            record.totalLines++;
+            REQUIRE(!TryLoad());
+        }
+    }
+
+    SECTION("a truncated cache is rejected")
+    {
+        content.resize(content.size() - 1);
+        REQUIRE(DissasmCache::SaveCacheFile(path, content));
+        REQUIRE(!cache.LoadCacheFile(path));
+
+        content.resize(sizeof(DissasmCacheHeader) - 1);
+        REQUIRE(DissasmCache::SaveCacheFile(path, content));
+        REQUIRE(!cache.LoadCacheFile(path));
+    }
+
+    cache.ClearCache(true); // the file is mapped => it is released before it is removed
+}
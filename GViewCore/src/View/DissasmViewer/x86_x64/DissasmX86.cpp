@@ -218,13 +218,27 @@ inline void DissasmAddColorsToInstruction(
     // string.SetFormat("0x%" PRIx64 ":           %s %s", insn[j].address, insn[j].mnemonic, insn[j].op_str);
 }
 
-inline cs_insn* GetCurrentInstructionByLine(
+// the instruction is owned by the zone (it is valid until the zone decodes again)
+inline const cs_insn* GetCurrentInstructionByLine(
       uint32 lineToReach, DissasmCodeZone* zone, Reference<GView::Object> obj, uint32& diffLines, DrawLineInfo* dli = nullptr)
 {
+    if (diffLines != 1) {
+        const auto cachedInsn = zone->decodedLines.Get(lineToReach);
+        if (cachedInsn)
+            return cachedInsn;
+    }
+
+    auto& decoder          = zone->decoder;
     uint32 lineDifferences = 1;
-    // TODO: first or be transformed into an abs ?
-    const bool lineIsAtMargin = lineToReach >= zone->offsetCacheMaxLine;
-    if (lineToReach < zone->lastDrawnLine || lineToReach - zone->lastDrawnLine > 1 || lineIsAtMargin) {
+    if (lineToReach < zone->linesIndex.GetLinesCount()) {
+        // the offset of the line is known => only the instruction from that line is decoded
+        // (the data of an anchor has only its lines => the first line of the next anchor is sought as well)
+        const bool sameAnchor = lineToReach - lineToReach % DissasmLinesIndex::ANCHOR_LINES == zone->lastClosestLine;
+        if ((lineToReach != decoder.nextLine || !sameAnchor) && !zone->SeekAsmLine(lineToReach, obj, dli)) {
+            diffLines = UINT32_MAX;
+            return nullptr;
+        }
+    } else if (decoder.nextLine == DissasmDecoder::INVALID_LINE || lineToReach < decoder.nextLine || lineToReach >= zone->offsetCacheMaxLine) {
         // TODO: can be inlined as function
         uint32 codeOffsetIndex      = 0;
         const auto closestData      = SearchForClosestAsmOffsetLineByLine(zone->cachedCodeOffsets, lineToReach, &codeOffsetIndex);
@@ -244,45 +258,39 @@ inline cs_insn* GetCurrentInstructionByLine(
             if (!instructionData.IsValid()) {
                 if (dli)
                     dli->WriteErrorToScreen("ERROR: extract valid data from file!");
-                diffLines = UINT32_MAX;
+                decoder.nextLine = DissasmDecoder::INVALID_LINE;
+                diffLines        = UINT32_MAX;
                 return nullptr;
             }
         }
-        zone->asmData = const_cast<uint8*>(zone->lastData.GetData());
-        // if (lineInView > zone->lastDrawnLine)
-        //     lineDifferences = lineInView - zone->lastDrawnLine + 1;
-        lineDifferences = lineToReach - closestData.line + 1;
+        zone->asmData    = const_cast<uint8*>(zone->lastData.GetData());
+        zone->asmSize    = zone->lastData.GetLength();
+        decoder.nextLine = closestData.line;
     }
+    // the instructions are decoded from the current position when the line is after it (it is closer than the checkpoint)
+    lineDifferences = lineToReach - decoder.nextLine + 1;
 
     if (diffLines == 1) {
         diffLines = lineDifferences;
         return nullptr;
     }
 
-    // TODO: keep the handle open and insn open until the program ends
-    csh handle;
-    const auto resCode = cs_open(CS_ARCH_X86, static_cast<cs_mode>(zone->internalArchitecture), &handle);
-    if (resCode != CS_ERR_OK) {
-        if (dli)
-            dli->WriteErrorToScreen(cs_strerror(resCode));
-        cs_close(&handle);
+    if (!decoder.Open(zone->internalArchitecture, dli))
         return nullptr;
-    }
-
-    cs_insn* insn = cs_malloc(handle);
 
+    const cs_insn* insn = nullptr;
     while (lineDifferences > 0) {
-        if (!cs_disasm_iter(handle, &zone->asmData, (size_t*) &zone->asmSize, &zone->asmAddress, insn)) {
+        if (!cs_disasm_iter(decoder.handle, &zone->asmData, (size_t*) &zone->asmSize, &zone->asmAddress, decoder.insn)) {
             if (dli)
                 dli->WriteErrorToScreen("Failed to dissasm!");
-            cs_free(insn, 1);
-            cs_close(&handle);
+            decoder.nextLine = DissasmDecoder::INVALID_LINE;
             return nullptr;
         }
+        // the skipped instructions are kept as well (going back a few lines does not decode them again)
+        insn = zone->decodedLines.Add(decoder.nextLine++, *decoder.insn);
         lineDifferences--;
     }
 
-    cs_close(&handle);
     return insn;
 }
 
@@ -297,6 +305,18 @@ inline const MemoryMappingEntry* TryExtractMemoryMapping(const Pointer<SettingsD
     return nullptr;
 }
 
+// the details of a known function are stored by the JAMCRC of its name
+inline const AsmFunctionDetails* TryExtractFunctionDetails(const AsmData& asmData, std::string_view name)
+{
+    GView::Hashes::CRC32 crc32{};
+    uint32 hash = 0;
+    if (!crc32.Init(GView::Hashes::CRC32Type::JAMCRC) || !crc32.Update(reinterpret_cast<const uint8*>(name.data()), static_cast<uint32>(name.size())) ||
+        !crc32.Final(hash))
+        return nullptr;
+    const auto it = asmData.functions.find(hash);
+    return it != asmData.functions.end() ? it->second : nullptr;
+}
+
 inline optional<vector<uint8>> TryExtractPushText(Reference<GView::Object> obj, const uint64_t offset)
 {
     const auto stringBuffer = obj->GetData().Get(offset, DISSAM_MAXIMUM_STRING_PREVIEW * 2, false);
@@ -364,18 +384,8 @@ std::optional<uint32> DissasmGetCurrentAsmLineAndPrepareCodeZone(DissasmCodeZone
     }
 
     DissasmCodeInternalType& currentType = zone->types.back();
-    // TODO: do a faster search using a binary search using the annotations and start from there
-    // TODO: maybe use some caching here?
     if (reAdapt || levelNow < levelToReach && levelNow + 1 != levelToReach || levelNow > levelToReach && levelNow - 1 != levelToReach) {
-        currentType.textLinesPassed = 0;
-        currentType.asmLinesPassed  = 0;
-        for (uint32 i = currentType.indexZoneStart; i <= levelToReach; i++) {
-            if (currentType.annotations.contains(i)) {
-                currentType.textLinesPassed++;
-                continue;
-            }
-            currentType.asmLinesPassed++;
-        }
+        zone->UpdateLinesPassed(currentType, levelToReach);
     } else {
         if (currentType.annotations.contains(levelToReach))
             currentType.textLinesPassed++;
@@ -426,8 +436,8 @@ bool DissasmAsmPreCacheLine::TryGetDataFromAnnotations(const DissasmCodeInternal
 
 bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& params)
 {
-    uint32 diffLines = 0;
-    cs_insn* insn    = GetCurrentInstructionByLine(params.asmLine, params.zone, params.obj, diffLines, params.dli);
+    uint32 diffLines    = 0;
+    const cs_insn* insn = GetCurrentInstructionByLine(params.asmLine, params.zone, params.obj, diffLines, params.dli);
     if (!insn)
         return false;
 
@@ -440,7 +450,6 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
         op_str      = strdup(params.zoneName->c_str());
         op_str_size = static_cast<uint32>(params.zoneName->size());
         strncpy(mnemonic, "collapsed", std::min<uint32>(sizeof(mnemonic), 9));
-        cs_free(insn, 1);
         return true;
     }
 
@@ -463,14 +472,28 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
             op_str      = strdup(insn->op_str);
             op_str_size = static_cast<uint32>(strlen(op_str));
             // params.zone->asmPreCacheData.cachedAsmLines.push_back(std::move(asmCacheLine));
-            cs_free(insn, 1);
             return true;
         }
     }
 
-    // TODO: improve efficiency by filtering instructions
-    uint64 hexVal = 0;
-    if (CheckExtractInsnHexValue(insn->op_str, hexVal, params.settings->maxLocationMemoryMappingSize)) {
+    // the deep scan has the targets of the calls and the jumps (the operand text is parsed for the others)
+    uint64 hexVal                   = 0;
+    const std::string* functionName = nullptr;
+    const auto branch               = params.zone->functionsTable.GetBranch(params.asmLine);
+    if (branch && !branch->indirect) {
+        // the target is a line of the zone => its file offset, the same as its label
+        hexVal       = branch->target;
+        hexValue     = params.zone->cachedCodeOffsets[0].offset + branch->target;
+        branchTarget = branch->target;
+        uint32 targetLine;
+        if (params.zone->linesIndex.FindLine(branch->target, targetLine) && params.zone->functionsTable.GetFunction(targetLine)) {
+            const auto knownFunction = params.settings->knownFunctions.find(hexValue.value());
+            if (knownFunction != params.settings->knownFunctions.end())
+                functionName = &knownFunction->second;
+        }
+    } else if (branch || CheckExtractInsnHexValue(insn->op_str, hexVal, params.settings->maxLocationMemoryMappingSize)) {
+        if (branch)
+            hexVal = branch->target;
         hexValue = hexVal;
         if (hexVal == 0 && flags != DissasmAsmPreCacheLine::InstructionFlag::PushFlag)
             hexValue = params.zone->cachedCodeOffsets[0].offset;
@@ -481,7 +504,7 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
     if (params.zone->asmPreCacheData.HasAnyFlag(params.asmLine))
         alreadyInitComment = true;
 
-    const uint64 finalIndex = params.zone->asmAddress + params.settings->offsetTranslateCallback->TranslateFromFileOffset(
+    const uint64 finalIndex = insn->address + insn->size + params.settings->offsetTranslateCallback->TranslateFromFileOffset(
                                                               params.zone->zoneDetails.entryPoint, (uint32) DissasmPEConversionType::RVA);
     auto& lastZone          = params.zone->types.back().get();
     bool shouldConsiderCall = false;
@@ -501,22 +524,22 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
             mapping     = mappingPtr;
             op_str_size = (uint32) mappingPtr->name.size();
             if (mappingPtr->type == MemoryMappingType::FunctionMapping && !alreadyInitComment) {
-                // TODO: add functions to the obj AsmData to search for name instead of manually doing CRC
-                GView::Hashes::CRC32 crc32{};
-                uint32 hash    = 0;
-                const bool res = crc32.Init(GView::Hashes::CRC32Type::JAMCRC) &&
-                                 crc32.Update(reinterpret_cast<const uint8*>(mappingPtr->name.data()), static_cast<uint32>(mappingPtr->name.size())) &&
-                                 crc32.Final(hash);
-                if (res) {
-                    const auto it = params.asmData->functions.find(hash);
-                    if (it != params.asmData->functions.end()) {
-                        params.zone->asmPreCacheData.AnnounceCallInstruction(params.zone, it->second, lastZone.commentsData);
-                        params.zone->asmPreCacheData.AddInstructionFlag(params.asmLine, DissasmAsmPreCacheLine::CallFlag);
-                    }
+                const auto details = TryExtractFunctionDetails(*params.asmData, mappingPtr->name);
+                if (details) {
+                    params.zone->asmPreCacheData.AnnounceCallInstruction(params.zone, details, lastZone.commentsData);
+                    params.zone->asmPreCacheData.AddInstructionFlag(params.asmLine, DissasmAsmPreCacheLine::CallFlag);
                 }
             }
         } else {
             shouldConsiderCall = true;
+            // a call to a known function of the zone (an export) has its name and its details
+            if (functionName && !alreadyInitComment) {
+                const auto details = TryExtractFunctionDetails(*params.asmData, *functionName);
+                if (details) {
+                    params.zone->asmPreCacheData.AnnounceCallInstruction(params.zone, details, lastZone.commentsData);
+                    params.zone->asmPreCacheData.AddInstructionFlag(params.asmLine, DissasmAsmPreCacheLine::CallFlag);
+                }
+            }
         }
     } else if (flags == DissasmAsmPreCacheLine::InstructionFlag::PushFlag) {
         if (!alreadyInitComment && !lastZone.commentsData.comments.contains(params.actualLine)) {
@@ -540,7 +563,6 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
             op_str      = strdup(insn->op_str);
             op_str_size = static_cast<uint32>(strlen(op_str));
             // params.zone->asmPreCacheData.cachedAsmLines.push_back(std::move(asmCacheLine));
-            cs_free(insn, 1);
             return true;
         }
 
@@ -550,6 +572,8 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
         const auto res = n.ToString(hexValue.value(), { NumericFormatFlags::HexPrefix, 16 });
 
         auto fnName = FormatFunctionName(hexValue.value(), prefix);
+        if (functionName && shouldConsiderCall)
+            fnName.Set(functionName->c_str());
         fnName.AddFormat(" (%s)", res.data());
 
         op_str      = strdup(fnName.GetText());
@@ -561,7 +585,6 @@ bool DissasmAsmPreCacheLine::TryGetDataFromInsn(DissasmInsnExtractLineParams& pa
         op_str_size = (uint32) strlen(op_str);
     }
     // params.zone->asmPreCacheData.cachedAsmLines.push_back(std::move(asmCacheLine));
-    cs_free(insn, 1);
     return true;
 }
 
@@ -594,15 +617,27 @@ void DissasmAsmPreCacheData::PrepareLabelArrows()
     std::vector<DissasmAsmPreCacheLine*> startInstructions;
     startInstructions.reserve(textColumnIndicatorArrowLinesSpace);
 
-    for (auto& line : cachedAsmLines) {
+    std::vector<DissasmAsmPreCacheLine*> actualLabelsLines;
+    actualLabelsLines.reserve(textColumnIndicatorArrowLinesSpace);
+
+    for (auto& line : cachedAsmLines)
         line.lineArrowToDraw = 0;
+    // the targets come from the deep scan, they have the same addresses as the drawn lines
+    for (auto& line : cachedAsmLines) {
         if (line.flags != DissasmAsmPreCacheLine::InstructionFlag::CallFlag && line.flags != DissasmAsmPreCacheLine::InstructionFlag::JmpFlag)
             continue;
-        if (!line.hexValue.has_value())
+        if (!line.branchTarget.has_value())
+            continue;
+        const auto target = line.branchTarget.value();
+        if (target < minimalAddress || target > maximalAddress)
             continue;
-        if (line.hexValue.value() < minimalAddress || line.hexValue.value() > maximalAddress)
+        // the first line with the address is the label of the target (if it has one)
+        const auto targetLine = std::find_if(
+              cachedAsmLines.begin(), cachedAsmLines.end(), [target](const DissasmAsmPreCacheLine& cachedLine) { return cachedLine.address == target; });
+        if (targetLine == cachedAsmLines.end())
             continue;
         startInstructions.push_back(&line);
+        actualLabelsLines.push_back(&(*targetLine));
         if (startInstructions.size() >= textColumnIndicatorArrowLinesSpace)
             break;
     }
@@ -610,28 +645,6 @@ void DissasmAsmPreCacheData::PrepareLabelArrows()
     if (startInstructions.empty())
         return;
 
-    std::sort(startInstructions.begin(), startInstructions.end(), [](const DissasmAsmPreCacheLine* a, const DissasmAsmPreCacheLine* b) {
-        return a->hexValue.value() < b->hexValue.value();
-    });
-
-    std::vector<DissasmAsmPreCacheLine*> actualLabelsLines;
-    actualLabelsLines.reserve(startInstructions.size());
-
-    {
-        auto cacheLineIt = cachedAsmLines.begin();
-        auto labelIt     = startInstructions.begin();
-        while (labelIt != startInstructions.end() && cacheLineIt != cachedAsmLines.end()) {
-            if (cacheLineIt->address == (*labelIt)->hexValue.value()) {
-                actualLabelsLines.push_back(&(*cacheLineIt));
-                ++labelIt;
-            } else
-                ++cacheLineIt;
-            //++cacheLineIt;
-        }
-    }
-
-    assert(startInstructions.size() == actualLabelsLines.size());
-
     auto startOpIt   = startInstructions.begin();
     auto endOpIt     = actualLabelsLines.begin();
     uint32 lineIndex = 0;
@@ -709,17 +722,13 @@ bool Instance::DrawDissasmX86AndX64CodeZone(DrawLineInfo& dli, DissasmCodeZone*
                 initData.dli                          = &dli;
                 initData.maxLocationMemoryMappingSize = settings->maxLocationMemoryMappingSize;
                 initData.visibleRows                  = Layout.visibleRows;
+                initData.cache                        = &cacheData;
+                initData.knownFunctions               = &settings->knownFunctions;
 
                 if (!zone->InitZone(initData))
                     return false;
                 if (initData.hasAdjustedSize)
                     AdjustZoneExtendedSize(zone, initData.adjustedZoneSize);
-                if (!zone->TryLoadDataFromCache(cacheData)) {
-                    //TODO: will enable errors in the next version
-                    //dli.WriteErrorToScreen("ERROR: failed to load data from cache!");
-                    //return false;
-                
-                }
             }
         }
 
@@ -784,6 +793,8 @@ bool Instance::DrawDissasmX86AndX64CodeZone(DrawLineInfo& dli, DissasmCodeZone*
             initData.dli                          = &dli;
             initData.maxLocationMemoryMappingSize = settings->maxLocationMemoryMappingSize;
             initData.visibleRows                  = Layout.visibleRows;
+            initData.cache                        = &cacheData;
+            initData.knownFunctions               = &settings->knownFunctions;
 
             if (!zone->InitZone(initData))
                 return false;
@@ -933,7 +944,7 @@ void Instance::DissasmZoneProcessSpaceKey(DissasmCodeZone* zone, uint32 line, ui
 {
     uint32 diffLines     = 0;
     uint64 computedValue = 0;
-    cs_insn* insn;
+    const cs_insn* insn;
     if (!offsetToReach) {
         if (line <= 1)
             return;
@@ -958,7 +969,7 @@ void Instance::DissasmZoneProcessSpaceKey(DissasmCodeZone* zone, uint32 line, ui
         }
         if (insn->mnemonic[0] == 'j' || insn->mnemonic[0] == 'c' && *(uint32*) insn->mnemonic == callOP) {
             if (insn->op_str[0] == '0' && insn->op_str[1] == 'x') {
-                char* val = &insn->op_str[2];
+                const char* val = &insn->op_str[2];
 
                 while (*val && *val != ',' && *val != ' ') {
                     if (*val >= '0' && *val <= '9')
@@ -975,12 +986,9 @@ void Instance::DissasmZoneProcessSpaceKey(DissasmCodeZone* zone, uint32 line, ui
             } else if (insn->op_str[0] >= '0' && insn->op_str[0] <= '9' && insn->op_str[1] == '\0') {
                 computedValue = zone->cachedCodeOffsets[0].offset + (insn->op_str[0] - '0');
             } else {
-                cs_free(insn, 1);
                 return;
             }
-            cs_free(insn, 1);
         } else {
-            cs_free(insn, 1);
             return;
         }
     } else
@@ -1000,7 +1008,6 @@ void Instance::DissasmZoneProcessSpaceKey(DissasmCodeZone* zone, uint32 line, ui
         Dialogs::MessageBox::ShowNotification("Warning", "There was an error reaching that line!");
         return;
     }
-    cs_free(insn, 1);
 
     // diffLines++; // increased because of the menu bar
 
@@ -1347,6 +1354,8 @@ bool DissasmCodeZone::CollapseOrExtendZone(uint32 zoneLine, CollapseExpandType c
     if (difference) {
         difference += (int32) this->dissasmType.indexZoneEnd - 1;
     }
+    // the lines (and the annotations) after the zone were moved
+    ResetZoneCaching();
 
     return true;
 }
@@ -1365,10 +1374,14 @@ bool DissasmCodeZone::RemoveCollapsibleZone(uint32 zoneLine)
 void DissasmCodeZone::ResetZoneCaching()
 {
     asmPreCacheData.Clear();
+    annotationsLines.clear(); // the annotations (or the types) might be changed
     for (auto& type : types) {
         type.get().asmLinesPassed  = 0;
         type.get().textLinesPassed = 0;
     }
+    // the next asm line is sought again from its anchor
+    lastClosestLine  = DissasmDecoder::INVALID_LINE;
+    decoder.nextLine = DissasmDecoder::INVALID_LINE;
 }
 
 bool DissasmCodeZone::AddCollapsibleZone(uint32 zoneLineStart, uint32 zoneLineEnd)
@@ -0,0 +1,146 @@
+#include "GridViewer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    define GRIDVIEWER_SSE2
+#    include <emmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+using namespace GView::View::GridViewer;
+
+constexpr uint32 INDEX_CHUNK_SIZE = 0x100000; // bytes read at once
+constexpr uint64 MAX_ROW_SIZE     = 0xFFFFFFFF;
+
+#ifdef GRIDVIEWER_SSE2
+static inline uint32 FirstSetBit(uint32 mask)
+{
+#    if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32>(index);
+#    else
+    return static_cast<uint32>(__builtin_ctz(mask));
+#    endif
+}
+#endif
+
+// first byte from [p, e) that is a separator, a quote or a line break ('e' if there is none)
+static const uint8* FindSpecialByte(const uint8* p, const uint8* e, uint8 separator)
+{
+#ifdef GRIDVIEWER_SSE2
+    const auto sep   = _mm_set1_epi8(static_cast<char>(separator));
+    const auto quote = _mm_set1_epi8('"');
+    const auto lf    = _mm_set1_epi8('\n');
+    const auto cr    = _mm_set1_epi8('\r');
+    for (; p + 16 <= e; p += 16) {
+        const auto v     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto cells = _mm_or_si128(_mm_cmpeq_epi8(v, sep), _mm_cmpeq_epi8(v, quote));
+        const auto rows  = _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr));
+        const auto mask  = static_cast<uint32>(_mm_movemask_epi8(_mm_or_si128(cells, rows)));
+        if (mask) {
+            return p + FirstSetBit(mask);
+        }
+    }
+#endif
+    for (; p < e; p++) {
+        if ((*p == separator) || (*p == '"') || (*p == '\n') || (*p == '\r')) {
+            return p;
+        }
+    }
+    return e;
+}
+
+void CellsIndex::Clear()
+{
+    rows.clear();
+    cells.clear();
+    maxCellsPerRow = 0;
+}
+
+bool CellsIndex::Build(GView::Utils::DataCache& cache, char separator)
+{
+    /*
+        One pass over the file (a state machine, the rows and the cells can be split between chunks):
+        - a separator starts a new cell, a line break (CR, LF, CRLF or LFCR) starts a new row
+        - a quote toggles the quoted state (an escaped quote "" toggles it twice); between quotes only the quotes matter
+        - an empty row at the end of the file (after the last line break) is not added
+    */
+    Clear();
+    const auto size = cache.GetSize();
+    const auto sep  = static_cast<uint8>(separator);
+
+    uint64 rowStart     = 0;
+    uint64 rowFirstCell = 0;
+    uint8 pending       = 0; // the second character of a CR/LF pair (skipped if it follows the line break)
+    bool quoted         = false;
+
+    // the first cell of every row starts at offset 0 (the row is added when it is closed)
+    cells.push_back(0);
+
+    GView::Utils::DataCache::SequentialReader reader(cache, 0, size, INDEX_CHUNK_SIZE);
+    for (auto chunk = reader.Next(); !chunk.Empty(); chunk = reader.Next()) {
+        const auto base = reader.GetChunkOffset();
+        const auto b    = chunk.GetData();
+        const auto e    = b + chunk.GetLength();
+        auto p          = b;
+        if ((pending != 0) && (p < e)) {
+            if (*p == pending) {
+                p++;
+                rowStart++;
+            }
+            pending = 0;
+        }
+        while (p < e) {
+            if (quoted) {
+                p = reinterpret_cast<const uint8*>(memchr(p, '"', static_cast<size_t>(e - p)));
+                if (p == nullptr) {
+                    break;
+                }
+                quoted = false;
+                p++;
+                continue;
+            }
+            p = FindSpecialByte(p, e, sep);
+            if (p == e) {
+                break;
+            }
+            const auto offset = base + static_cast<uint64>(p - b);
+            CHECK(offset - rowStart < MAX_ROW_SIZE, false, "Row %llu is too big (starts at 0x%llX)", static_cast<uint64>(rows.size()), rowStart);
+            const auto ch = *p;
+            p++;
+            if (ch == '"') {
+                quoted = true;
+            } else if (ch == sep) {
+                cells.push_back(static_cast<uint32>(offset + 1 - rowStart));
+            } else {
+                rows.push_back({ rowStart, rowFirstCell, static_cast<uint32>(offset - rowStart) });
+                maxCellsPerRow = std::max<>(maxCellsPerRow, static_cast<uint32>(cells.size() - rowFirstCell));
+                rowStart       = offset + 1;
+                rowFirstCell   = cells.size();
+                cells.push_back(0);
+                pending = ch == '\n' ? '\r' : '\n';
+                if (p < e) {
+                    if (*p == pending) {
+                        p++;
+                        rowStart++;
+                    }
+                    pending = 0;
+                }
+            }
+        }
+    }
+    CHECK(reader.HasFailed() == false, false, "Fail to read the content of the file");
+
+    if (rowStart < size) {
+        CHECK(size - rowStart < MAX_ROW_SIZE, false, "Row %llu is too big (starts at 0x%llX)", static_cast<uint64>(rows.size()), rowStart);
+        rows.push_back({ rowStart, rowFirstCell, static_cast<uint32>(size - rowStart) });
+        maxCellsPerRow = std::max<>(maxCellsPerRow, static_cast<uint32>(cells.size() - rowFirstCell));
+    } else {
+        cells.pop_back();
+    }
+    rows.shrink_to_fit();
+    cells.shrink_to_fit();
+    return true;
+}
@@ -0,0 +1,429 @@
+#include "GridViewer.hpp"
+
+#include <thread>
+#include <numeric>
+#include <cmath>
+
+using namespace GView::View::GridViewer;
+
+constexpr uint32 ENGINE_CHUNK_SIZE   = 0x100000; // bytes read at once (by every worker)
+constexpr uint64 MIN_ROWS_PER_WORKER = 0x4000;
+constexpr uint32 KEY_SIZE            = 8;
+constexpr uint8 KEY_CONTINUES        = KEY_SIZE + 1; // the cell has more bytes after the current key
+
+/*
+    The rows are never copied: every worker streams a range of consecutive rows (with its own SequentialReader) and
+    gets a pointer to the bytes of every row (a row that crosses a chunk boundary is assembled in a small buffer).
+
+    Sort - the value of the column is extracted once in a 64 bit key that preserves the order:
+    - numbers: the bits of the double (the negative ones inverted)
+    - dates  : YYYYMMDDhhmmss
+    - strings: the first 8 bytes (big endian) + how many bytes the cell has (up to 9 => it continues)
+    Empty cells have the key 0 (they are the first ones). The permutation is sorted with a parallel merge sort on these
+    keys. Strings with the same first 8 bytes are ordered by the next 8 bytes (only for those rows), until every run of
+    equal keys is made of equal strings.
+
+    Filter - the rows are tested by all workers in file order, the permutation keeps its order.
+*/
+
+static uint32 GetWorkersCount(uint64 count)
+{
+    const auto workers = std::max<uint64>(count / MIN_ROWS_PER_WORKER, 1);
+    return static_cast<uint32>(std::min<uint64>(workers, std::max<>(std::thread::hardware_concurrency(), 1U)));
+}
+
+static std::string_view GetCellValue(const CellsIndex& index, uint64 row, uint32 column, const uint8* rowData)
+{
+    if (column >= index.GetCellsCount(row)) {
+        return {};
+    }
+    const auto [start, end] = index.GetCell(row, column);
+    std::string_view value(reinterpret_cast<const char*>(rowData) + start, static_cast<size_t>(end - start));
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+    }
+    return value;
+}
+
+// [sign] digits [. digits] [e [sign] digits]
+static bool ParseNumber(std::string_view text, double& result)
+{
+    auto p        = text.data();
+    const auto e  = p + text.size();
+    const auto sg = (p < e && (*p == '-' || *p == '+')) ? *p++ : '+';
+
+    double value = 0.0;
+    auto digits  = 0U;
+    for (; p < e && *p >= '0' && *p <= '9'; p++, digits++) {
+        value = value * 10.0 + (*p - '0');
+    }
+    auto exponent = 0;
+    if (p < e && *p == '.') {
+        for (p++; p < e && *p >= '0' && *p <= '9'; p++, digits++) {
+            value = value * 10.0 + (*p - '0');
+            exponent--;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (p < e && (*p == 'e' || *p == 'E')) {
+        p++;
+        const auto negative = p < e && *p == '-';
+        if (p < e && (*p == '-' || *p == '+')) {
+            p++;
+        }
+        if (p == e) {
+            return false;
+        }
+        auto power = 0;
+        for (; p < e && *p >= '0' && *p <= '9'; p++) {
+            power = std::min<>(power * 10 + (*p - '0'), 10000);
+        }
+        exponent += negative ? -power : power;
+    }
+    if (p != e) {
+        return false;
+    }
+    value  = exponent == 0 ? value : value * std::pow(10.0, exponent);
+    result = sg == '-' ? -value : value;
+    return std::isfinite(result);
+}
+
+// YYYY-MM-DD or YYYY/MM/DD or YYYY.MM.DD, optionally followed by (' ' or 'T') hh:mm[:ss[.fraction]]
+static bool ParseDate(std::string_view text, uint64& result)
+{
+    const auto Number = [&text](size_t pos, size_t count, uint32 min, uint32 max, uint32& value) {
+        if (pos + count > text.size()) {
+            return false;
+        }
+        value = 0;
+        for (auto idx = pos; idx < pos + count; idx++) {
+            if (text[idx] < '0' || text[idx] > '9') {
+                return false;
+            }
+            value = value * 10 + (text[idx] - '0');
+        }
+        return (value >= min) && (value <= max);
+    };
+    uint32 year, month, day, hour = 0, minute = 0, second = 0;
+    if (!Number(0, 4, 0, 9999, year) || !Number(5, 2, 1, 12, month) || !Number(8, 2, 1, 31, day)) {
+        return false;
+    }
+    if ((text[4] != '-' && text[4] != '/' && text[4] != '.') || text[7] != text[4]) {
+        return false;
+    }
+    if (text.size() > 10) {
+        if ((text[10] != ' ' && text[10] != 'T') || !Number(11, 2, 0, 23, hour) || text.size() < 16 || text[13] != ':' || !Number(14, 2, 0, 59, minute)) {
+            return false;
+        }
+        if (text.size() > 16) {
+            if (text[16] != ':' || !Number(17, 2, 0, 60, second)) {
+                return false;
+            }
+            // fractions of a second (or a time zone) do not change the order of most files => ignored
+            if (text.size() > 19 && text[19] != '.' && text[19] != 'Z' && text[19] != '+' && text[19] != '-') {
+                return false;
+            }
+        }
+    }
+    result = ((((year * 100ULL + month) * 100ULL + day) * 100ULL + hour) * 100ULL + minute) * 100ULL + second;
+    return true;
+}
+
+// calls 'fn(row, rowData)' for every row from [firstRow, lastRow), in order
+template <typename T>
+static bool ForEachRow(GView::Utils::DataCache& cache, const CellsIndex& index, uint64 firstRow, uint64 lastRow, T&& fn)
+{
+    if (firstRow >= lastRow) {
+        return true;
+    }
+    const auto start = index.GetRowOffset(firstRow);
+    const auto end   = index.GetRowOffset(lastRow - 1) + index.GetRowSize(lastRow - 1);
+    if (start == end) {
+        // only empty rows (nothing to read)
+        for (auto row = firstRow; row < lastRow; row++) {
+            fn(row, nullptr);
+        }
+        return true;
+    }
+
+    std::vector<uint8> carry; // the first part of the row that continues in the next chunk
+    auto row = firstRow;
+    GView::Utils::DataCache::SequentialReader reader(cache, start, end - start, ENGINE_CHUNK_SIZE);
+    for (auto chunk = reader.Next(); !chunk.Empty() && row < lastRow; chunk = reader.Next()) {
+        const auto chunkStart = reader.GetChunkOffset();
+        const auto chunkEnd   = chunkStart + chunk.GetLength();
+        for (; row < lastRow; row++) {
+            const auto rowStart = index.GetRowOffset(row);
+            const auto rowEnd   = rowStart + index.GetRowSize(row);
+            const auto from     = std::max<>(rowStart, chunkStart);
+            if (rowEnd > chunkEnd) {
+                if (from < chunkEnd) {
+                    carry.insert(carry.end(), chunk.GetData() + (from - chunkStart), chunk.end());
+                }
+                break;
+            }
+            if (rowStart >= chunkStart) {
+                fn(row, chunk.GetData() + (rowStart - chunkStart));
+            } else {
+                carry.insert(carry.end(), chunk.GetData(), chunk.GetData() + (rowEnd - chunkStart));
+                fn(row, carry.data());
+                carry.clear();
+            }
+        }
+    }
+    CHECK(reader.HasFailed() == false, false, "Fail to read rows [%llu, %llu)", firstRow, lastRow);
+    CHECK(row == lastRow, false, "Rows [%llu, %llu) were not read", row, lastRow);
+    return true;
+}
+
+// the same as ForEachRow (with the index of the worker as the first parameter), the rows are split between workers
+template <typename T>
+static bool ForEachRowParallel(GView::Utils::DataCache& cache, const CellsIndex& index, uint64 firstRow, uint64 lastRow, T&& fn)
+{
+    if (firstRow >= lastRow) {
+        return true;
+    }
+    const auto count   = lastRow - firstRow;
+    const auto workers = GetWorkersCount(count);
+    std::vector<uint8> results(workers, 0);
+    std::vector<std::thread> threads;
+    for (auto worker = 0U; worker < workers; worker++) {
+        const auto b = firstRow + count * worker / workers;
+        const auto e = firstRow + count * (worker + 1) / workers;
+        threads.emplace_back([&cache, &index, &fn, &results, worker, b, e]() {
+            results[worker] = ForEachRow(cache, index, b, e, [&fn, worker](uint64 row, const uint8* data) { fn(worker, row, data); });
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return std::find(results.begin(), results.end(), 0) == results.end();
+}
+
+// stable sort: every worker sorts a part, then the parts are merged in pairs (in parallel)
+template <typename Less>
+static void ParallelStableSort(std::vector<uint64>& items, Less less)
+{
+    const auto workers = GetWorkersCount(items.size());
+    if (workers == 1) {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+    std::vector<size_t> bounds(workers + 1);
+    for (auto idx = 0U; idx <= workers; idx++) {
+        bounds[idx] = static_cast<size_t>(items.size() * idx / workers);
+    }
+
+    std::vector<std::thread> threads;
+    for (auto idx = 0U; idx < workers; idx++) {
+        threads.emplace_back([&items, &bounds, &less, idx]() { std::stable_sort(items.begin() + bounds[idx], items.begin() + bounds[idx + 1], less); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<uint64> buffer(items.size());
+    auto src = &items;
+    auto dst = &buffer;
+    for (auto width = 1U; width < workers; width *= 2) {
+        threads.clear();
+        for (auto idx = 0U; idx < workers; idx += 2 * width) {
+            const auto lo  = bounds[idx];
+            const auto mid = bounds[std::min<>(idx + width, workers)];
+            const auto hi  = bounds[std::min<>(idx + 2 * width, workers)];
+            threads.emplace_back([src, dst, &less, lo, mid, hi]() {
+                // std::merge takes the element from the first range when they are equal => stable
+                std::merge(src->begin() + lo, src->begin() + mid, src->begin() + mid, src->begin() + hi, dst->begin() + lo, less);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::swap(src, dst);
+    }
+    if (src != &items) {
+        items.swap(buffer);
+    }
+}
+
+void ColumnEngine::Clear()
+{
+    types.clear();
+    typesFirstRow = 0;
+}
+
+ColumnType ColumnEngine::GetColumnType(GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, uint64 firstRow)
+{
+    if (typesFirstRow != firstRow) {
+        types.clear();
+        typesFirstRow = firstRow;
+    }
+    if (column < types.size() && types[column].has_value()) {
+        return *types[column];
+    }
+
+    // a column is a number (or a date) column if every cell that is not empty is a number (or a date)
+    struct Votes {
+        bool number, date;
+    };
+    const auto workers = GetWorkersCount(index.GetRowsCount() - std::min<>(firstRow, index.GetRowsCount()));
+    std::vector<Votes> votes(workers, { true, true });
+    auto type        = ColumnType::String;
+    const auto valid = ForEachRowParallel(cache, index, firstRow, index.GetRowsCount(), [&](uint32 worker, uint64 row, const uint8* data) {
+        auto& v = votes[worker];
+        if (!v.number && !v.date) {
+            return;
+        }
+        const auto value = GetCellValue(index, row, column, data);
+        if (value.empty()) {
+            return;
+        }
+        double number;
+        uint64 date;
+        v.number = v.number && ParseNumber(value, number);
+        v.date   = v.date && ParseDate(value, date);
+    });
+    if (valid) {
+        const auto all = [&votes](bool Votes::*field) { return std::all_of(votes.begin(), votes.end(), [field](const Votes& v) { return v.*field; }); };
+        if (all(&Votes::number)) {
+            type = ColumnType::Number;
+        } else if (all(&Votes::date)) {
+            type = ColumnType::Date;
+        }
+        if (column >= types.size()) {
+            types.resize(static_cast<size_t>(column) + 1);
+        }
+        types[column] = type;
+    }
+    return type;
+}
+
+bool ColumnEngine::Sort(
+      GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, uint64 firstRow, bool ascending, std::vector<uint64>& order)
+{
+    const auto rows = index.GetRowsCount();
+    CHECK(firstRow <= rows, false, "Invalid first row (%llu)", firstRow);
+    const auto count = rows - firstRow;
+    const auto type  = GetColumnType(cache, index, column, firstRow);
+
+    std::vector<uint64> keys(static_cast<size_t>(count));
+    std::vector<uint8> lengths(type == ColumnType::String ? static_cast<size_t>(count) : 0);
+    std::vector<uint8> pending; // rows whose key must be extracted (only the ones that are still equal to others)
+    uint32 depth = 0;           // the offset in the cell of the bytes from the key (strings)
+
+    const auto Extract = [&](uint32, uint64 row, const uint8* data) {
+        const auto idx = static_cast<size_t>(row - firstRow);
+        if (!pending.empty() && !pending[idx]) {
+            return;
+        }
+        const auto value = GetCellValue(index, row, column, data);
+        if (type == ColumnType::String) {
+            const auto remaining = value.size() - std::min<size_t>(depth, value.size());
+            uint64 key           = 0;
+            for (auto pos = 0U; pos < KEY_SIZE; pos++) {
+                key = (key << 8) | (pos < remaining ? static_cast<uint8>(value[depth + pos]) : 0);
+            }
+            keys[idx]    = key;
+            lengths[idx] = static_cast<uint8>(std::min<size_t>(remaining, KEY_CONTINUES));
+        } else if (type == ColumnType::Number) {
+            double number;
+            uint64 bits = 0;
+            if (ParseNumber(value, number)) {
+                memcpy(&bits, &number, sizeof(bits));
+                bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+            }
+            keys[idx] = bits;
+        } else {
+            uint64 date = 0;
+            keys[idx]   = ParseDate(value, date) ? date + 1 : 0;
+        }
+    };
+    const auto Less = [&](uint64 a, uint64 b) {
+        auto ia = static_cast<size_t>(a - firstRow);
+        auto ib = static_cast<size_t>(b - firstRow);
+        if (!ascending) {
+            std::swap(ia, ib);
+        }
+        if (keys[ia] != keys[ib]) {
+            return keys[ia] < keys[ib];
+        }
+        return !lengths.empty() && lengths[ia] < lengths[ib];
+    };
+
+    CHECK(ForEachRowParallel(cache, index, firstRow, rows, Extract), false, "Fail to read column %u", column);
+    order.resize(static_cast<size_t>(count));
+    std::iota(order.begin(), order.end(), firstRow);
+    ParallelStableSort(order, Less);
+    if (type != ColumnType::String) {
+        return true;
+    }
+
+    // the runs of rows with the same 8 bytes that continue => sorted again by the next 8 bytes
+    std::vector<std::pair<size_t, size_t>> runs{ { 0, order.size() } }, next;
+    while (true) {
+        next.clear();
+        for (const auto& [b, e] : runs) {
+            for (auto start = b; start < e;) {
+                auto end       = start + 1;
+                const auto idx = static_cast<size_t>(order[start] - firstRow);
+                while (end < e && !Less(order[start], order[end]) && !Less(order[end], order[start])) {
+                    end++;
+                }
+                if (end - start > 1 && lengths[idx] == KEY_CONTINUES) {
+                    next.emplace_back(start, end);
+                }
+                start = end;
+            }
+        }
+        if (next.empty()) {
+            return true;
+        }
+
+        depth += KEY_SIZE;
+        pending.assign(static_cast<size_t>(count), 0);
+        auto minRow = rows;
+        auto maxRow = firstRow;
+        for (const auto& [b, e] : next) {
+            for (auto pos = b; pos < e; pos++) {
+                pending[static_cast<size_t>(order[pos] - firstRow)] = 1;
+                minRow                                              = std::min<>(minRow, order[pos]);
+                maxRow                                              = std::max<>(maxRow, order[pos]);
+            }
+        }
+        CHECK(ForEachRowParallel(cache, index, minRow, maxRow + 1, Extract), false, "Fail to read column %u", column);
+        for (const auto& [b, e] : next) {
+            std::stable_sort(order.begin() + b, order.begin() + e, Less);
+        }
+        runs.swap(next);
+    }
+}
+
+bool ColumnEngine::Filter(GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, std::string_view pattern, std::vector<uint64>& order)
+{
+    if (pattern.empty() || order.empty()) {
+        return true;
+    }
+    const auto [minRow, maxRow] = std::minmax_element(order.begin(), order.end());
+    const auto first            = *minRow;
+    const auto last             = *maxRow + 1;
+
+    // case insensitive (ASCII) search of the pattern in the value of the cell
+    const auto SameChar = [](char a, char b) { return tolower(static_cast<uint8>(a)) == tolower(static_cast<uint8>(b)); };
+    std::vector<uint8> matched(static_cast<size_t>(last - first), 0);
+    const auto valid = ForEachRowParallel(cache, index, first, last, [&](uint32, uint64 row, const uint8* data) {
+        const auto value                             = GetCellValue(index, row, column, data);
+        matched[static_cast<size_t>(row - first)] = std::search(value.begin(), value.end(), pattern.begin(), pattern.end(), SameChar) != value.end();
+    });
+    CHECK(valid, false, "Fail to read column %u", column);
+
+    order.erase(std::remove_if(order.begin(), order.end(), [&matched, first](uint64 row) { return !matched[static_cast<size_t>(row - first)]; }), order.end());
+    return true;
+}
@@ -287,11 +287,7 @@ bool FindDialog::ProcessInput()
     // CHECK(object.IsValid(), false, "");
     CHECK(input.IsValid(), false, "");
 
-    if (input->GetText().Len() == 0)
-    {
-        Dialogs::MessageBox::ShowError("Error!", "Missing input!");
-        return false;
-    }
+    // an empty input is valid (it removes the current filter)
     return true;
 }
 } // namespace GView::View::GridViewer
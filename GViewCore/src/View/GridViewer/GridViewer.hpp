@@ -2,6 +2,7 @@
 
 #include "Internal.hpp"
 #include <array>
+#include <optional>
 namespace GView
 {
 namespace View
@@ -17,6 +18,9 @@ namespace View
             constexpr uint32 COMMAND_ID_VIEW_CELL_CONTENT           = 0x1003;
             constexpr uint32 COMMAND_ID_EXPORT_CELL_CONTENT         = 0x1004;
             constexpr uint32 COMMAND_ID_EXPORT_COLUMN_CONTENT       = 0x1005;
+            constexpr uint32 COMMAND_ID_SORT_ASCENDING              = 0x1006;
+            constexpr uint32 COMMAND_ID_SORT_DESCENDING             = 0x1007;
+            constexpr uint32 COMMAND_ID_RESET_ORDER                 = 0x1008;
 
             static KeyboardControl ReplaceHeader = { Key::Space, "ReplaceHeader", "Replace header with first row", COMMAND_ID_REPLACE_HEADER_WITH_1ST_ROW };
 
@@ -34,15 +38,93 @@ namespace View
                 Key::Ctrl | Key::Alt | Key::S, "ExportColumnContent", "Export the content of the current column", COMMAND_ID_EXPORT_COLUMN_CONTENT
             };
 
-            static std::array AllGridCommands = { &ReplaceHeader, &ToggleHorizontalLines, &ToggleVerticalLines, &ViewCellContent, &ExportCellContent, &ExportColumnContent };
+            static KeyboardControl SortAscending = { Key::F2, "SortAscending", "Sort the rows by the current column (ascending)", COMMAND_ID_SORT_ASCENDING };
+            static KeyboardControl SortDescending = {
+                Key::Shift | Key::F2, "SortDescending", "Sort the rows by the current column (descending)", COMMAND_ID_SORT_DESCENDING
+            };
+            static KeyboardControl ResetOrder = { Key::Ctrl | Key::F2, "ResetOrder", "Show all the rows in the file order", COMMAND_ID_RESET_ORDER };
+
+            static std::array AllGridCommands = { &ReplaceHeader,       &ToggleHorizontalLines, &ToggleVerticalLines, &ViewCellContent, &ExportCellContent,
+                                                  &ExportColumnContent, &SortAscending,         &SortDescending,      &ResetOrder };
         }
 
 
+        // Offsets of the rows and cells of the file (in flat arrays). A row has the offset of its first byte and every cell
+        // the offset of its first byte relative to the row (the cell ends before the next separator or with the row).
+        // Separators and line breaks between quotes ("...") are part of the cell.
+        class CellsIndex
+        {
+#pragma pack(push, 4)
+            struct Row
+            {
+                uint64 offset;
+                uint64 firstCell; // index in 'cells'
+                uint32 size;      // without the line break
+            };
+#pragma pack(pop)
+            static_assert(sizeof(Row) == 20);
+            std::vector<Row> rows;
+            std::vector<uint32> cells;
+            uint32 maxCellsPerRow{ 0 };
+
+          public:
+            bool Build(GView::Utils::DataCache& cache, char separator);
+            void Clear();
+
+            inline uint64 GetRowsCount() const
+            {
+                return rows.size();
+            }
+            inline uint32 GetCellsCount(uint64 row) const
+            {
+                const auto end = row + 1 < rows.size() ? rows[row + 1].firstCell : cells.size();
+                return static_cast<uint32>(end - rows[row].firstCell);
+            }
+            inline uint32 GetMaxCellsPerRow() const
+            {
+                return maxCellsPerRow;
+            }
+            inline uint64 GetRowOffset(uint64 row) const
+            {
+                return rows[row].offset;
+            }
+            inline uint32 GetRowSize(uint64 row) const
+            {
+                return rows[row].size;
+            }
+            // [start, end) of a cell, relative to the start of the row
+            inline std::pair<uint32, uint32> GetCell(uint64 row, uint32 column) const
+            {
+                const auto& r     = rows[row];
+                const auto index  = r.firstCell + column;
+                const auto isLast = column + 1 == GetCellsCount(row);
+                return { cells[index], isLast ? r.size : cells[index + 1] - 1 };
+            }
+        };
+
+        enum class ColumnType : uint8 { String, Number, Date };
+
+        // Sorts and filters the rows by the values of a column. The cells are read from the file (in parallel) and are
+        // not copied: the result is a permutation (the indexes of the rows, in the order they are shown).
+        class ColumnEngine
+        {
+            std::vector<std::optional<ColumnType>> types; // inferred types (computed once for every column)
+            uint64 typesFirstRow{ 0 };                    // the first row that is not a header
+
+          public:
+            void Clear();
+            ColumnType GetColumnType(GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, uint64 firstRow);
+
+            // 'order' = the rows from [firstRow, rows count) sorted by the value of the column (stable)
+            bool Sort(GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, uint64 firstRow, bool ascending, std::vector<uint64>& order);
+            // removes from 'order' the rows whose cell does not contain 'pattern' (case insensitive), an empty pattern keeps all of them
+            bool Filter(GView::Utils::DataCache& cache, const CellsIndex& index, uint32 column, std::string_view pattern, std::vector<uint64>& order);
+        };
+
         struct SettingsData
         {
             String name;
-            std::map<uint64, std::pair<uint64, uint64>> lines;
-            std::map<uint64, std::vector<std::pair<uint64, uint64>>> tokens;
+            CellsIndex index;
             char separator[2]{ "," };
             uint64 rows           = 0;
             uint64 cols           = 0;
@@ -129,6 +211,10 @@ namespace View
             FindDialog findDialog;
             std::string exportedPathUTF8;
             std::string exportedFolderPath;
+            std::vector<uint8> rowBuffer; // rows that are bigger than the cache
+            ColumnEngine engine;
+            std::vector<uint64> sorted; // all the rows (in the current sort order)
+            std::vector<uint64> order;  // the rows that are shown ('sorted' without the ones removed by the filter)
           public:
             Instance(Reference<GView::Object> obj, Settings* settings);
 
@@ -153,7 +239,10 @@ namespace View
             bool UpdateKeys(KeyboardControlsInterface* interface) override;
 
           private:
+            bool ReadRow(uint64 row, std::vector<AppCUI::Utils::ConstString>& values);
             void PopulateGrid();
+            void ResetRowsOrder();
+            bool GetCurrentColumn(uint32& column);
             void ProcessContent();
             void PaintCursorInformationWidth(AppCUI::Graphics::Renderer& renderer, unsigned int x, unsigned int y);
             void PaintCursorInformationHeight(AppCUI::Graphics::Renderer& renderer, unsigned int x, unsigned int y);
@@ -1,6 +1,7 @@
 #include "GridViewer.hpp"
 #include <fstream>
 #include <filesystem>
+#include <numeric>
 
 using namespace GView::View::GridViewer;
 using namespace GView::View::GridViewer::Commands;
@@ -30,7 +31,7 @@ Instance::Instance(Reference<GView::Object> obj, Settings* _settings) : settings
               "d:c,w:100%,h:100%",
               static_cast<uint32>(settings->cols),
               static_cast<uint32>(settings->rows),
-              AppCUI::Controls::GridFlags::Sort | AppCUI::Controls::GridFlags::Filter | GridFlags::DisableDuplicates);
+              GridFlags::DisableDuplicates); // sorting and filtering are done by the engine (on the rows from the file)
 
         grid->SetSeparator(settings->separator);
     }
@@ -75,9 +76,27 @@ bool Instance::ShowFindDialog()
 {
     CHECK(findDialog.Show() == Dialogs::Result::Ok, true, "");
 
-    auto filterValue = findDialog.GetFilterValue();
-    grid->SetFilterOnCurrentColumn(filterValue);
-    grid->Filter();
+    uint32 column = 0;
+    CHECK(GetCurrentColumn(column), true, "");
+
+    // the cells are matched as UTF-8 bytes
+    const auto filterValue = findDialog.GetFilterValue();
+    GView::Utils::CharacterEncoding::EncodedCharacter encoded;
+    std::string pattern;
+    for (const auto ch : filterValue) {
+        const auto buffer = encoded.Encode(ch, GView::Utils::CharacterEncoding::Encoding::UTF8);
+        pattern.append(reinterpret_cast<const char*>(buffer.GetData()), buffer.GetLength());
+    }
+
+    // the filter replaces the previous one: it is applied on all the rows (in the current sort order)
+    // an empty pattern removes the filter
+    auto filtered = sorted;
+    if (!engine.Filter(obj->GetData(), settings->index, column, pattern, filtered)) {
+        AppCUI::Dialogs::MessageBox::ShowError("Error", "Failed to filter the rows!");
+        return true;
+    }
+    order.swap(filtered);
+    PopulateGrid();
 
     return true;
 }
@@ -141,6 +160,7 @@ bool Instance::OnEvent(Reference<Control> control, Event eventType, int ID)
     if (eventType == Event::Command) {
         if (ID == COMMAND_ID_REPLACE_HEADER_WITH_1ST_ROW) {
             settings->firstRowAsHeader = !settings->firstRowAsHeader;
+            ResetRowsOrder();
             PopulateGrid();
             return true;
         } else if (ID == COMMAND_ID_TOGGLE_HORIZONTAL_LINES) {
@@ -149,6 +169,29 @@ bool Instance::OnEvent(Reference<Control> control, Event eventType, int ID)
         } else if (ID == COMMAND_ID_TOGGLE_VERTICAL_LINES) {
             grid->ToggleVerticalLines();
             return true;
+        } else if (ID == COMMAND_ID_SORT_ASCENDING || ID == COMMAND_ID_SORT_DESCENDING) {
+            uint32 column = 0;
+            if (GetCurrentColumn(column)) {
+                const auto firstRow = settings->firstRowAsHeader && settings->rows > 0 ? 1ULL : 0ULL;
+                // the engine sorts all the rows => the ones hidden by the filter are removed again
+                std::vector<uint8> shown(static_cast<size_t>(settings->rows), 0);
+                for (const auto row : order) {
+                    shown[static_cast<size_t>(row)] = 1;
+                }
+                if (engine.Sort(obj->GetData(), settings->index, column, firstRow, ID == COMMAND_ID_SORT_ASCENDING, sorted)) {
+                    order = sorted;
+                    order.erase(std::remove_if(order.begin(), order.end(), [&shown](uint64 row) { return !shown[static_cast<size_t>(row)]; }), order.end());
+                } else {
+                    AppCUI::Dialogs::MessageBox::ShowError("Error", "Failed to sort the rows!");
+                    ResetRowsOrder();
+                }
+                PopulateGrid();
+            }
+            return true;
+        } else if (ID == COMMAND_ID_RESET_ORDER) {
+            ResetRowsOrder();
+            PopulateGrid();
+            return true;
         } else if (ID == COMMAND_ID_VIEW_CELL_CONTENT) {
             auto content = grid->GetSelectedCellContent();
             if (content.has_value()) {
@@ -212,127 +255,107 @@ void Instance::OnStart()
 {
     ProcessContent();
     grid->SetGridDimensions({ static_cast<uint32>(settings->cols), static_cast<uint32>(settings->rows) });
+    ResetRowsOrder();
     PopulateGrid();
 }
 
-void Instance::PopulateGrid()
+bool Instance::ReadRow(uint64 row, std::vector<AppCUI::Utils::ConstString>& values)
 {
-    const auto& content = settings->tokens;
-    auto it             = content.begin();
-
-    if (settings->firstRowAsHeader) {
-        const auto& header = it->second;
-        std::vector<AppCUI::Utils::ConstString> headerCS;
-        for (const auto& [start, end] : header) {
-            const auto token = obj->GetData().Get(start, static_cast<uint32>(end - start), false);
-            headerCS.push_back(token);
-        }
-        std::advance(it, 1);
-        grid->UpdateHeaderValues(headerCS);
+    const auto& index = settings->index;
+    const auto offset = index.GetRowOffset(row);
+    const auto size   = index.GetRowSize(row);
+    auto& cache       = obj->GetData();
+
+    // the cells of a row are views in the same buffer => one read for the entire row
+    const uint8* data = nullptr;
+    const auto buffer = cache.Get(offset, size, true);
+    if (buffer.GetLength() == size) {
+        data = buffer.GetData();
     } else {
-        grid->SetDefaultHeaderValues();
-    }
-
-    const auto dimensions = grid->GetGridDimensions();
-    if (static_cast<uint32>(settings->rows - settings->firstRowAsHeader) != dimensions.Height) {
-        grid->SetGridDimensions({ static_cast<uint32>(settings->cols), static_cast<uint32>(settings->rows - settings->firstRowAsHeader) });
-    }
-
-    while (it != content.end()) {
-        const auto i    = it->first;
-        const auto& row = it->second;
-        for (auto itRow = row.begin(); itRow != row.end(); itRow++) {
-            const auto j     = row.size() - std::abs(std::distance(row.end(), itRow));
-            const auto token = obj->GetData().Get(itRow->first, static_cast<uint32>(itRow->second - itRow->first), false);
-            const ConstString value{ token };
-            grid->UpdateCell(static_cast<uint32>(j), static_cast<uint32>(i - settings->firstRowAsHeader), value);
+        // the row is bigger than the cache
+        rowBuffer.resize(size);
+        uint64 copied = 0;
+        GView::Utils::DataCache::SequentialReader reader(cache, offset, size);
+        for (auto chunk = reader.Next(); !chunk.Empty(); chunk = reader.Next()) {
+            memcpy(rowBuffer.data() + copied, chunk.GetData(), chunk.GetLength());
+            copied += chunk.GetLength();
         }
-        std::advance(it, 1);
+        CHECK(copied == size, false, "Fail to read row %llu (offset: 0x%llX, size: %u)", row, offset, size);
+        data = rowBuffer.data();
     }
 
-    grid->Sort();
+    values.clear();
+    const auto count = std::min<>(index.GetCellsCount(row), static_cast<uint32>(settings->cols));
+    for (auto column = 0U; column < count; column++) {
+        const auto [start, end] = index.GetCell(row, column);
+        values.emplace_back(std::string_view{ reinterpret_cast<const char*>(data) + start, static_cast<size_t>(end - start) });
+    }
+    return true;
 }
 
-void GView::View::GridViewer::Instance::ProcessContent()
+void Instance::ResetRowsOrder()
 {
-    // TODO: this function should be a state machine with using cache as a stream-like structure!
-    // the implementation below is wrong if a "row" contains more bytes than the cache size!
-
-    std::map<uint64, std::pair<uint64, uint64>> lines;
-    std::map<uint64, std::vector<std::pair<uint64, uint64>>> tokens;
-
-    const auto oSize = obj->GetData().GetSize();
-    const auto cSize = static_cast<uint64>(obj->GetData().GetCacheSize());
-
-    auto oSizeProcessed = 0ULL;
-    auto lineStart      = 0ULL;
-    auto currentLine    = 0ULL;
-
-    do {
-        const auto dataSize = oSizeProcessed >= oSize ? 0 : std::min<uint64>(oSize - oSizeProcessed, cSize);
-        const auto buf      = obj->GetData().Get(oSizeProcessed, static_cast<uint32>(dataSize), false);
-        const std::string_view data{ reinterpret_cast<const char*>(buf.GetData()), buf.GetLength() };
+    const auto firstRow = settings->firstRowAsHeader && settings->rows > 0 ? 1ULL : 0ULL;
+    sorted.resize(static_cast<size_t>(settings->rows - firstRow));
+    std::iota(sorted.begin(), sorted.end(), firstRow);
+    order = sorted;
+}
 
-        auto nPos       = data.find_first_of('\n', 0);
-        const auto rPos = data.find_first_of('\r', 0);
+bool Instance::GetCurrentColumn(uint32& column)
+{
+    const auto location = grid->GetSelectionLocationsStart();
+    if (location.X < 0) {
+        AppCUI::Dialogs::MessageBox::ShowError("Error", "Select a cell from the column first!");
+        return false;
+    }
+    column = static_cast<uint32>(location.X);
+    return true;
+}
 
-        const auto oldOSizeProcessed = oSizeProcessed;
+void Instance::PopulateGrid()
+{
+    const auto rows = settings->index.GetRowsCount();
+    std::vector<AppCUI::Utils::ConstString> values;
+    values.reserve(static_cast<size_t>(settings->cols));
 
-        if (nPos < rPos) {
-            if (nPos + 1 < data.size() && data[nPos + 1] == '\r') {
-                oSizeProcessed += nPos + 2;
-            } else {
-                oSizeProcessed += nPos + 1;
-            }
-        } else if (nPos > rPos) {
-            if (rPos + 1 < data.size() && data[rPos + 1] == '\n') {
-                oSizeProcessed += rPos + 2;
-            } else {
-                oSizeProcessed += rPos + 1;
-            }
-        } else if (nPos == rPos && nPos == std::string::npos) {
-            nPos = data.size();
-            oSizeProcessed += nPos + 1;
+    if (settings->firstRowAsHeader && rows > 0) {
+        if (ReadRow(0, values)) {
+            grid->UpdateHeaderValues(values);
         }
+    } else {
+        grid->SetDefaultHeaderValues();
+    }
 
-        lines.insert({ currentLine, { lineStart + oldOSizeProcessed, nPos + oldOSizeProcessed } });
-        const std::string_view line{ reinterpret_cast<const char*>(buf.GetData() + lineStart), nPos };
+    // the rows are shown in the order from the permutation (sorted / filtered by the engine)
+    const auto dimensions = grid->GetGridDimensions();
+    if (static_cast<uint32>(order.size()) != dimensions.Height) {
+        grid->SetGridDimensions({ static_cast<uint32>(settings->cols), static_cast<uint32>(order.size()) });
+    }
 
-        std::vector<uint64> separators;
-        {
-            size_t pos = line.find(settings->separator[0]);
-            while (pos != std::string::npos) {
-                separators.push_back(pos + oldOSizeProcessed);
-                pos = line.find(settings->separator[0], pos + 1);
-            }
+    for (auto y = 0U; y < static_cast<uint32>(order.size()); y++) {
+        if (!ReadRow(order[y], values)) {
+            continue;
         }
-
-        std::vector<std::pair<uint64, uint64>> lTokens;
-        if (separators.size() == 0) {
-            lTokens.push_back({ lineStart + oldOSizeProcessed, nPos + oldOSizeProcessed });
+        for (auto column = 0U; column < values.size(); column++) {
+            grid->UpdateCell(column, y, values[column]);
         }
-
-        {
-            auto tStart = oldOSizeProcessed;
-            auto tEnd   = oldOSizeProcessed;
-            for (const auto& i : separators) {
-                tEnd = i;
-                lTokens.push_back({ tStart, tEnd });
-                tStart = tEnd + 1;
-            }
-            lTokens.push_back({ tEnd + 1, oSizeProcessed });
+        // the row that was shown here before can have more cells
+        for (auto column = static_cast<uint32>(values.size()); column < static_cast<uint32>(settings->cols); column++) {
+            grid->UpdateCell(column, y, "");
         }
+    }
+}
 
-        tokens.insert({ currentLine, std::move(lTokens) });
-
-        currentLine++;
-
-    } while (oSizeProcessed < oSize);
+void GView::View::GridViewer::Instance::ProcessContent()
+{
+    auto& index = settings->index;
+    if (!index.Build(obj->GetData(), settings->separator[0])) {
+        index.Clear();
+    }
 
-    settings->rows   = lines.size();
-    settings->cols   = tokens.size() > 0 ? tokens.begin()->second.size() : 0;
-    settings->lines  = std::move(lines);
-    settings->tokens = std::move(tokens);
+    settings->rows = index.GetRowsCount();
+    settings->cols = index.GetMaxCellsPerRow();
+    engine.Clear();
 }
 
 void GView::View::GridViewer::Instance::PaintCursorInformationWidth(AppCUI::Graphics::Renderer& renderer, unsigned int x, unsigned int y)
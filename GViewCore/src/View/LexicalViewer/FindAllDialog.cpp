@@ -9,7 +9,7 @@ constexpr int32 BTN_ID_OK             = 1;
 constexpr int32 BTN_ID_CANCEL         = 2;
 constexpr uint32 INVALID_TOKEN_NUMBER = 0xFFFFFFFF;
 
-FindAllDialog::FindAllDialog(const TokenObject& currentToken, const std::vector<TokenObject>& tokens, const char16* txt)
+FindAllDialog::FindAllDialog(const Instance& instance, uint32 currentTokenIndex)
     : Window("All apearences", "d:c,w:80,h:20", WindowFlags::ProcessReturn)
 {
     LocalString<128> tmp;
@@ -17,10 +17,12 @@ FindAllDialog::FindAllDialog(const TokenObject& currentToken, const std::vector<
     this->selectedTokenIndex = INVALID_TOKEN_NUMBER;
 
     lst = Factory::ListView::Create(this, "l:1,t:0,r:1,b:3", { "n:Line,a:l,w:6", "n:Content,a:l,w:200" }, ListViewFlags::HideSearchBar);
+    const auto& tokens       = instance.tokens;
+    const auto& currentToken = tokens[currentTokenIndex];
     // add all lines
     auto len      = static_cast<uint32>(tokens.size());
     auto lastLine = 0xFFFFFFFFU;
-    auto ctokSize = static_cast<uint32>(currentToken.GetText(txt).size());
+    auto ctokSize = static_cast<uint32>(instance.GetTokenText(currentTokenIndex).size());
     uint32 indexes[64];
     uint32 indexesCount;
 
@@ -62,7 +64,7 @@ FindAllDialog::FindAllDialog(const TokenObject& currentToken, const std::vector<
                 indexes[indexesCount++] = content.Len();
             }
 
-            content.Add(tokens[start].GetText(txt));
+            content.Add(instance.GetTokenText(start));
             lastX = tokens[start].end;
             start++;
         }
@@ -47,10 +47,20 @@ void TestTextEditor()
 }
 //*/
 
-inline int32 ComputeXDist(int32 x1, int32 x2)
+// The encoding found during type identification was computed only over the first bytes of the file.
+// It can be used for the entire file if it came from a BOM or if it is not 'Ascii' (an UTF-8 sequence
+// might appear later in the file) or 'Binary'.
+static bool ReadProbedEncoding(Reference<GView::Object> obj, GView::Utils::CharacterEncoding::Encoding& enc, uint32& bomLength)
 {
-    return x1 > x2 ? x1 - x2 : x2 - x1;
+    uint8 value;
+    if (!obj->GetProbedEncoding(value, bomLength))
+        return false;
+    enc = static_cast<GView::Utils::CharacterEncoding::Encoding>(value);
+    if (bomLength > 0)
+        return true;
+    return (enc != GView::Utils::CharacterEncoding::Encoding::Ascii) && (enc != GView::Utils::CharacterEncoding::Encoding::Binary);
 }
+
 inline std::string_view TokenDataTypeToString(TokenDataType dataType)
 {
     switch (dataType)
@@ -92,8 +102,13 @@ Instance::Instance(Reference<GView::Object> _obj, Settings* _settings)
         config.Initialize();
 
     // load the entire data into a file
-    auto buf                     = obj->GetData().GetEntireFile();
-    this->text                   = GView::Utils::CharacterEncoding::ConvertToUnicode16(buf);
+    auto buf = obj->GetData().GetEntireFile();
+    auto enc = GView::Utils::CharacterEncoding::Encoding::Binary;
+    auto bom = 0U;
+    if (ReadProbedEncoding(obj, enc, bom))
+        this->text = GView::Utils::CharacterEncoding::ConvertToUnicode16(buf, enc, bom);
+    else
+        this->text = GView::Utils::CharacterEncoding::ConvertToUnicode16(buf);
     this->prettyFormat           = true;
     this->highlightSimilarTokens = true;
 
@@ -111,6 +126,7 @@ void Instance::RecomputeTokenPositions()
         PrettyFormat();
     else
         ComputeOriginalPositions();
+    this->lineIndex.Build(this->tokens);
     EnsureCurrentItemIsVisible();
 }
 void Instance::UpdateTokensInformation()
@@ -120,10 +136,12 @@ void Instance::UpdateTokensInformation()
     - height
     - hashing
     */
-    for (auto& tok : this->tokens)
+    const auto count = static_cast<uint32>(this->tokens.size());
+    for (auto idx = 0U; idx < count; idx++)
     {
-        tok.UpdateSizes(this->text.text);
-        tok.UpdateHash(this->text.text, this->settings->ignoreCase);
+        const auto txt = GetTokenText(idx);
+        this->tokens[idx].UpdateSizes(txt);
+        this->tokens[idx].UpdateHash(txt, this->settings->ignoreCase);
     }
 }
 void Instance::MoveToClosestVisibleToken(uint32 startIndex, bool selected)
@@ -722,9 +740,13 @@ void Instance::Parse()
     this->currentHash       = 0;
     this->noItemsVisible    = true;
     this->showMetaData      = true; // has to be true at this point to proper compute line numbers
+    this->blocksMatched     = false;
 
     this->tokens.clear();
     this->blocks.clear();
+    this->values.Clear();
+    this->errors.Clear();
+    this->lineIndex.Clear();
     this->selection.Clear();
 
     if (this->settings->parser)
@@ -740,38 +762,210 @@ void Instance::Parse()
         TextParser textParser(this->text.text, this->text.size);
         SyntaxManager syntax(textParser, tokensList, blockList);
         this->settings->parser->AnalyzeText(syntax);
+        this->blocksMatched = syntax.blocksMatched;
         UpdateTokensInformation();
         RecomputeTokenPositions();
         MoveToClosestVisibleToken(0, false);
 
         // step 3 (recompute line numbers)
         // the list of tokens and blocks has been cleared so we know for sure that everything is expanded
-        auto lastY  = -1;
-        auto lineNo = 0;
-        for (auto& tok : this->tokens)
+        RecomputeLineNumbers();
+    }
+}
+void Instance::RecomputeLineNumbers()
+{
+    auto lastY  = -1;
+    auto lineNo = 0;
+    for (auto& tok : this->tokens)
+    {
+        if (tok.pos.y != lastY)
         {
-            if (tok.pos.y != lastY)
-            {
-                lineNo++;
-                lastY = tok.pos.y;
-            }
-            tok.lineNo = lineNo;
-        }
-        // at the end --> lineNo is the highest line number
-        this->lineNrWidth    = 0;
-        this->lastLineNumber = lineNo;
-
-        if (lastLineNumber < 100)
-            this->lineNrWidth = 4;
-        else if (lastLineNumber < 1000)
-            this->lineNrWidth = 5;
-        else if (lastLineNumber < 10000)
-            this->lineNrWidth = 6;
-        else if (lastLineNumber < 100000)
-            this->lineNrWidth = 7;
-        else
-            this->lineNrWidth = 8;
+            lineNo++;
+            lastY = tok.pos.y;
+        }
+        tok.lineNo = lineNo;
     }
+    // at the end --> lineNo is the highest line number
+    this->lineNrWidth    = 0;
+    this->lastLineNumber = lineNo;
+
+    if (lastLineNumber < 100)
+        this->lineNrWidth = 4;
+    else if (lastLineNumber < 1000)
+        this->lineNrWidth = 5;
+    else if (lastLineNumber < 10000)
+        this->lineNrWidth = 6;
+    else if (lastLineNumber < 100000)
+        this->lineNrWidth = 7;
+    else
+        this->lineNrWidth = 8;
+}
+bool Instance::ParseRange(uint32 oldTextSize, uint32 changeStart, uint32 changeEnd)
+{
+    /*
+    The text has been modified in [changeStart, changeEnd) (offsets in the old text, of size 'oldTextSize') and this->text is
+    the new text. Only the tokens around that range are analyzed again: the range is extended (in both directions) up to a
+    token that is not part of any block and after which the parser can split the analysis. The tokens and blocks before and
+    after that range are kept (their offsets and indexes are moved). The preprocessor is not used (the text was already
+    preprocessed before it was modified).
+    Returns false if the range can not be split (the entire text has to be parsed).
+    */
+    const auto parser = this->settings->parser;
+    const auto count  = static_cast<uint32>(this->tokens.size());
+    if ((!parser) || (count == 0) || (!this->blocksMatched))
+        return false;
+
+    // nesting level after every token (a token after which no block remains opened is at level 0)
+    std::vector<int32> nesting(count, 0);
+    for (const auto& block : this->blocks)
+    {
+        nesting[block.tokenStart]++;
+        nesting[block.tokenEnd]--;
+    }
+    for (auto idx = 1U; idx < count; idx++)
+        nesting[idx] += nesting[idx - 1];
+    const auto CanSplitAfter = [&](uint32 index) { return (nesting[index] == 0) && (parser->CanSplitAnalysisAfter(Token(this, index))); };
+
+    // the tokens from [rangeStart, rangeEnd) are replaced with the ones obtained by analyzing their text again
+    auto rangeStart = static_cast<uint32>(
+          std::upper_bound(this->tokens.begin(), this->tokens.end(), changeStart, [](uint32 value, const TokenObject& tok) { return value < tok.end; }) -
+          this->tokens.begin());
+    auto rangeEnd = static_cast<uint32>(
+          std::lower_bound(this->tokens.begin(), this->tokens.end(), changeEnd, [](const TokenObject& tok, uint32 value) { return tok.start < value; }) -
+          this->tokens.begin());
+    while ((rangeStart > 0) && (!CanSplitAfter(rangeStart - 1)))
+        rangeStart--;
+    while ((rangeEnd < count) && (!CanSplitAfter(rangeEnd)))
+        rangeEnd++;
+    if (rangeEnd < count)
+        rangeEnd++; // the token where the analysis is split is analyzed again as well
+    if ((rangeStart == 0) && (rangeEnd == count))
+        return false;
+
+    const auto delta     = static_cast<int64>(this->text.size) - static_cast<int64>(oldTextSize);
+    const auto textStart = rangeStart > 0 ? this->tokens[rangeStart - 1].end : 0U;
+    const auto textEnd   = rangeEnd < count ? static_cast<int64>(this->tokens[rangeEnd - 1].end) + delta : static_cast<int64>(this->text.size);
+    if ((textEnd < textStart) || (textEnd > this->text.size))
+        return false;
+
+    // analyze that part of the text (with empty lists of tokens and blocks)
+    const auto splitTokenType = rangeStart > 0 ? this->tokens[rangeStart - 1].type : 0U;
+    std::vector<TokenObject> rangeTokens;
+    std::vector<BlockObject> rangeBlocks;
+    TokenStringsTable rangeValues, rangeErrors;
+    std::swap(this->tokens, rangeTokens);
+    std::swap(this->blocks, rangeBlocks);
+    std::swap(this->values, rangeValues);
+    std::swap(this->errors, rangeErrors);
+    auto fullText = this->text;
+    this->text    = GView::Utils::UnicodeString(fullText.text + textStart, static_cast<uint32>(textEnd - textStart), static_cast<uint32>(textEnd - textStart));
+    auto rangeMatched = false;
+    {
+        TokensListBuilder tokensList(this);
+        BlocksListBuilder blockList(this);
+        if (rangeStart > 0)
+            tokensList.ResetLastTokenID(splitTokenType); // the analysis continues after that token
+        TextParser textParser(this->text.text, this->text.size);
+        SyntaxManager syntax(textParser, tokensList, blockList);
+        parser->AnalyzeText(syntax);
+        rangeMatched = syntax.blocksMatched;
+    }
+    this->text = fullText;
+    std::swap(this->tokens, rangeTokens);
+    std::swap(this->blocks, rangeBlocks);
+    std::swap(this->values, rangeValues);
+    std::swap(this->errors, rangeErrors);
+
+    // the result is the same as the one of a full parse only if the blocks of that part of the text are closed inside it and
+    // (if the text continues) its last token ends exactly where the kept tokens start (checked below to be a split token as well)
+    if (!rangeMatched)
+        return false;
+    if ((rangeEnd < count) && ((rangeTokens.empty()) || (rangeTokens.back().end != static_cast<uint32>(textEnd - textStart))))
+        return false;
+
+    // splice the blocks (the ones before the range, the new ones and the ones after the range)
+    const auto removed  = rangeEnd - rangeStart;
+    const auto inserted = static_cast<uint32>(rangeTokens.size());
+    std::vector<uint32> blockIDs(this->blocks.size(), BlockObject::INVALID_ID);
+    std::vector<BlockObject> newBlocks;
+    newBlocks.reserve(this->blocks.size() + rangeBlocks.size());
+    for (auto idx = 0U; idx < this->blocks.size(); idx++)
+    {
+        if (this->blocks[idx].tokenEnd < rangeStart)
+        {
+            blockIDs[idx] = static_cast<uint32>(newBlocks.size());
+            newBlocks.push_back(this->blocks[idx]);
+        }
+    }
+    const auto firstRangeBlock = static_cast<uint32>(newBlocks.size());
+    for (auto& block : rangeBlocks)
+    {
+        block.tokenStart += rangeStart;
+        block.tokenEnd += rangeStart;
+        newBlocks.push_back(std::move(block));
+    }
+    for (auto idx = 0U; idx < this->blocks.size(); idx++)
+    {
+        auto& block = this->blocks[idx];
+        if (block.tokenStart >= rangeEnd)
+        {
+            block.tokenStart = block.tokenStart - removed + inserted;
+            block.tokenEnd   = block.tokenEnd - removed + inserted;
+            blockIDs[idx]    = static_cast<uint32>(newBlocks.size());
+            newBlocks.push_back(std::move(block));
+        }
+    }
+
+    // splice the tokens
+    const auto UpdateKeptToken = [&blockIDs](TokenObject& tok)
+    {
+        if (tok.HasBlock())
+            tok.blockID = tok.blockID < blockIDs.size() ? blockIDs[tok.blockID] : BlockObject::INVALID_ID;
+        tok.SetFolded(false);
+    };
+    for (auto idx = 0U; idx < rangeStart; idx++)
+        UpdateKeptToken(this->tokens[idx]);
+    for (auto idx = rangeEnd; idx < count; idx++)
+    {
+        auto& tok = this->tokens[idx];
+        tok.start = static_cast<uint32>(tok.start + delta);
+        tok.end   = static_cast<uint32>(tok.end + delta);
+        UpdateKeptToken(tok);
+    }
+    for (auto& tok : rangeTokens)
+    {
+        tok.start += textStart;
+        tok.end += textStart;
+        if (tok.HasBlock())
+            tok.blockID += firstRangeBlock;
+    }
+    this->tokens.erase(this->tokens.begin() + rangeStart, this->tokens.begin() + rangeEnd);
+    this->tokens.insert(this->tokens.begin() + rangeStart, std::make_move_iterator(rangeTokens.begin()), std::make_move_iterator(rangeTokens.end()));
+    this->blocks = std::move(newBlocks);
+
+    // the tokens after the range were analyzed after a split token => the last new token has to be one as well
+    // (otherwise the caller parses the entire text again, and that rebuilds the tokens and blocks)
+    if ((rangeEnd < count) && (!parser->CanSplitAnalysisAfter(Token(this, rangeStart + inserted - 1))))
+        return false;
+
+    this->values.Splice(rangeStart, removed, rangeValues, inserted);
+    this->errors.Splice(rangeStart, removed, rangeErrors, inserted);
+
+    // the current token stays the same (if it was not analyzed again)
+    if (this->currentTokenIndex >= rangeEnd)
+        this->currentTokenIndex = this->currentTokenIndex - removed + inserted;
+    else if (this->currentTokenIndex >= rangeStart)
+        this->currentTokenIndex = rangeStart;
+    this->currentTokenIndex = std::min<>(this->currentTokenIndex, static_cast<uint32>(this->tokens.size()) - 1);
+    this->currentHash       = 0;
+    this->showMetaData      = true; // same as after a full parse
+    this->selection.Clear();
+
+    UpdateTokensInformation();
+    RecomputeTokenPositions();
+    MoveToClosestVisibleToken(this->currentTokenIndex, false);
+    RecomputeLineNumbers();
+    return true;
 }
 void Instance::Reparse(bool openInNewWindow)
 {
@@ -781,6 +975,23 @@ void Instance::Reparse(bool openInNewWindow)
     }
     else
     {
+        // the modified part of the text (the tokens that are deleted or have a different value)
+        auto changeStart = this->text.size;
+        auto changeEnd   = 0U;
+        const auto count = static_cast<uint32>(this->tokens.size());
+        for (auto idx = 0U; idx < count; idx++)
+        {
+            const auto& tok   = this->tokens[idx];
+            const auto value  = this->values.Get(idx);
+            const auto change = (!value.empty()) && (value != tok.GetOriginalText(this->text.text));
+            if ((tok.IsMarkForDeletion()) || (change))
+            {
+                changeStart = std::min<>(changeStart, tok.start);
+                changeEnd   = std::max<>(changeEnd, tok.end);
+            }
+        }
+        const auto oldTextSize = this->text.size;
+
         TextEditorBuilder ted(this->text);
         auto res   = RebuildTextFromTokens(ted);
         this->text = ted.Release();
@@ -789,23 +1000,24 @@ void Instance::Reparse(bool openInNewWindow)
             this->noItemsVisible = true; // hide all text
             AppCUI::Dialogs::MessageBox::ShowError("Error", "Fail to reparse current text !");
         }
-        this->Parse();
+        if ((!res) || (changeStart >= changeEnd) || (!ParseRange(oldTextSize, changeStart, changeEnd)))
+            this->Parse();
     }
 }
 bool Instance::RebuildTextFromTokens(TextEditor& editor)
 {
-    auto it  = this->tokens.crbegin();
-    auto end = this->tokens.crend();
-    for (; it != end; it++)
+    for (auto idx = static_cast<uint32>(this->tokens.size()); idx > 0; idx--)
     {
-        if (it->IsMarkForDeletion())
+        const auto& tok = this->tokens[idx - 1];
+        if (tok.IsMarkForDeletion())
         {
-            editor.Delete(it->start, it->end - it->start);
+            editor.Delete(tok.start, tok.end - tok.start);
             continue;
         }
-        if (it->value.Len() > 0)
+        const auto value = this->values.Get(idx - 1);
+        if (!value.empty())
         {
-            if (!editor.Replace(it->start, it->end - it->start, it->value.ToStringView()))
+            if (!editor.Replace(tok.start, tok.end - tok.start, value))
                 return false;
             continue;
         }
@@ -833,6 +1045,7 @@ void Instance::RestoreTokensPositionsFromBackup()
         index++;
     }
     backupedTokenPositionList.clear();
+    this->lineIndex.Build(this->tokens);
 }
 
 void Instance::FillBlockSpace(Graphics::Renderer& renderer, const BlockObject& block)
@@ -872,7 +1085,7 @@ void Instance::FillBlockSpace(Graphics::Renderer& renderer, const BlockObject& b
 
 void Instance::PaintToken(Graphics::Renderer& renderer, const TokenObject& tok, uint32 index)
 {
-    u16string_view txt = tok.GetText(this->text.text);
+    u16string_view txt = GetTokenText(index);
     ColorPair col;
     bool onCursor    = index == this->currentTokenIndex;
     bool onSelection = this->selection.Contains(index);
@@ -1024,26 +1237,16 @@ void Instance::Paint(Graphics::Renderer& renderer)
 
     const int32 scroll_right  = Scroll.x + (int32) this->GetWidth() - 1;
     const int32 scroll_bottom = Scroll.y + (int32) this->GetHeight() - 1;
-    uint32 idx                = 0;
     int32 lastY               = -1;
 
-    for (auto& t : this->tokens)
+    // only the tokens from the visible screen
+    this->lineIndex.GetTokensInRect(this->tokens, Scroll.x, Scroll.y, scroll_right, scroll_bottom, this->tokensInView);
+    for (auto idx : this->tokensInView)
     {
-        // skip hidden and current token
-        if ((!t.IsVisible()) || (idx == this->currentTokenIndex))
-        {
-            idx++;
-            continue;
-        }
-        const auto tk_right  = t.pos.x + (int32) t.pos.width - 1;
-        const auto tk_bottom = t.pos.y + (int32) t.pos.height - 1;
-
-        // if token not in visible screen => skip it
-        if ((t.pos.x > scroll_right) || (t.pos.y > scroll_bottom) || (tk_right < Scroll.x) || (tk_bottom < Scroll.y))
-        {
-            idx++;
+        // skip current token
+        if (idx == this->currentTokenIndex)
             continue;
-        }
+        const auto& t = this->tokens[idx];
         renderer.SetClipMargins(this->lineNrWidth, 0, 0, 0);
         PaintToken(renderer, t, idx);
         if (t.pos.y != lastY)
@@ -1053,7 +1256,6 @@ void Instance::Paint(Graphics::Renderer& renderer)
             renderer.WriteText(num.ToDec(t.lineNo), params);
             lastY = t.pos.y;
         }
-        idx++;
     }
     renderer.ResetClip();
     foldColumn.Paint(renderer, this->lineNrWidth - 1, this);
@@ -1158,115 +1360,43 @@ void Instance::MoveUp(uint32 times, bool selected)
         return;
     if (this->currentTokenIndex == 0)
         return;
-    uint32 idx = this->currentTokenIndex - 1;
-    auto lastY = this->tokens[this->currentTokenIndex].pos.y;
-    auto posX  = this->tokens[this->currentTokenIndex].pos.x;
-    while (times > 0)
-    {
-        while ((idx > 0) && (this->tokens[idx].pos.y == lastY))
-            idx--;
-
-        while ((idx > 0) && ((!this->tokens[idx].IsVisible()) || (this->tokens[idx].pos.y == lastY)))
-            idx--;
-
-        if (idx == 0)
-        {
-            if (this->tokens[0].IsVisible())
-            {
-                if (this->tokens[idx].pos.y == lastY)
-                {
-                    // already on the first line --> move to first token
-                    MoveToToken(0, selected, false);
-                    return;
-                }
-                // otherwise do nothing --> just decrease the times count
-            }
-            else
-            {
-                // move to first visible item
-                MoveToClosestVisibleToken(0, selected);
-                return;
-            }
-        }
-        lastY = this->tokens[idx].pos.y;
-        times--;
+    const auto& tok = this->tokens[this->currentTokenIndex];
+    // first line that is not above the current token (the current token might be hidden)
+    auto line = this->lineIndex.FindLine(tok.pos.y);
+    if (line == TokensLineIndex::INVALID_LINE)
+        line = this->lineIndex.GetLinesCount();
+    if (line < times)
+    {
+        // already on the first line --> move to first token
+        if (this->tokens[0].IsVisible())
+            MoveToToken(0, selected, false);
+        else
+            MoveToClosestVisibleToken(0, selected);
+        return;
     }
     // found the line that I am interested in --> now search the closest token in terms of position
-    auto found     = idx;
-    auto best_dist = ComputeXDist(this->tokens[found].pos.x, posX);
-    while ((idx > 0) && (best_dist > 0))
-    {
-        if (this->tokens[idx].IsVisible() == false)
-        {
-            idx--;
-            continue;
-        }
-        if (this->tokens[idx].pos.y != lastY)
-            break;
-        auto dist = ComputeXDist(this->tokens[idx].pos.x, posX);
-        if (dist < best_dist)
-        {
-            found     = idx;
-            best_dist = dist;
-        }
-        idx--;
-    }
-    if ((idx == 0) && (this->tokens[idx].IsVisible()))
-    {
-        // it is possible that the first token is the closest --> so test this
-        auto dist = ComputeXDist(this->tokens[idx].pos.x, posX);
-        if (dist < best_dist)
-        {
-            found     = idx;
-            best_dist = dist;
-        }
-    }
-    MoveToToken(found, selected, false);
+    MoveToToken(this->lineIndex.GetClosestToken(line - times, tok.pos.x, true), selected, false);
 }
 void Instance::MoveDown(uint32 times, bool selected)
 {
     if ((noItemsVisible) || (times == 0))
         return;
-    uint32 cnt = (uint32) this->tokens.size();
-    uint32 idx = this->currentTokenIndex + 1;
-    auto lastY = this->tokens[this->currentTokenIndex].pos.y;
-    auto posX  = this->tokens[this->currentTokenIndex].pos.x;
-    if (idx >= cnt)
+    const auto cnt  = (uint32) this->tokens.size();
+    const auto& tok = this->tokens[this->currentTokenIndex];
+    if (this->currentTokenIndex + 1 >= cnt)
+        return;
+    // first line below the current token
+    auto line = this->lineIndex.FindLine(tok.pos.y + 1);
+    if (line == TokensLineIndex::INVALID_LINE)
+        line = this->lineIndex.GetLinesCount();
+    if (line + times - 1 >= this->lineIndex.GetLinesCount())
+    {
+        // already on the last line --> move to last token
+        MoveToClosestVisibleToken(cnt - 1, selected);
         return;
-    while (times > 0)
-    {
-        while ((idx < cnt) && ((!this->tokens[idx].IsVisible()) || (this->tokens[idx].pos.y == lastY)))
-            idx++;
-        if (idx >= cnt)
-        {
-            // already on the last line --> move to last token
-            MoveToClosestVisibleToken(cnt - 1, selected);
-            return;
-        }
-        lastY = this->tokens[idx].pos.y;
-        times--;
     }
     // found the line that I am interested in --> now search the closest token in terms of position
-    auto found     = idx;
-    auto best_dist = ComputeXDist(this->tokens[found].pos.x, posX);
-    while ((idx < cnt) && (best_dist > 0))
-    {
-        if (this->tokens[idx].IsVisible() == false)
-        {
-            idx++;
-            continue;
-        }
-        if (this->tokens[idx].pos.y != lastY)
-            break;
-        auto dist = ComputeXDist(this->tokens[idx].pos.x, posX);
-        if (dist < best_dist)
-        {
-            found     = idx;
-            best_dist = dist;
-        }
-        idx++;
-    }
-    MoveToToken(found, selected, false);
+    MoveToToken(this->lineIndex.GetClosestToken(line + times - 1, tok.pos.x, false), selected, false);
 }
 void Instance::MoveToNextSimilarToken(int32 direction)
 {
@@ -1372,7 +1502,7 @@ void Instance::FoldAll()
 }
 void Instance::ShowStringOpDialog(TokenObject& tok)
 {
-    StringOpDialog dlg(tok, this->text.text, settings->parser);
+    StringOpDialog dlg(tok.GetOriginalText(this->text.text), GetTokenText(this->currentTokenIndex), settings->parser);
     if (dlg.Show() != Dialogs::Result::Ok)
         return;
     if (dlg.ShouldOpenANewWindow())
@@ -1410,6 +1540,8 @@ void Instance::ShowStringOpDialog(TokenObject& tok)
     else
     {
         // update value
+        this->values.Set(this->currentTokenIndex, dlg.GetNewValue());
+        this->errors.Remove(this->currentTokenIndex);
         UpdateTokensInformation();
         RecomputeTokenPositions();
     }
@@ -1424,7 +1556,11 @@ void Instance::ShowRefactorDialog(TokenObject& tok)
 
     // all good -> edit the token
     auto containerBlock = TokenToBlock(this->currentTokenIndex);
-    NameRefactorDialog dlg(tok, this->text.text, selection.HasSelection(0), containerBlock != BlockObject::INVALID_ID);
+    NameRefactorDialog dlg(
+          tok.GetOriginalText(this->text.text),
+          this->values.Get(this->currentTokenIndex),
+          selection.HasSelection(0),
+          containerBlock != BlockObject::INVALID_ID);
     if (dlg.Show() == Dialogs::Result::Ok)
     {
         auto method = dlg.GetApplyMethod();
@@ -1459,13 +1595,15 @@ void Instance::ShowRefactorDialog(TokenObject& tok)
             if (AppCUI::Dialogs::MessageBox::ShowOkCancel("Rename", tmp.Format("Rename %u tokens ?", count)) != AppCUI::Dialogs::Result::Ok)
                 return;
         }
+        LocalUnicodeStringBuilder<256> newValue;
+        newValue.Set(dlg.GetNewValue());
         for (auto idx = start; idx < end; idx++)
         {
             if (tokens[idx].hash == tok.hash)
-                tokens[idx].value = dlg.GetNewValue();
+                this->values.Set(idx, newValue.ToStringView());
         }
         // Update the original as well
-        tok.value = dlg.GetNewValue();
+        this->values.Set(this->currentTokenIndex, newValue.ToStringView());
         if (dlg.ShouldReparse())
         {
             this->Reparse(false);
@@ -1487,9 +1625,10 @@ void Instance::EditCurrentToken()
     auto& tok = this->tokens[this->currentTokenIndex];
     if (!tok.IsVisible())
         return;
-    if (tok.error.Len() > 0)
+    const auto error = this->errors.Get(this->currentTokenIndex);
+    if (!error.empty())
     {
-        AppCUI::Dialogs::MessageBox::ShowError("Error", tok.error);
+        AppCUI::Dialogs::MessageBox::ShowError("Error", error);
     }
     if (tok.dataType == TokenDataType::String)
         ShowStringOpDialog(tok);
@@ -1503,11 +1642,10 @@ void Instance::DeleteTokens()
         return;
     if ((size_t) this->currentTokenIndex >= this->tokens.size())
         return;
-    auto& tok = this->tokens[this->currentTokenIndex];
 
     // all good -> edit the token
     auto containerBlock = TokenToBlock(this->currentTokenIndex);
-    DeleteDialog dlg(tok, this->text.text, selection.HasSelection(0), containerBlock != BlockObject::INVALID_ID);
+    DeleteDialog dlg(GetTokenText(this->currentTokenIndex), selection.HasSelection(0), containerBlock != BlockObject::INVALID_ID);
     if (dlg.Show() == Dialogs::Result::Ok)
     {
         auto method = dlg.GetApplyMethod();
@@ -1823,10 +1961,22 @@ void Instance::ShowPlugins()
         RecomputeTokenPositions();
         break;
     case PluginAfterActionRequest::Rescan:
+    {
+        // only the part of the text that was modified by the plugin is analyzed again
+        const auto oldTextSize = this->text.size;
+        const auto minSize     = std::min<>(oldTextSize, textClone.size);
+        auto prefix            = 0U;
+        auto suffix            = 0U;
+        while ((prefix < minSize) && (this->text.text[prefix] == textClone.text[prefix]))
+            prefix++;
+        while ((suffix < minSize - prefix) && (this->text.text[oldTextSize - suffix - 1] == textClone.text[textClone.size - suffix - 1]))
+            suffix++;
         this->text.Destroy();
         this->text = textClone;
-        this->Parse();
+        if (((prefix == oldTextSize) && (prefix == textClone.size)) || (!ParseRange(oldTextSize, prefix, oldTextSize - suffix)))
+            this->Parse();
         break;
+    }
     default:
         textClone.Destroy();
         return;
@@ -1909,8 +2059,9 @@ void Instance::ShowSaveAsDialog()
     auto bom     = dlg.HasBOM() ? CharacterEncoding::GetBOMForEncoding(enc) : BufferView();
 
     b.Add(bom);
-    for (const auto& tok : this->tokens)
+    for (auto index = 0U; index < static_cast<uint32>(this->tokens.size()); index++)
     {
+        const auto& tok = this->tokens[index];
         if (tok.IsVisible() == false)
             continue;
         if (y < tok.pos.y)
@@ -1924,7 +2075,7 @@ void Instance::ShowSaveAsDialog()
             b.AddMultipleTimes(" ", tok.pos.x - x);
             x = tok.pos.x;
         }
-        auto txt    = tok.GetText(this->text.text);
+        auto txt    = GetTokenText(index);
         auto lastCH = static_cast<char16>(0);
         for (auto ch : txt)
         {
@@ -1994,7 +2145,7 @@ void Instance::ShowFindAllDialog()
         return;
     }
 
-    FindAllDialog dlg(tok, this->tokens, this->text.text);
+    FindAllDialog dlg(*this, this->currentTokenIndex);
 
     if (dlg.Show() == Dialogs::Result::Ok)
     {
@@ -2004,23 +2155,12 @@ void Instance::ShowFindAllDialog()
 //======================================================================[Mouse coords]========================
 uint32 Instance::MousePositionToTokenID(int x, int y)
 {
-    auto idx = 0U;
-    for (const auto& tok : this->tokens)
-    {
-        if (tok.IsVisible() == false)
-        {
-            idx++;
-            continue;
-        }
-        auto tokLeft   = tok.pos.x + lineNrWidth - Scroll.x;
-        auto tokTop    = tok.pos.y - Scroll.y;
-        auto tokRight  = tokLeft + static_cast<int32>(tok.pos.width);
-        auto tokBottom = tokTop + static_cast<int32>(tok.pos.height);
-        if ((x >= tokLeft) && (x < tokRight) && (y >= tokTop) && (y < tokBottom))
-            return idx;
-        idx++;
-    }
-    return Token::INVALID_INDEX;
+    const auto tokX = x - lineNrWidth + Scroll.x;
+    const auto tokY = y + Scroll.y;
+    this->lineIndex.GetTokensInRect(this->tokens, tokX, tokY, tokX, tokY, this->tokensInView);
+    if (this->tokensInView.empty())
+        return Token::INVALID_INDEX;
+    return this->tokensInView[0];
 }
 void Instance::OnMousePressed(int x, int y, AppCUI::Input::MouseButton button, Input::Key)
 {
@@ -2139,7 +2279,8 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         r.WriteSingleLineText(0, 0, "No information available", Cfg.Text.Inactive);
         return;
     }
-    const auto& tok = this->tokens[this->currentTokenIndex];
+    const auto& tok   = this->tokens[this->currentTokenIndex];
+    const auto error = this->errors.Get(this->currentTokenIndex);
     LocalString<128> tmp;
     auto xPoz = 0;
     switch (height)
@@ -2155,8 +2296,8 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 16, "Line:", tmp.Format("%d/%d", tok.lineNo, this->lastLineNumber));
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 9, "Col:", tmp.Format("%d", tok.pos.x + 1));
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 18, "Char ofs:", tmp.Format("%u", tok.start));
-        if (tok.error.Len() > 0)
-            xPoz = PrintError(tok.error, xPoz, 0, 50, r);
+        if (!error.empty())
+            xPoz = PrintError(error, xPoz, 0, 50, r);
         else
             xPoz = this->PrintTokenTypeInfo(tok.type, xPoz, 0, 30, r);
         break;
@@ -2169,9 +2310,9 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         xPoz = this->WriteCursorInfo(r, xPoz, 1, 16, "Col : ", tmp.Format("%d", tok.pos.x + 1));
         this->WriteCursorInfo(r, xPoz, 0, 18, "Char ofs: ", tmp.Format("%u", tok.start));
         xPoz = this->WriteCursorInfo(r, xPoz, 1, 18, "Tokens  : ", tmp.Format("%u", (size_t) tokens.size()));
-        this->WriteCursorInfo(r, xPoz, 0, 35, "Token     : ", tok.GetText(this->text.text));
-        if (tok.error.Len() > 0)
-            xPoz = PrintError(tok.error, xPoz, 1, 35, r);
+        this->WriteCursorInfo(r, xPoz, 0, 35, "Token     : ", GetTokenText(this->currentTokenIndex));
+        if (!error.empty())
+            xPoz = PrintError(error, xPoz, 1, 35, r);
         else
             xPoz = this->PrintTokenTypeInfo(tok.type, xPoz, 1, 35, r);
         break;
@@ -2182,10 +2323,10 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         PrintSelectionInfo(3, xPoz, 0, 16, r);
         this->WriteCursorInfo(r, xPoz, 1, 16, "Line: ", tmp.Format("%d/%d", tok.lineNo, this->lastLineNumber));
         xPoz = this->WriteCursorInfo(r, xPoz, 2, 16, "Col : ", tmp.Format("%d", tok.pos.x + 1));
-        this->WriteCursorInfo(r, xPoz, 0, 35, "Token     : ", tok.GetText(this->text.text));
+        this->WriteCursorInfo(r, xPoz, 0, 35, "Token     : ", GetTokenText(this->currentTokenIndex));
         this->PrintTokenTypeInfo(tok.type, xPoz, 1, 35, r);
-        if (tok.error.Len() > 0)
-            xPoz = PrintError(tok.error, xPoz, 2, 35, r);
+        if (!error.empty())
+            xPoz = PrintError(error, xPoz, 2, 35, r);
         else
             xPoz = this->PrintDataTypeInfo(tok.dataType, xPoz, 2, 35, r);
         break;
@@ -2202,11 +2343,11 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         xPoz = this->WriteCursorInfo(r, xPoz, 3, 20, "Tokens  : ", tmp.Format("%u", (size_t) tokens.size()));
 
         // Third column
-        this->WriteCursorInfo(r, xPoz, 0, 40, "Token     : ", tok.GetText(this->text.text));
+        this->WriteCursorInfo(r, xPoz, 0, 40, "Token     : ", GetTokenText(this->currentTokenIndex));
         this->WriteCursorInfo(r, xPoz, 1, 40, "Original  : ", tok.GetOriginalText(this->text.text));
         this->PrintTokenTypeInfo(tok.type, xPoz, 2, 40, r);
-        if (tok.error.Len() > 0)
-            xPoz = PrintError(tok.error, xPoz, 3, 40, r);
+        if (!error.empty())
+            xPoz = PrintError(error, xPoz, 3, 40, r);
         else
             xPoz = this->PrintDataTypeInfo(tok.dataType, xPoz, 3, 40, r);
 
@@ -2,6 +2,7 @@
 
 #include "Internal.hpp"
 #include <array>
+#include <unordered_map>
 
 #include "ImageViewer.hpp"
 
@@ -132,10 +133,10 @@ namespace View
             uint32 width, height;
             TokenStatus status;
         };
+        // hot data of a token (the replaced text and the error message are rarely used => they are kept in
+        // TokenStringsTable side tables, indexed by the token index)
         struct TokenObject
         {
-            UnicodeStringBuilder value;
-            UnicodeStringBuilder error;
             uint64 hash;
             uint32 start, end, type;
             uint32 blockID; // for blocks
@@ -205,29 +206,59 @@ namespace View
                 pos.status = static_cast<TokenStatus>(
                       static_cast<uint8>(pos.status) | static_cast<uint8>(TokenStatus::DisableSimilarityHighlight));
             }
-            void UpdateSizes(const char16* text);
-            inline void UpdateHash(const char16* text, bool ignoreCase)
+            // 'txt' is the text of the token (the replaced value or the original text)
+            void UpdateSizes(u16string_view txt);
+            inline void UpdateHash(u16string_view txt, bool ignoreCase)
             {
                 if ((static_cast<uint8>(pos.status) & static_cast<uint8>(TokenStatus::DisableSimilarityHighlight)) != 0)
                 {
                     this->hash = 0;
                     return;
                 }
-                if (this->value.Len() == 0)
-                    this->hash = TextParser::ComputeHash64({ text + start, (size_t) (end - start) }, ignoreCase);
-                else
-                    this->hash = TextParser::ComputeHash64(this->value.ToStringView(), ignoreCase);
+                this->hash = TextParser::ComputeHash64(txt, ignoreCase);
             }
             inline u16string_view GetOriginalText(const char16* text) const
             {
                 return { text + start, (size_t) (end - start) };
             }
-            inline u16string_view GetText(const char16* text) const
+        };
+        // strings attached to a few tokens (keyed by the token index), with the characters allocated from one arena
+        class TokenStringsTable
+        {
+            struct Entry
+            {
+                uint32 offset, size;
+            };
+            std::vector<char16> arena;
+            std::unordered_map<uint32, Entry> entries;
+            size_t unused; // characters from the arena that belong to values that were replaced or removed
+
+            void Compact();
+
+          public:
+            TokenStringsTable() : unused(0)
             {
-                if (this->value.Len() == 0)
-                    return { text + start, (size_t) (end - start) };
-                else
-                    return this->value.ToStringView();
+            }
+            void Clear();
+            // an empty value removes the string of that token
+            bool Set(uint32 index, u16string_view value);
+            bool Set(uint32 index, const ConstString& value);
+            void Remove(uint32 index);
+            // the strings of 'removedCount' tokens (starting from 'start') are replaced with the ones from 'inserted'
+            void Splice(uint32 start, uint32 removedCount, const TokenStringsTable& inserted, uint32 insertedCount);
+
+            inline u16string_view Get(uint32 index) const
+            {
+                if (entries.empty())
+                    return {};
+                const auto it = entries.find(index);
+                if (it == entries.end())
+                    return {};
+                return { arena.data() + it->second.offset, it->second.size };
+            }
+            inline bool Contains(uint32 index) const
+            {
+                return (!entries.empty()) && (entries.find(index) != entries.end());
             }
         };
 
@@ -292,6 +323,48 @@ namespace View
                 return BlockObject::INVALID_ID;
             }
         };
+        // visible tokens grouped by their line (pos.y) and sorted by pos.x => the tokens from a rectangle are
+        // found without iterating over the entire list of tokens (it has to be rebuilt every time positions change)
+        class TokensLineIndex
+        {
+            struct Entry
+            {
+                int32 x;
+                uint32 index;
+            };
+            struct Line
+            {
+                int32 y;
+                uint32 start; // first entry of the line (the entries end where the next line starts)
+            };
+            std::vector<Entry> entries;
+            std::vector<Line> lines; // the last line is a marker (for the end of the entries)
+            int32 maxWidth, maxHeight;
+
+          public:
+            static constexpr uint32 INVALID_LINE = 0xFFFFFFFF;
+
+            TokensLineIndex() : maxWidth(1), maxHeight(1)
+            {
+            }
+            void Clear();
+            void Build(const std::vector<TokenObject>& tokens);
+            // indexes (sorted) of the tokens that intersect the [left, right] x [top, bottom] rectangle
+            void GetTokensInRect(const std::vector<TokenObject>& tokens, int32 left, int32 top, int32 right, int32 bottom, std::vector<uint32>& output) const;
+            // first line with y >= the provided value (INVALID_LINE if there is none)
+            uint32 FindLine(int32 y) const;
+            // the token closest to x on a line (on equal distance, the last one or the first one is returned)
+            uint32 GetClosestToken(uint32 line, int32 x, bool preferLast) const;
+
+            inline uint32 GetLinesCount() const
+            {
+                return lines.empty() ? 0 : static_cast<uint32>(lines.size() - 1);
+            }
+            inline int32 GetLineY(uint32 line) const
+            {
+                return lines[line].y;
+            }
+        };
         struct PrettyFormatLayoutManager
         {
             int x, y, lastY;
@@ -301,6 +374,8 @@ namespace View
         class Instance : public View::ViewControl
         {
             FoldColumn foldColumn;
+            TokensLineIndex lineIndex;
+            std::vector<uint32> tokensInView;
             Utils::Selection selection;
             Pointer<SettingsData> settings;
             Reference<GView::Object> obj;
@@ -310,6 +385,7 @@ namespace View
             int32 lineNrWidth, lastLineNumber;
             bool noItemsVisible;
             bool showMetaData;
+            bool blocksMatched; // every block token from the last parsed text has a pair
             bool prettyFormat;
             bool highlightSimilarTokens;
 
@@ -368,6 +444,8 @@ namespace View
 
             bool RebuildTextFromTokens(TextEditor& edidor);
             void Parse();
+            bool ParseRange(uint32 oldTextSize, uint32 changeStart, uint32 changeEnd);
+            void RecomputeLineNumbers();
             void Reparse(bool openInNewWindow);
 
             int PrintSelectionInfo(uint32 selectionID, int x, int y, uint32 width, Renderer& r);
@@ -378,6 +456,8 @@ namespace View
           public:
             std::vector<TokenObject> tokens;
             std::vector<BlockObject> blocks;
+            TokenStringsTable values; // replaced text
+            TokenStringsTable errors;
 
           public:
             Instance(Reference<GView::Object> obj, Settings* settings);
@@ -390,6 +470,14 @@ namespace View
             {
                 return text.text;
             }
+            // the replaced value of a token (if any) or its original text
+            inline u16string_view GetTokenText(uint32 index) const
+            {
+                auto txt = values.Get(index);
+                if (txt.empty())
+                    return tokens[index].GetOriginalText(text.text);
+                return txt;
+            }
 
             virtual void Paint(Graphics::Renderer& renderer) override;
             virtual bool OnUpdateCommandBar(AppCUI::Application::CommandBar& commandBar) override;
@@ -431,13 +519,12 @@ namespace View
         };
         class NameRefactorDialog : public Window
         {
-            TokenObject& tok;
             Reference<TextField> txNewValue;
             Reference<RadioBox> rbApplyOnCurrent, rbApplyOnAll, rbApplyOnBlock, rbApplyOnSelection;
             Reference<CheckBox> cbReparse;
 
           public:
-            NameRefactorDialog(TokenObject& tok, const char16* text, bool hasSelection, bool belongsToABlock);
+            NameRefactorDialog(u16string_view originalText, u16string_view value, bool hasSelection, bool belongsToABlock);
             virtual bool OnEvent(Reference<Control>, Event eventType, int ID) override;
 
             inline bool ShouldReparse()
@@ -471,18 +558,18 @@ namespace View
         }
         class StringOpDialog : public Window
         {
-            TokenObject& tok;
+            u16string_view originalText, currentText;
             Reference<TextArea> txValue;
             Reference<ParseInterface> parser;
             TextEditorBuilder editor;
-            const char16* text;
+            UnicodeStringBuilder newValue;
             bool openInANewWindow;
             
             void UpdateValue(bool original);
             void UpdateTokenValue();
             void RunStringOperation(uint32 commandID);
           public:
-            StringOpDialog(TokenObject& tok, const char16* text, Reference<ParseInterface> parser);
+            StringOpDialog(u16string_view originalText, u16string_view currentText, Reference<ParseInterface> parser);
             virtual bool OnEvent(Reference<Control>, Event eventType, int ID) override;
             inline bool ShouldOpenANewWindow() const
             {
@@ -492,13 +579,17 @@ namespace View
             {
                 return txValue->GetText();
             }
+            inline u16string_view GetNewValue() const
+            {
+                return newValue.ToStringView();
+            }
         };
         class DeleteDialog : public Window
         {
             Reference<RadioBox> rbApplyOnCurrent, rbApplyOnBlock, rbApplyOnSelection;
 
           public:
-            DeleteDialog(TokenObject& tok, const char16* text, bool hasSelection, bool belongsToABlock);
+            DeleteDialog(u16string_view tokenText, bool hasSelection, bool belongsToABlock);
             virtual bool OnEvent(Reference<Control>, Event eventType, int ID) override;
             inline ApplyMethod GetApplyMethod()
             {
@@ -560,7 +651,7 @@ namespace View
             void Validate();
 
           public:
-            FindAllDialog(const TokenObject& currentToken,const std::vector<TokenObject>& tokens, const char16* txt);
+            FindAllDialog(const Instance& instance, uint32 currentTokenIndex);
 
             virtual bool OnEvent(Reference<Control>, Event eventType, int ID) override;
             inline uint32 GetSelectedTokenIndex() const
@@ -7,13 +7,13 @@ constexpr int32 BTN_ID_OK      = 1;
 constexpr int32 BTN_ID_CANCEL  = 2;
 constexpr int32 APPLY_GROUP_ID = 1;
 
-NameRefactorDialog::NameRefactorDialog(TokenObject& _tok, const char16* text, bool hasSelection, bool belongsToABlock)
-    : Window("Rename", "d:c,w:70,h:21", WindowFlags::ProcessReturn), tok(_tok)
+NameRefactorDialog::NameRefactorDialog(u16string_view originalText, u16string_view value, bool hasSelection, bool belongsToABlock)
+    : Window("Rename", "d:c,w:70,h:21", WindowFlags::ProcessReturn)
 {
     Factory::Label::Create(this, "Original text", "x:1,y:1,w:30");
-    Factory::TextArea::Create(this, tok.GetOriginalText(text), "x:1,y:2,w:65,h:4", TextAreaFlags::Readonly | TextAreaFlags::ShowLineNumbers);
+    Factory::TextArea::Create(this, originalText, "x:1,y:2,w:65,h:4", TextAreaFlags::Readonly | TextAreaFlags::ShowLineNumbers);
     Factory::Label::Create(this, "&New value (an empty field means using the original text)", "x:1,y:7,w:60");
-    this->txNewValue = Factory::TextField::Create(this, tok.value.ToStringView(), "x:1,y:8,w:65,h:1");
+    this->txNewValue = Factory::TextField::Create(this, value, "x:1,y:8,w:65,h:1");
     this->txNewValue->SetHotKey('N');
 
     // apply methods
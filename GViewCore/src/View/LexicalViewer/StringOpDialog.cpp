@@ -23,9 +23,9 @@ struct
              { "Un&escape characters", StringOperationsPlugins::UnescapedCharacters },
              { "Esc&ape non-ASCII Characters", StringOperationsPlugins::EscapeNonAsciiCharacters } };
 
-StringOpDialog::StringOpDialog(TokenObject& _tok, const char16* _text, Reference<ParseInterface> _parser)
-    : Window("String Operations", "d:c,w:80,h:20", WindowFlags::ProcessReturn | WindowFlags::Menu), tok(_tok), parser(_parser),
-      editor(nullptr, 0), text(_text), openInANewWindow(false)
+StringOpDialog::StringOpDialog(u16string_view _originalText, u16string_view _currentText, Reference<ParseInterface> _parser)
+    : Window("String Operations", "d:c,w:80,h:20", WindowFlags::ProcessReturn | WindowFlags::Menu), originalText(_originalText),
+      currentText(_currentText), parser(_parser), editor(nullptr, 0), openInANewWindow(false)
 {
     auto tokMnu = this->AddMenu("&Token");
     tokMnu->AddCommandItem("Restore &original value", CMD_ID_RELOAD_ORIGINAL);
@@ -53,7 +53,7 @@ StringOpDialog::StringOpDialog(TokenObject& _tok, const char16* _text, Reference
 void StringOpDialog::UpdateValue(bool original)
 {
     LocalUnicodeStringBuilder<512> tmp;
-    auto val = original ? tok.GetOriginalText(text) : tok.GetText(text);
+    auto val = original ? originalText : currentText;
     if (parser->StringToContent(val, tmp) == false)
     {
         AppCUI::Dialogs::MessageBox::ShowError(
@@ -114,9 +114,8 @@ void StringOpDialog::UpdateTokenValue()
         txValue->SetFocus();
         return;
     }
-    // all good --> set value to token
-    tok.value.Set(output);
-    tok.error.Clear();
+    // all good --> the value is set to the token (and its error is removed) by the caller
+    newValue.Set(output);
     Exit(Dialogs::Result::Ok);
 }
 bool StringOpDialog::OnEvent(Reference<Control> control, Event eventType, int ID)
@@ -161,13 +161,13 @@ bool Token::DisableSimilartyHighlight()
 bool Token::SetText(const ConstString& text)
 {
     CREATE_TOKENREF(false);
-    return tok.value.Set(text);
+    return INSTANCE->values.Set(this->index, text);
 }
 bool Token::SetError(const ConstString& error)
 {
     CREATE_TOKENREF(false);
     tok.color = TokenColor::Error;
-    return tok.error.Set(error);
+    return INSTANCE->errors.Set(this->index, error);
 }
 bool Token::Delete()
 {
@@ -186,15 +186,10 @@ std::optional<uint32> Token::GetTokenEndOffset() const
     return tok.end;
 }
 // Token Object
-void TokenObject::UpdateSizes(const char16* text)
+void TokenObject::UpdateSizes(u16string_view txt)
 {
-    const char16* p = text + start;
-    const char16* e = text + end;
-    if (this->value.Len() > 0)
-    {
-        p = this->value.GetString();
-        e = this->value.GetString() + this->value.Len();
-    }
+    const char16* p = txt.data();
+    const char16* e = p + txt.size();
     auto nrLines = 1U;
     auto w       = 0U;
     auto maxW    = 0U;
@@ -0,0 +1,94 @@
+#include "LexicalViewer.hpp"
+
+namespace GView::View::LexicalViewer
+{
+void TokenStringsTable::Clear()
+{
+    this->arena.clear();
+    this->entries.clear();
+    this->unused = 0;
+}
+void TokenStringsTable::Compact()
+{
+    // copy the strings that are still used in a new arena (in the order of the tokens)
+    std::vector<uint32> indexes;
+    indexes.reserve(this->entries.size());
+    for (const auto& [index, entry] : this->entries)
+        indexes.push_back(index);
+    std::sort(indexes.begin(), indexes.end());
+
+    std::vector<char16> compacted;
+    compacted.reserve(this->arena.size() - this->unused);
+    for (auto index : indexes)
+    {
+        auto& entry = this->entries[index];
+        const auto* p = this->arena.data() + entry.offset;
+        entry.offset  = static_cast<uint32>(compacted.size());
+        compacted.insert(compacted.end(), p, p + entry.size);
+    }
+    this->arena  = std::move(compacted);
+    this->unused = 0;
+}
+bool TokenStringsTable::Set(uint32 index, u16string_view value)
+{
+    if (value.empty())
+    {
+        Remove(index);
+        return true;
+    }
+    CHECK(this->arena.size() + value.size() <= 0xFFFFFFFFULL, false, "Token strings arena is full");
+    auto& entry = this->entries[index];
+    if ((entry.size > 0) && (value.size() <= entry.size))
+    {
+        // the new value fits in the space of the old one
+        std::copy(value.begin(), value.end(), this->arena.begin() + entry.offset);
+        this->unused += entry.size - value.size();
+        entry.size = static_cast<uint32>(value.size());
+        return true;
+    }
+    this->unused += entry.size;
+    entry.offset = static_cast<uint32>(this->arena.size());
+    entry.size   = static_cast<uint32>(value.size());
+    this->arena.insert(this->arena.end(), value.begin(), value.end());
+    if (this->unused > this->arena.size() / 2)
+        Compact();
+    return true;
+}
+bool TokenStringsTable::Set(uint32 index, const ConstString& value)
+{
+    LocalUnicodeStringBuilder<256> tmp;
+    CHECK(tmp.Set(value), false, "Fail to convert token string");
+    return Set(index, tmp.ToStringView());
+}
+void TokenStringsTable::Remove(uint32 index)
+{
+    const auto it = this->entries.find(index);
+    if (it == this->entries.end())
+        return;
+    this->unused += it->second.size;
+    this->entries.erase(it);
+    if (this->entries.empty())
+        Clear();
+}
+void TokenStringsTable::Splice(uint32 start, uint32 removedCount, const TokenStringsTable& inserted, uint32 insertedCount)
+{
+    std::unordered_map<uint32, Entry> moved;
+    moved.reserve(this->entries.size() + inserted.entries.size());
+    for (const auto& [index, entry] : this->entries)
+    {
+        if (index < start)
+            moved[index] = entry;
+        else if (index - start >= removedCount)
+            moved[index - removedCount + insertedCount] = entry;
+        else
+            this->unused += entry.size;
+    }
+    this->entries = std::move(moved);
+    for (const auto& [index, entry] : inserted.entries)
+        Set(start + index, u16string_view{ inserted.arena.data() + entry.offset, entry.size });
+    if (this->entries.empty())
+        Clear();
+    else if (this->unused > this->arena.size() / 2)
+        Compact();
+}
+} // namespace GView::View::LexicalViewer
@@ -0,0 +1,96 @@
+#include "LexicalViewer.hpp"
+
+namespace GView::View::LexicalViewer
+{
+void TokensLineIndex::Clear()
+{
+    this->entries.clear();
+    this->lines.clear();
+    this->maxWidth  = 1;
+    this->maxHeight = 1;
+}
+void TokensLineIndex::Build(const std::vector<TokenObject>& tokens)
+{
+    Clear();
+    auto idx = 0U;
+    for (const auto& tok : tokens)
+    {
+        if (tok.IsVisible())
+        {
+            this->entries.push_back({ tok.pos.x, idx });
+            this->maxWidth  = std::max<>(this->maxWidth, static_cast<int32>(tok.pos.width));
+            this->maxHeight = std::max<>(this->maxHeight, static_cast<int32>(tok.pos.height));
+        }
+        idx++;
+    }
+    // tokens are usually already sorted by their position (from top to bottom) => stable sort by (y, x)
+    std::stable_sort(
+          this->entries.begin(),
+          this->entries.end(),
+          [&tokens](const Entry& a, const Entry& b)
+          {
+              const auto ya = tokens[a.index].pos.y;
+              const auto yb = tokens[b.index].pos.y;
+              if (ya != yb)
+                  return ya < yb;
+              return a.x < b.x;
+          });
+
+    const auto count = static_cast<uint32>(this->entries.size());
+    for (auto pos = 0U; pos < count; pos++)
+    {
+        const auto y = tokens[this->entries[pos].index].pos.y;
+        if ((this->lines.empty()) || (this->lines.back().y != y))
+            this->lines.push_back({ y, pos });
+    }
+    this->lines.push_back({ std::numeric_limits<int32>::max(), count });
+}
+uint32 TokensLineIndex::FindLine(int32 y) const
+{
+    if (this->lines.empty())
+        return INVALID_LINE;
+    const auto it = std::lower_bound(this->lines.begin(), this->lines.end() - 1, y, [](const Line& line, int32 value) { return line.y < value; });
+    if (it == this->lines.end() - 1)
+        return INVALID_LINE;
+    return static_cast<uint32>(it - this->lines.begin());
+}
+void TokensLineIndex::GetTokensInRect(
+      const std::vector<TokenObject>& tokens, int32 left, int32 top, int32 right, int32 bottom, std::vector<uint32>& output) const
+{
+    output.clear();
+    // tokens that start above (or to the left of) the rectangle can still overlap it (up to their height / width)
+    auto line = FindLine(top - (this->maxHeight - 1));
+    if (line == INVALID_LINE)
+        return;
+    const auto minX = left - (this->maxWidth - 1);
+    for (; (line + 1 < this->lines.size()) && (this->lines[line].y <= bottom); line++)
+    {
+        const auto b = this->entries.begin() + this->lines[line].start;
+        const auto e = this->entries.begin() + this->lines[line + 1].start;
+        for (auto it = std::lower_bound(b, e, minX, [](const Entry& entry, int32 value) { return entry.x < value; }); (it != e) && (it->x <= right); it++)
+        {
+            const auto& tok      = tokens[it->index];
+            const auto tk_right  = tok.pos.x + (int32) tok.pos.width - 1;
+            const auto tk_bottom = tok.pos.y + (int32) tok.pos.height - 1;
+            if ((tk_right >= left) && (tk_bottom >= top))
+                output.push_back(it->index);
+        }
+    }
+    // same order as in the list of tokens (the tokens are painted in this order)
+    std::sort(output.begin(), output.end());
+}
+uint32 TokensLineIndex::GetClosestToken(uint32 line, int32 x, bool preferLast) const
+{
+    if (line + 1 >= this->lines.size())
+        return Token::INVALID_INDEX;
+    const auto b   = this->entries.begin() + this->lines[line].start;
+    const auto e   = this->entries.begin() + this->lines[line + 1].start;
+    const auto cmp = [](const Entry& entry, int32 value) { return entry.x < value; };
+    auto it        = std::lower_bound(b, e, x, cmp);
+    if ((it == e) || ((it != b) && (x - (it - 1)->x < it->x - x)) || ((it != b) && (x - (it - 1)->x == it->x - x) && (!preferLast)))
+        it--; // the token on the left is closer
+    if (!preferLast)
+        return std::lower_bound(b, e, it->x, cmp)->index;
+    return (std::upper_bound(b, e, it->x, [](int32 value, const Entry& entry) { return value < entry.x; }) - 1)->index;
+}
+} // namespace GView::View::LexicalViewer
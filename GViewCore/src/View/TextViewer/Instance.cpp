@@ -197,7 +197,7 @@ uint8 GetCharGroup(char16 ch)
 class DataCharacterStream
 {
     GView::Utils::DataCache& dataCache;
-    std::vector<LineInfo>& lines;
+    LineIndexer& lines;
     Reference<SettingsData> settings;
     uint32 linesCount;
     uint32 charIndex;
@@ -205,18 +205,20 @@ class DataCharacterStream
 
     bool ConvertLine(uint32 lineNo)
     {
+        LineInfo li;
         CHECK(lineNo < linesCount, false, "");
-        auto buf = dataCache.Get(lines[lineNo].offset, lines[lineNo].size, false);
+        CHECK(lines.GetLine(lineNo, li), false, "");
+        auto buf = dataCache.Get(li.offset, li.size, false);
         CHECK(tempLine.Create(buf, settings), false, "");
         currentLine = lineNo;
         return true;
     }
 
   public:
-    DataCharacterStream(std::vector<LineInfo>& li, Reference<SettingsData> _settings, GView::Utils::DataCache& cache)
+    DataCharacterStream(LineIndexer& li, Reference<SettingsData> _settings, GView::Utils::DataCache& cache)
         : settings(_settings), dataCache(cache), lines(li)
     {
-        linesCount  = static_cast<uint32>(li.size());
+        linesCount  = li.GetLinesCount();
         currentLine = 0;
         charIndex   = 0;
     }
@@ -288,14 +290,21 @@ Instance::Instance(Reference<GView::Object> _obj, Settings* _settings)
     if (config.Loaded == false)
         config.Initialize();
 
-    this->lineNumberWidth = 0;
+    this->lineNumberWidth     = 0;
+    this->estimatedLinesCount = 0;
+    this->lineIndexComplete   = false;
     this->SubLines.entries.reserve(256); // reserve 256 sub-lines
     this->SubLines.lineNo  = INVALID_LINE_NUMBER;
     this->ViewPort.scrollX = 0;
     this->ViewPort.Reset();
     this->mouseStatus = MouseStatus::None;
 
-    this->settings->encoding = CharacterEncoding::AnalyzeBufferForEncoding(this->obj->GetData().Get(0, 4096, false), true, this->sizeOfBOM);
+    // reuse the encoding detected during type identification (it was computed over a larger buffer)
+    uint8 probedEncoding;
+    if (this->obj->GetProbedEncoding(probedEncoding, this->sizeOfBOM))
+        this->settings->encoding = static_cast<CharacterEncoding::Encoding>(probedEncoding);
+    else
+        this->settings->encoding = CharacterEncoding::AnalyzeBufferForEncoding(this->obj->GetData().Get(0, 4096, false), true, this->sizeOfBOM);
     this->MoveTo(0, 0, false);
 }
 
@@ -327,104 +336,42 @@ void Instance::RecomputeLineIndexes()
     // first --> simple estimation
     auto buf        = this->obj->GetData().Get(0, 4096, false);
     auto sz         = this->obj->GetData().GetSize();
-    auto csz        = this->obj->GetData().GetCacheSize() & 0xFFFFFFF0; // make sure that csz is odd
     auto crlf_count = (uint64) 1;
 
     for (auto ch : buf)
         if ((ch == '\n') || (ch == '\r'))
             crlf_count++;
 
-    auto estimated_count = ((crlf_count * sz) / buf.GetLength()) + 16;
-
-    this->lines.clear();
-    this->lines.reserve(estimated_count);
-
-    uint64 offset    = this->sizeOfBOM;
-    uint64 start     = this->sizeOfBOM;
-    uint32 charCount = 0;
-    char16 lastChar  = 0;
-
-    CharacterEncoding::ExpandedCharacter ch;
-
-    while (offset < sz)
-    {
-        buf = this->obj->GetData().Get(offset, csz, false);
-        if (buf.Empty())
-            return;
-        // process the buffer
-        auto* p       = buf.begin();
-        auto* e       = buf.end();
-        auto* loopEnd = buf.end();
-        if (((offset + buf.GetLength()) < sz) && (buf.GetLength() > 16))
-        {
-            // if this is a partial part of the file and it has more then 16 bytes, deduct 8 bytes to make sure that any possible conversion
-            // will be made
-            loopEnd -= 8;
-        }
-        while (p < loopEnd)
-        {
-            if (ch.FromEncoding(this->settings->encoding, p, e))
-            {
-                p += ch.Length();
-                auto chr = ch.GetChar();
-                if (((chr == '\n') && (lastChar != '\r')) || ((chr == '\r') && (lastChar != '\n')))
-                {
-                    // end of the current line
-                    lines.emplace_back(start, charCount, (uint32) (offset - start));
-                    offset += ch.Length();
-                    start     = offset;
-                    charCount = 0;
-                    lastChar  = chr;
-                    continue;
-                }
+    this->estimatedLinesCount = buf.Empty() ? 1 : ((crlf_count * sz) / buf.GetLength()) + 16;
 
-                // combined CRLF or LFCR
-                if (((chr == '\n') && (lastChar == '\r')) || ((chr == '\r') && (lastChar == '\n')))
-                {
-                    // just advanced one extra char (no new line found)
-                    offset += ch.Length();
-                    start     = offset;
-                    charCount = 0;
-                    lastChar  = 0; // important as the CRLF or LFCR has ended
-                    continue;
-                }
+    // the index is built in background => only wait for the lines from the first screen
+    this->lineIndexer.Start(this->obj->GetData(), this->settings->encoding, this->sizeOfBOM);
+    this->lineIndexer.Wait(MAX_LINES_TO_VIEW);
+    this->lineIndexComplete = false;
+    UpdateLineNumberWidth();
+}
+void Instance::UpdateLineIndexes(uint32 minimumLines, uint64 minimumOffset)
+{
+    // publishes the lines indexed so far, but first waits (if requested) for 'minimumLines' lines and for the line that contains 'minimumOffset'
+    const auto linesCount = this->lineIndexer.GetLinesCount();
+    this->lineIndexer.Wait(minimumLines);
+    if (minimumOffset > 0)
+        this->lineIndexer.WaitForOffset(minimumOffset);
+    if (linesCount == this->lineIndexer.GetLinesCount())
+        return;
 
-                // other character
-                lastChar = 0; // don't care
-                charCount++;
-                offset += ch.Length();
-                if (charCount > 2000)
-                {
-                    // limit line to 2000 characters
-                    lines.emplace_back(start, charCount, (uint32) (offset - start));
-                    start     = offset;
-                    charCount = 0;
-                }
-            }
-            else
-            {
-                // need to treat conversion error
-                // consider one character (binary format)
-                charCount++;
-                offset++;
-                p++;
-                if (charCount > 2000)
-                {
-                    // limit line to 2000 characters
-                    lines.emplace_back(start, charCount, (uint32) (offset - start));
-                    start     = offset;
-                    charCount = 0;
-                }
-            }
-        }
-        if (charCount > 0)
-        {
-            // last line
-            lines.emplace_back(start, charCount, (uint32) (offset - start));
-        }
-    }
+    UpdateLineNumberWidth();
+    // the view port might have been shorter than the screen (not enough lines were indexed)
+    if (this->ViewPort.End.lineNo + 1 >= linesCount)
+        this->ComputeViewPort(this->ViewPort.Start.lineNo, this->ViewPort.Start.subLineNo, Direction::TopToBottom);
+}
+void Instance::UpdateLineNumberWidth()
+{
+    // while the index is built, the estimation is used (so that the width does not change with every update)
+    auto linesCount = static_cast<uint64>(this->lineIndexer.GetLinesCount()) + 1;
+    if (!this->lineIndexer.IsComplete())
+        linesCount = std::max<>(linesCount, this->estimatedLinesCount);
 
-    auto linesCount = this->lines.size() + 1;
     if (linesCount < 10)
         this->lineNumberWidth = 2;
     else if (linesCount < 100)
@@ -442,21 +389,16 @@ void Instance::RecomputeLineIndexes()
 }
 bool Instance::GetLineInfo(uint32 lineNo, LineInfo& li)
 {
-    if (lineNo >= this->lines.size())
-        return false;
-    li = this->lines[lineNo];
-    return true;
+    return this->lineIndexer.GetLine(lineNo, li);
 }
 LineInfo Instance::GetLineInfo(uint32 lineNo)
 {
-    const auto sz = this->lines.size();
-    if (lineNo < sz)
-        return this->lines[lineNo];
-    // if its outside --> always return the last line
+    LineInfo li(0, 0, 0);
+    const auto sz = this->lineIndexer.GetLinesCount();
+    // if its outside --> always return the last line (otherwise an empty line)
     if (sz > 0)
-        return this->lines[sz - 1];
-    // otherwise return an empty line
-    return LineInfo(0, 0, 0);
+        this->lineIndexer.GetLine(std::min<>(lineNo, sz - 1), li);
+    return li;
 }
 void Instance::ComputeSubLineIndexes(uint32 lineNo, BufferView& buf, uint64& startOffset)
 {
@@ -631,10 +573,10 @@ void Instance::CommputeViewPort_NoWrap(uint32 lineNo, Direction dir)
     }
 
     ViewPort.Reset();
-    if (this->lines.empty())
+    if (this->lineIndexer.GetLinesCount() == 0)
         return;
 
-    uint32 lastLineNo = static_cast<uint32>(this->lines.size() - 1); // lines.size() will alway be bigger than 1
+    uint32 lastLineNo = this->lineIndexer.GetLinesCount() - 1; // the lines count will alway be bigger than 1
 
     // sets the view port
     ViewPort.Start.lineNo    = start;
@@ -662,7 +604,7 @@ void Instance::CommputeViewPort_Wrap(uint32 lineNo, uint32 subLineNo, Direction
     auto h = (std::min<>(static_cast<uint32>(std::max<>(this->GetHeight(), 1)), MAX_LINES_TO_VIEW));
 
     ViewPort.Reset();
-    if (this->lines.empty())
+    if (this->lineIndexer.GetLinesCount() == 0)
         return;
     if (dir == Direction::TopToBottom)
     {
@@ -675,7 +617,7 @@ void Instance::CommputeViewPort_Wrap(uint32 lineNo, uint32 subLineNo, Direction
         auto* l                  = ViewPort.Lines;
         const auto* l_max        = l + h;
 
-        while ((l < l_max) && (start < this->lines.size()))
+        while ((l < l_max) && (start < this->lineIndexer.GetLinesCount()))
         {
             auto lineInfo = GetLineInfo(start);
             ComputeSubLineIndexes(start);
@@ -755,14 +697,14 @@ void Instance::MoveTo(uint32 lineNo, uint32 charIndex, bool select)
     if (select)
         sidx = this->selection.BeginSelection(this->Cursor.pos);
     // sanity checks
-    if (this->lines.size() == 0)
+    if (this->lineIndexer.GetLinesCount() == 0)
     {
         lineNo = 0;
     }
     else
     {
-        if (lineNo >= static_cast<uint32>(this->lines.size()))
-            lineNo = static_cast<uint32>(this->lines.size() - 1);
+        if (lineNo >= this->lineIndexer.GetLinesCount())
+            lineNo = this->lineIndexer.GetLinesCount() - 1;
     }
     LineInfo li = GetLineInfo(lineNo);
     if (charIndex >= li.charsCount)
@@ -792,8 +734,8 @@ void Instance::MoveTo(uint32 lineNo, uint32 charIndex, bool select)
 }
 void Instance::MoveToStartOfLine(uint32 lineNo, bool select)
 {
-    if (lineNo >= this->lines.size())
-        MoveToEndOfLine(static_cast<uint32>(this->lines.size() - 1), select); // last position
+    if (lineNo >= this->lineIndexer.GetLinesCount())
+        MoveToEndOfLine(this->lineIndexer.GetLinesCount() - 1, select); // last position
     else
         MoveTo(lineNo, 0, select);
 }
@@ -807,9 +749,10 @@ void Instance::MoveToEndOfLine(uint32 lineNo, bool select)
 }
 void Instance::MoveToEndOfFile(bool select)
 {
-    if (this->lines.empty())
+    UpdateLineIndexes(0xFFFFFFFF); // the last line is known only after the entire file is indexed
+    if (this->lineIndexer.GetLinesCount() == 0)
         return;
-    MoveTo(static_cast<uint32>(this->lines.size() - 1), 0xFFFFFFFF, select);
+    MoveTo(this->lineIndexer.GetLinesCount() - 1, 0xFFFFFFFF, select);
 }
 void Instance::MoveLeft(bool select)
 {
@@ -835,7 +778,7 @@ void Instance::MoveRight(bool select)
 }
 void Instance::MoveToNextWord(bool select)
 {
-    DataCharacterStream dcs(this->lines, this->settings.get(), this->obj->GetData());
+    DataCharacterStream dcs(this->lineIndexer, this->settings.get(), this->obj->GetData());
     if (!dcs.Init(this->Cursor.lineNo, this->Cursor.charIndex))
         return;
     auto group = GetCharGroup(dcs.GetChar());
@@ -847,9 +790,9 @@ void Instance::MoveToNextWord(bool select)
 }
 void Instance::MoveDown(uint32 noOfTimes, bool select)
 {
-    if (this->lines.size() == 0)
+    if (this->lineIndexer.GetLinesCount() == 0)
         return; // safety check
-    uint32 lastLine = static_cast<uint32>(this->lines.size() - 1);
+    uint32 lastLine = this->lineIndexer.GetLinesCount() - 1;
     if (HasWordWrap())
     {
         auto lineNo = this->Cursor.lineNo;
@@ -971,7 +914,7 @@ void Instance::MoveScrollUp()
 }
 void Instance::MoveToPreviousWord(bool select)
 {
-    DataCharacterStream dcs(this->lines, this->settings.get(), this->obj->GetData());
+    DataCharacterStream dcs(this->lineIndexer, this->settings.get(), this->obj->GetData());
     if (!dcs.Init(this->Cursor.lineNo, this->Cursor.charIndex))
         return;
     auto group = GetCharGroup(dcs.GetChar());
@@ -1255,6 +1198,7 @@ void Instance::Paint(Graphics::Renderer& renderer)
     auto lineNo      = INVALID_LINE_NUMBER;
     const auto focus = this->HasFocus();
 
+    UpdateLineIndexes();
     if (this->ViewPort.linesCount == 0)
     {
         this->ComputeViewPort(0, 0, Direction::TopToBottom);
@@ -1291,6 +1235,7 @@ bool Instance::OnUpdateCommandBar(AppCUI::Application::CommandBar& commandBar)
 }
 bool Instance::OnKeyEvent(AppCUI::Input::Key keyCode, char16 characterCode)
 {
+    UpdateLineIndexes();
     switch (keyCode)
     {
     case Key::Left:
@@ -1420,11 +1365,11 @@ bool Instance::OnEvent(Reference<Control>, Event eventType, int ID)
 }
 void Instance::OnUpdateScrollBars()
 {
-    if (this->lines.size() > 0)
+    LineInfo fistLine, lastLine;
+    const auto linesCount = this->lineIndexer.GetLinesCount();
+    if ((linesCount > 0) && (GetLineInfo(0, fistLine)) && (GetLineInfo(linesCount - 1, lastLine)))
     {
-        const auto& fistLine = this->lines[0];
-        const auto& lastLine = this->lines[this->lines.size() - 1];
-        const auto maxOfs    = lastLine.offset + lastLine.size;
+        const auto maxOfs    = this->lineIndexer.IsComplete() ? lastLine.offset + lastLine.size : this->obj->GetData().GetSize();
         auto pos             = std::max<>(this->Cursor.pos, fistLine.offset);
         this->UpdateVScrollBar(std::min<>(pos, maxOfs), maxOfs);
     }
@@ -1433,6 +1378,21 @@ void Instance::OnUpdateScrollBars()
         this->UpdateVScrollBar(0, 0);
     }
 }
+bool Instance::OnFrameUpdate()
+{
+    // the lines indexed in background are shown as they are published (not only after a key is pressed)
+    if (this->lineIndexComplete)
+        return false;
+    const auto linesCount = this->lineIndexer.GetLinesCount();
+    UpdateLineIndexes();
+    if (this->lineIndexer.IsComplete())
+    {
+        this->lineIndexComplete = true;
+        UpdateLineNumberWidth(); // the estimated lines count is no longer used
+        return true;
+    }
+    return linesCount != this->lineIndexer.GetLinesCount();
+}
 void Instance::SetWrapMethod(WrapMethod method)
 {
     this->settings->wrapMethod = method;
@@ -1444,15 +1404,9 @@ void Instance::SetWrapMethod(WrapMethod method)
 }
 bool Instance::GoTo(uint64 offset)
 {
-    auto lineNo = 0U;
-    for (lineNo = 0U; lineNo < this->lines.size(); lineNo++)
-    {
-        if (offset < this->lines[lineNo].offset)
-            break;
-    }
-    if (lineNo > 0)
-        lineNo--;
-    auto li     = GetLineInfo(lineNo);
+    UpdateLineIndexes(0, offset);
+    const auto lineNo = this->lineIndexer.OffsetToLine(offset);
+    auto li           = GetLineInfo(lineNo);
     auto cIndex = 0U;
     CharacterStream cs(this->obj->GetData().Get(li.offset, li.size, false), 0, this->settings.ToReference());
     while (cs.Next())
@@ -1470,11 +1424,16 @@ bool Instance::Select(uint64 offset, uint64 size)
 }
 bool Instance::ShowGoToDialog()
 {
-    GoToDialog dlg(this->Cursor.pos, this->obj->GetData().GetSize(), this->Cursor.lineNo + 1U, static_cast<uint32>(this->lines.size()));
+    // while the index is built, any line that a file of this size can have is accepted (the index is built up to that line)
+    UpdateLineIndexes();
+    const auto size     = this->obj->GetData().GetSize();
+    const auto maxLines = this->lineIndexer.IsComplete() ? this->lineIndexer.GetLinesCount() : static_cast<uint32>(std::min<uint64>(size + 1, 0xFFFFFFFEULL));
+    GoToDialog dlg(this->Cursor.pos, size, this->Cursor.lineNo + 1U, maxLines);
     if (dlg.Show() == Dialogs::Result::Ok)
     {
         if (dlg.ShouldGoToLine())
         {
+            UpdateLineIndexes(dlg.GetLine() + 1);
             MoveTo(dlg.GetLine(), 0, false);
         }
         else
@@ -1655,7 +1614,7 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
             xPoz = PrintSelectionInfo(2, xPoz, 0, 16, r);
             xPoz = PrintSelectionInfo(3, xPoz, 0, 16, r);
         }
-        xPoz = this->WriteCursorInfo(r, xPoz, 0, 20, "Line:", tmp.Format("%d/%d", Cursor.lineNo + 1, (uint32) lines.size()));
+        xPoz = this->WriteCursorInfo(r, xPoz, 0, 20, "Line:", tmp.Format("%d/%d%s", Cursor.lineNo + 1, this->lineIndexer.GetLinesCount(), this->lineIndexer.IsComplete() ? "" : "+"));
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 10, "Col:", tmp.Format("%d", Cursor.charIndex + 1));
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 20, "File ofs: ", tmp.Format("%llu", Cursor.pos));
     }
@@ -1665,7 +1624,7 @@ void Instance::PaintCursorInformation(AppCUI::Graphics::Renderer& r, uint32 widt
         xPoz = PrintSelectionInfo(2, 0, 1, 16, r);
         PrintSelectionInfo(1, xPoz, 0, 16, r);
         xPoz = PrintSelectionInfo(3, xPoz, 1, 16, r);
-        this->WriteCursorInfo(r, xPoz, 0, 20, "Line:", tmp.Format("%d/%d", Cursor.lineNo + 1, (uint32) lines.size()));
+        this->WriteCursorInfo(r, xPoz, 0, 20, "Line:", tmp.Format("%d/%d%s", Cursor.lineNo + 1, this->lineIndexer.GetLinesCount(), this->lineIndexer.IsComplete() ? "" : "+"));
         xPoz = this->WriteCursorInfo(r, xPoz, 1, 20, "Col:", tmp.Format("%d", Cursor.charIndex + 1));
         xPoz = this->WriteCursorInfo(r, xPoz, 0, 20, "File ofs: ", tmp.Format("%llu", Cursor.pos));
     }
@@ -0,0 +1,507 @@
+#include "TextViewer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#    define TEXTVIEWER_SSE2
+#    include <emmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+using namespace GView::View::TextViewer;
+
+constexpr uint64 INDEX_TASK_SIZE     = 0x800000; // 8 MB / task
+constexpr uint32 INDEX_BLOCK_SIZE    = 0x100000; // bytes read at once by a task
+constexpr uint32 INDEX_LOOKAHEAD     = 8;        // bytes left for the next block (a character might be split between blocks)
+constexpr uint32 INDEX_FLUSH_LINES   = 0x4000;   // lines are handed to the UI thread in batches
+constexpr uint32 WINDOW_BLOCK_SIZE   = 0x10000;  // bytes read at once when the lines of a window are decoded
+constexpr uint32 MAX_LINE_CHARACTERS = 2000;     // longer lines are split
+constexpr uint64 SPARSE_INDEX_SIZE   = 0x4000000; // files bigger than 64 MB use a sparse index
+
+static inline bool IsNewLineByte(uint8 value)
+{
+    return (value == '\n') || (value == '\r');
+}
+
+#ifdef TEXTVIEWER_SSE2
+static inline uint32 FirstSetBit(uint32 mask)
+{
+#    if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32>(index);
+#    else
+    return static_cast<uint32>(__builtin_ctz(mask));
+#    endif
+}
+#endif
+
+// first byte from [p, e) that is '\n' or '\r' (or >= 0x80 if 'nonASCII' is true), 'e' if there is none
+template <bool nonASCII>
+static const uint8* FindSpecialByte(const uint8* p, const uint8* e)
+{
+#ifdef TEXTVIEWER_SSE2
+    const auto lf = _mm_set1_epi8('\n');
+    const auto cr = _mm_set1_epi8('\r');
+    for (; p + 16 <= e; p += 16)
+    {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto mask    = static_cast<uint32>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr))));
+        if (nonASCII)
+            mask |= static_cast<uint32>(_mm_movemask_epi8(v));
+        if (mask)
+            return p + FirstSetBit(mask);
+    }
+#endif
+    for (; p < e; p++)
+    {
+        if (IsNewLineByte(*p) || (nonASCII && (*p >= 0x80)))
+            return p;
+    }
+    return e;
+}
+
+// A line break (or an ASCII character) is a single byte that can not be part of another character in ASCII / UTF-8
+// => those files can be split after a line break that is followed by an ASCII character. At that position every line
+// was closed and a pending CR/LF pair was either closed or is discarded by the ASCII character => the tasks are
+// independent (no carry-over between them).
+static inline bool IsParallelEncoding(CharacterEncoding::Encoding encoding)
+{
+    return (encoding == CharacterEncoding::Encoding::Ascii) || (encoding == CharacterEncoding::Encoding::UTF8);
+}
+
+namespace GView::View::TextViewer
+{
+// same rules as the sequential algorithm: one line for every CR, LF, CRLF or LFCR, lines longer than
+// MAX_LINE_CHARACTERS are split and a character that can not be decoded is one (binary) character.
+class LineScanner
+{
+    std::vector<LineInfo>* lines;
+    std::vector<LineIndexer::Checkpoint>* checkpoints;
+    uint64 count;
+    uint64 start;
+    uint32 charCount;
+    char16 lastChar;
+
+    inline void EndLine(uint64 end, uint64 nextStart, char16 nextLastChar)
+    {
+        if (lines)
+            lines->emplace_back(start, charCount, (uint32) (end - start));
+        count++;
+        start     = nextStart;
+        charCount = 0;
+        lastChar  = nextLastChar;
+        // the state of the scanner is enough to decode the lines that follow
+        if ((checkpoints) && ((count % LineIndexer::CHECKPOINT_INTERVAL) == 0))
+            checkpoints->push_back({ count, start, lastChar });
+    }
+
+  public:
+    uint64 offset;
+
+    LineScanner(uint64 startOffset, char16 startLastChar, std::vector<LineInfo>* output, std::vector<LineIndexer::Checkpoint>* outputCheckpoints)
+        : lines(output), checkpoints(outputCheckpoints), count(0), start(startOffset), charCount(0), lastChar(startLastChar), offset(startOffset)
+    {
+    }
+    inline uint64 GetLinesCount() const
+    {
+        return count;
+    }
+    // 'count' decoded ASCII characters (other than CR or LF)
+    inline void AddPlainCharacters(uint64 charsCount)
+    {
+        if (charsCount == 0)
+            return;
+        lastChar = 0;
+        while (charsCount > 0)
+        {
+            const auto sz = std::min<>(charsCount, static_cast<uint64>(MAX_LINE_CHARACTERS + 1 - charCount));
+            charCount += static_cast<uint32>(sz);
+            offset += sz;
+            charsCount -= sz;
+            if (charCount > MAX_LINE_CHARACTERS)
+                EndLine(offset, offset, lastChar);
+        }
+    }
+    inline void AddCharacter(char16 chr, uint32 length)
+    {
+        if (((chr == '\n') && (lastChar != '\r')) || ((chr == '\r') && (lastChar != '\n')))
+        {
+            // end of the current line
+            EndLine(offset, offset + length, chr);
+            offset += length;
+            return;
+        }
+        if (((chr == '\n') && (lastChar == '\r')) || ((chr == '\r') && (lastChar == '\n')))
+        {
+            // combined CRLF or LFCR
+            offset += length;
+            start     = offset;
+            charCount = 0;
+            lastChar  = 0;
+            return;
+        }
+        lastChar = 0;
+        charCount++;
+        offset += length;
+        if (charCount > MAX_LINE_CHARACTERS)
+            EndLine(offset, offset, lastChar);
+    }
+    inline void AddInvalidCharacter()
+    {
+        charCount++;
+        offset++;
+        if (charCount > MAX_LINE_CHARACTERS)
+            EndLine(offset, offset, lastChar);
+    }
+    inline void Close()
+    {
+        if (charCount > 0)
+            EndLine(offset, offset, lastChar);
+    }
+};
+} // namespace GView::View::TextViewer
+
+LineIndexer::~LineIndexer()
+{
+    Cancel();
+}
+void LineIndexer::Start(GView::Utils::DataCache& dataCache, CharacterEncoding::Encoding textEncoding, uint64 startOffset)
+{
+    Cancel();
+    this->cache    = &dataCache;
+    this->encoding = textEncoding;
+    this->stop     = false;
+    this->nextTask = 0;
+
+    const auto size = dataCache.GetSize();
+    startOffset     = std::min<>(startOffset, size);
+    this->sparse    = (size - startOffset) > SPARSE_INDEX_SIZE;
+    auto count      = static_cast<size_t>(1);
+    if (IsParallelEncoding(textEncoding))
+        count = std::max<size_t>(static_cast<size_t>((size - startOffset + INDEX_TASK_SIZE - 1) / INDEX_TASK_SIZE), 1);
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->tasks.clear();
+        this->tasks.resize(count);
+        for (auto idx = 0U; idx < count; idx++)
+        {
+            auto& t        = this->tasks[idx];
+            t.nominalStart = startOffset + idx * INDEX_TASK_SIZE;
+            t.nominalEnd   = idx + 1 == count ? size : std::min<>(t.nominalStart + INDEX_TASK_SIZE, size);
+            t.linesCount   = 0;
+            t.done         = false;
+        }
+    }
+    this->lines.clear();
+    this->checkpoints.clear();
+    this->linesCount           = 0;
+    this->publishedTask        = 0;
+    this->publishedTaskLines   = 0;
+    this->publishedCheckpoints = 0;
+    this->publishedTasksLines  = 0;
+    for (auto& w : this->windows)
+    {
+        w.lines.clear();
+        w.lastAccess = 0;
+    }
+
+    const auto workersCount = std::min<size_t>(count, std::max<>(std::thread::hardware_concurrency(), 1U));
+    for (auto idx = 0U; idx < workersCount; idx++)
+        this->workers.emplace_back([this]() { Run(); });
+}
+void LineIndexer::Cancel()
+{
+    this->stop = true;
+    for (auto& w : this->workers)
+    {
+        if (w.joinable())
+            w.join();
+    }
+    this->workers.clear();
+}
+void LineIndexer::Run()
+{
+    // tasks are taken in order => the first tasks (the ones the UI thread is waiting for) are indexed first
+    while (this->stop == false)
+    {
+        const auto idx = this->nextTask.fetch_add(1);
+        if (idx >= this->tasks.size())
+            return;
+        Index(idx);
+    }
+}
+void LineIndexer::Flush(Task& task, std::vector<LineInfo>& newLines, std::vector<Checkpoint>& newCheckpoints, uint64 count, bool done)
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        task.lines.insert(task.lines.end(), newLines.begin(), newLines.end());
+        task.checkpoints.insert(task.checkpoints.end(), newCheckpoints.begin(), newCheckpoints.end());
+        task.linesCount = count;
+        task.done       = done;
+    }
+    newLines.clear();
+    newCheckpoints.clear();
+    this->progress.notify_all();
+}
+uint64 LineIndexer::FindTaskStart(const Task& task) const
+{
+    // first position from the task range that follows a line break and is an ASCII character
+    auto offset = task.nominalStart - 1;
+    while (offset + 1 < task.nominalEnd)
+    {
+        GView::Utils::DataCache::SequentialReader reader(
+              *this->cache, offset, std::min<>(task.nominalEnd - offset, (uint64) INDEX_BLOCK_SIZE), INDEX_BLOCK_SIZE);
+        const auto buf = reader.Next();
+        CHECK(buf.GetLength() >= 2, GView::Utils::INVALID_OFFSET, "");
+        const auto* p = buf.begin();
+        const auto* e = buf.end() - 1;
+        while ((p = FindSpecialByte<false>(p, e)) < e)
+        {
+            if (p[1] < 0x80 && !IsNewLineByte(p[1]))
+                return offset + static_cast<uint64>(p + 1 - buf.begin());
+            p++;
+        }
+        offset += buf.GetLength() - 1;
+    }
+    return GView::Utils::INVALID_OFFSET;
+}
+LineIndexer::ScanResult LineIndexer::ScanBlock(LineScanner& scanner, BufferView buffer, uint64 splitOffset, uint64 maxLines) const
+{
+    // 'buffer' starts at scanner.offset. The scan stops after 'maxLines' lines or at the first position after
+    // 'splitOffset' where the file can be split (where the next task starts)
+    const auto fast     = IsParallelEncoding(this->encoding);
+    const auto* p       = buffer.begin();
+    const auto* e       = buffer.end();
+    const auto* loopEnd = e;
+    if ((scanner.offset + buffer.GetLength() < this->cache->GetSize()) && (buffer.GetLength() > 16))
+        loopEnd -= INDEX_LOOKAHEAD; // make sure that any character from this block can be decoded
+
+    CharacterEncoding::ExpandedCharacter ch;
+    while ((p < loopEnd) && (scanner.GetLinesCount() < maxLines))
+    {
+        if (fast)
+        {
+            const auto* next = FindSpecialByte<true>(p, loopEnd);
+            scanner.AddPlainCharacters(static_cast<uint64>(next - p));
+            p = next;
+            if (p >= loopEnd)
+                break;
+            if (IsNewLineByte(*p))
+            {
+                scanner.AddCharacter(*p, 1);
+                p++;
+                if ((scanner.offset >= splitOffset) && (p < e) && (*p < 0x80) && (!IsNewLineByte(*p)))
+                    return ScanResult::Stopped;
+                continue;
+            }
+        }
+        if (ch.FromEncoding(this->encoding, p, e))
+        {
+            scanner.AddCharacter(ch.GetChar(), ch.Length());
+            p += ch.Length();
+        }
+        else
+        {
+            scanner.AddInvalidCharacter();
+            p++;
+        }
+    }
+    return scanner.GetLinesCount() < maxLines ? ScanResult::Continue : ScanResult::Stopped;
+}
+void LineIndexer::Index(uint32 taskIndex)
+{
+    auto& task      = this->tasks[taskIndex];
+    const auto size = this->cache->GetSize();
+    const auto from = taskIndex == 0 ? task.nominalStart : FindTaskStart(task);
+    std::vector<LineInfo> newLines;
+    std::vector<Checkpoint> newCheckpoints;
+
+    if (from == GView::Utils::INVALID_OFFSET)
+    {
+        // no place to split the file in this range (it is indexed by a previous task)
+        Flush(task, newLines, newCheckpoints, 0, true);
+        return;
+    }
+
+    // the next task starts at the first split position after this range
+    const auto splitOffset = taskIndex + 1 == this->tasks.size() ? GView::Utils::INVALID_OFFSET : task.nominalEnd;
+    LineScanner scanner(from, 0, this->sparse ? nullptr : &newLines, this->sparse ? &newCheckpoints : nullptr);
+    if (this->sparse)
+        newCheckpoints.push_back({ 0, from, 0 });
+    else
+        newLines.reserve(INDEX_FLUSH_LINES);
+
+    while (true)
+    {
+        CHECKBK(this->stop == false, "");
+        if (scanner.offset >= size)
+        {
+            scanner.Close(); // last line from the file
+            break;
+        }
+        GView::Utils::DataCache::SequentialReader reader(*this->cache, scanner.offset, INDEX_BLOCK_SIZE, INDEX_BLOCK_SIZE);
+        const auto buf = reader.Next();
+        CHECKBK(buf.Empty() == false, "Fail to read offset: 0x%llX", scanner.offset);
+        if (ScanBlock(scanner, buf, splitOffset, UINT64_MAX) == ScanResult::Stopped)
+            break;
+        // the sparse index is small => it is published after every block
+        if ((this->sparse) || (newLines.size() >= INDEX_FLUSH_LINES))
+            Flush(task, newLines, newCheckpoints, scanner.GetLinesCount(), false);
+    }
+    Flush(task, newLines, newCheckpoints, scanner.GetLinesCount(), true);
+}
+bool LineIndexer::PublishLocked()
+{
+    const auto previousCount = this->linesCount;
+    while (this->publishedTask < this->tasks.size())
+    {
+        auto& t = this->tasks[this->publishedTask];
+        if (this->publishedTaskLines < t.lines.size())
+        {
+            this->lines.insert(this->lines.end(), t.lines.begin() + this->publishedTaskLines, t.lines.end());
+            this->publishedTaskLines = t.lines.size();
+        }
+        for (; this->publishedCheckpoints < t.checkpoints.size(); this->publishedCheckpoints++)
+        {
+            auto c = t.checkpoints[this->publishedCheckpoints];
+            c.lineNo += this->publishedTasksLines;
+            this->checkpoints.push_back(c);
+        }
+        this->linesCount = this->publishedTasksLines + t.linesCount;
+        if (!t.done)
+            break;
+        this->publishedTasksLines += t.linesCount;
+        std::vector<LineInfo>().swap(t.lines);
+        std::vector<Checkpoint>().swap(t.checkpoints);
+        this->publishedTask++;
+        this->publishedTaskLines   = 0;
+        this->publishedCheckpoints = 0;
+    }
+    return this->linesCount != previousCount;
+}
+bool LineIndexer::Update()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return PublishLocked();
+}
+template <typename Condition>
+void LineIndexer::WaitUntil(Condition condition)
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (true)
+    {
+        PublishLocked();
+        if ((condition()) || (this->publishedTask >= this->tasks.size()))
+            return;
+        if (this->workers.empty())
+            return; // canceled
+        this->progress.wait(guard);
+    }
+}
+void LineIndexer::Wait(uint32 minimumLines)
+{
+    WaitUntil([this, minimumLines]() { return this->linesCount >= minimumLines; });
+}
+void LineIndexer::WaitForOffset(uint64 offset)
+{
+    // the lines before a published line (or before a checkpoint, for the sparse index) are complete
+    WaitUntil(
+          [this, offset]()
+          {
+              if (this->sparse)
+                  return (!this->checkpoints.empty()) && (this->checkpoints.back().offset > offset);
+              return (!this->lines.empty()) && (this->lines.back().offset > offset);
+          });
+}
+bool LineIndexer::IsComplete() const
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->publishedTask >= this->tasks.size();
+}
+const LineIndexer::Window* LineIndexer::GetWindow(size_t checkpointIndex)
+{
+    // the lines from a checkpoint up to the next one (or up to the last published line)
+    const auto& c         = this->checkpoints[checkpointIndex];
+    const auto lastLine   = checkpointIndex + 1 < this->checkpoints.size() ? this->checkpoints[checkpointIndex + 1].lineNo : this->linesCount;
+    const auto count      = lastLine - c.lineNo;
+    Window* result        = nullptr;
+    for (auto& w : this->windows)
+    {
+        if ((w.lastAccess > 0) && (w.firstLine == c.lineNo) && (w.lines.size() >= count))
+        {
+            w.lastAccess = ++this->windowsAccess;
+            return &w;
+        }
+        if ((result == nullptr) || (w.lastAccess < result->lastAccess))
+            result = &w; // least recently used
+    }
+
+    const auto size = this->cache->GetSize();
+    result->lines.clear();
+    result->lines.reserve(static_cast<size_t>(count));
+    LineScanner scanner(c.offset, c.lastChar, &result->lines, nullptr);
+    while (true)
+    {
+        if (scanner.offset >= size)
+        {
+            scanner.Close();
+            break;
+        }
+        GView::Utils::DataCache::SequentialReader reader(*this->cache, scanner.offset, WINDOW_BLOCK_SIZE, WINDOW_BLOCK_SIZE);
+        const auto buf = reader.Next();
+        CHECK(buf.Empty() == false, nullptr, "Fail to read offset: 0x%llX", scanner.offset);
+        if (ScanBlock(scanner, buf, GView::Utils::INVALID_OFFSET, count) == ScanResult::Stopped)
+            break;
+    }
+    CHECK(result->lines.size() >= count, nullptr, "Expecting %llu lines from offset 0x%llX", count, c.offset);
+    result->lines.resize(static_cast<size_t>(count));
+    result->firstLine  = c.lineNo;
+    result->lastAccess = ++this->windowsAccess;
+    return result;
+}
+bool LineIndexer::GetLine(uint32 lineNo, LineInfo& li)
+{
+    if (lineNo >= this->linesCount)
+        return false;
+    if (!this->sparse)
+    {
+        li = this->lines[lineNo];
+        return true;
+    }
+    const auto it = std::upper_bound(
+          this->checkpoints.begin(), this->checkpoints.end(), (uint64) lineNo, [](uint64 value, const Checkpoint& c) { return value < c.lineNo; });
+    CHECK(it != this->checkpoints.begin(), false, "");
+    const auto w = GetWindow(static_cast<size_t>(it - this->checkpoints.begin()) - 1);
+    CHECK(w, false, "");
+    li = w->lines[lineNo - w->firstLine];
+    return true;
+}
+uint32 LineIndexer::OffsetToLine(uint64 offset)
+{
+    const auto FindInLines = [offset](const std::vector<LineInfo>& list)
+    {
+        return static_cast<uint64>(
+              std::upper_bound(list.begin(), list.end(), offset, [](uint64 value, const LineInfo& line) { return value < line.offset; }) - list.begin());
+    };
+    uint64 lineNo = 0;
+    if (!this->sparse)
+    {
+        lineNo = FindInLines(this->lines);
+    }
+    else
+    {
+        // the checkpoint before the offset => the line is in its window (or it is the last line before the window)
+        const auto it = std::upper_bound(
+              this->checkpoints.begin(), this->checkpoints.end(), offset, [](uint64 value, const Checkpoint& c) { return value < c.offset; });
+        if (it != this->checkpoints.begin())
+        {
+            const auto w = GetWindow(static_cast<size_t>(it - this->checkpoints.begin()) - 1);
+            if (w)
+                lineNo = w->firstLine + FindInLines(w->lines);
+        }
+    }
+    if (lineNo > 0)
+        lineNo--;
+    return static_cast<uint32>(std::min<uint64>(lineNo, GetLinesCount()));
+}
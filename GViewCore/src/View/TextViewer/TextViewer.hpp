@@ -2,6 +2,10 @@
 
 #include "Internal.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
 namespace GView
 {
 namespace View
@@ -59,6 +63,104 @@ namespace View
             {
             }
         };
+        class LineScanner;
+
+        // Builds the line index in background. The file is split in tasks that are indexed in parallel (for ASCII and
+        // UTF-8 files) and the lines are published in order, as soon as they are available.
+        // Large files use a sparse index: only the state of the scanner at every CHECKPOINT_INTERVAL lines is kept and
+        // the lines around the requested one are decoded again (a few windows are kept in cache).
+        class LineIndexer
+        {
+          public:
+            static constexpr uint32 CHECKPOINT_INTERVAL = 1024;
+
+            struct Checkpoint
+            {
+                uint64 lineNo;
+                uint64 offset;   // where the scanner resumes (the start of the line or the second char of a CR/LF pair)
+                char16 lastChar; // last line break character (needed to combine CR/LF pairs)
+            };
+
+          private:
+            struct Task
+            {
+                uint64 nominalStart, nominalEnd;
+                std::vector<LineInfo> lines;         // full index
+                std::vector<Checkpoint> checkpoints; // sparse index (line numbers relative to the task)
+                uint64 linesCount;
+                bool done;
+            };
+            struct Window
+            {
+                uint64 firstLine;
+                uint64 lastAccess;
+                std::vector<LineInfo> lines;
+            };
+            enum class ScanResult : uint8
+            {
+                Continue,
+                Stopped
+            };
+
+            GView::Utils::DataCache* cache{ nullptr };
+            CharacterEncoding::Encoding encoding{ CharacterEncoding::Encoding::Binary };
+            bool sparse{ false };
+            std::vector<Task> tasks;
+            std::vector<std::thread> workers;
+            std::atomic<uint32> nextTask{ 0 };
+            std::atomic<bool> stop{ false };
+            mutable std::mutex lock;
+            std::condition_variable progress;
+
+            // published index (used only by the UI thread)
+            std::vector<LineInfo> lines;
+            std::vector<Checkpoint> checkpoints;
+            uint64 linesCount{ 0 };
+            uint32 publishedTask{ 0 };        // first task that was not entirely published
+            size_t publishedTaskLines{ 0 };   // lines (full index) already published from that task
+            size_t publishedCheckpoints{ 0 }; // checkpoints (sparse index) already published from that task
+            uint64 publishedTasksLines{ 0 };  // lines from the tasks that were entirely published
+            Window windows[4];
+            uint64 windowsAccess{ 0 };
+
+            void Run();
+            void Index(uint32 taskIndex);
+            uint64 FindTaskStart(const Task& task) const;
+            ScanResult ScanBlock(LineScanner& scanner, BufferView buffer, uint64 splitOffset, uint64 maxLines) const;
+            void Flush(Task& task, std::vector<LineInfo>& newLines, std::vector<Checkpoint>& newCheckpoints, uint64 count, bool done);
+            bool PublishLocked();
+            template <typename Condition>
+            void WaitUntil(Condition condition);
+            const Window* GetWindow(size_t checkpointIndex);
+
+          public:
+            LineIndexer() = default;
+            LineIndexer(const LineIndexer&)            = delete;
+            LineIndexer& operator=(const LineIndexer&) = delete;
+            ~LineIndexer();
+
+            void Start(GView::Utils::DataCache& cache, CharacterEncoding::Encoding encoding, uint64 startOffset);
+            void Cancel();
+            // publishes the lines indexed since the last call, returns true if new lines were added
+            bool Update();
+            // waits until at least 'minimumLines' lines are published or the index is complete
+            void Wait(uint32 minimumLines = 0xFFFFFFFF);
+            // waits until the line that contains 'offset' is published (a line that starts after it is published) or the index is complete
+            void WaitForOffset(uint64 offset);
+            bool IsComplete() const;
+
+            inline uint32 GetLinesCount() const
+            {
+                return static_cast<uint32>(std::min<uint64>(linesCount, 0xFFFFFFFEULL));
+            }
+            inline bool IsSparse() const
+            {
+                return sparse;
+            }
+            bool GetLine(uint32 lineNo, LineInfo& li);
+            // last line that starts before (or at) 'offset'
+            uint32 OffsetToLine(uint64 offset);
+        };
         class Instance : public View::ViewControl
         {
             enum class Direction
@@ -72,7 +174,9 @@ namespace View
                 Text,
                 Border
             };
-            std::vector<LineInfo> lines;      
+            LineIndexer lineIndexer;
+            uint64 estimatedLinesCount;
+            bool lineIndexComplete;
             Utils::Selection selection;
             Pointer<SettingsData> settings;
             Reference<GView::Object> obj;
@@ -125,6 +229,8 @@ namespace View
             void OpenCurrentSelection();
 
             void RecomputeLineIndexes();
+            void UpdateLineIndexes(uint32 minimumLines = 0, uint64 minimumOffset = 0);
+            void UpdateLineNumberWidth();
             void CommputeViewPort_NoWrap(uint32 lineNo, Direction dir);
             void CommputeViewPort_Wrap(uint32 lineNo, uint32 subLineNo, Direction dir);
             void ComputeViewPort(uint32 lineNo, uint32 subLineNo, Direction dir);
@@ -174,6 +280,7 @@ namespace View
             virtual void OnStart() override;
             virtual void OnAfterResize(int newWidth, int newHeight) override;
             virtual void OnUpdateScrollBars() override;
+            virtual bool OnFrameUpdate() override;
 
             virtual bool GoTo(uint64 offset) override;
             virtual bool Select(uint64 offset, uint64 size) override;
@@ -41,6 +41,19 @@ void ViewControl::WriteCusorInfoLine(AppCUI::Graphics::Renderer& renderer, int x
     }
 }
 
+void BufferColorInterface::GetColorsForBuffer(uint64 offset, BufferView buf, const ViewData& vd, std::vector<BufferViewer::BufferColor>& runs)
+{
+    runs.clear();
+    auto data = vd;
+    ColorPair cp;
+    for (auto idx = 0U; idx < buf.GetLength(); idx++) {
+        data.byte = buf[idx];
+        if (GetColorForByteAt(offset + idx, data, cp)) {
+            runs.push_back({ offset + idx, offset + idx, cp });
+        }
+    }
+}
+
 bool ViewControl::SetBufferColorProcessorCallback(Reference<BufferColorInterface>)
 {
     return false;
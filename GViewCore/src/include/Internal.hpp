@@ -2,6 +2,7 @@
 
 #include "GView.hpp"
 
+#include <mutex>
 #include <set>
 #include <span>
 
@@ -246,6 +247,7 @@ namespace Utils
         };
         Encoding AnalyzeBufferForEncoding(BufferView buf, bool checkForBOM, uint32& BOMLength);
         UnicodeString ConvertToUnicode16(BufferView buf);
+        UnicodeString ConvertToUnicode16(BufferView buf, Encoding encoding, uint32 BOMLength); // encoding already known
         BufferView GetBOMForEncoding(Encoding encoding);
     }; // namespace CharacterEncoding
 } // namespace Utils
@@ -289,8 +291,12 @@ namespace Type
 
     namespace Matcher
     {
+        // text view of the identification buffer; the encoding analysis and the UTF-16 conversion
+        // are only performed the first time a text based matcher asks for them
         class TextParser
         {
+            AppCUI::Utils::BufferView buf;
+            GView::Utils::UnicodeString converted;
             struct
             {
                 const char16* text;
@@ -300,6 +306,7 @@ namespace Type
             {
                 const char16* text;
                 uint32 size;
+                bool computed;
             } Text;
             struct
             {
@@ -307,12 +314,26 @@ namespace Type
                 uint32 count;
                 bool computed;
             } Lines;
+            struct
+            {
+                uint32 bomLength;
+                GView::Utils::CharacterEncoding::Encoding value;
+                bool computed;
+            } Detected;
+            void ComputeEncoding();
+            void ComputeText();
             void ComputeLineOffsets();
 
           public:
-            TextParser(const char16* text, uint32 size);
-            inline std::u16string_view GetText() const
+            TextParser(AppCUI::Utils::BufferView buf);
+            TextParser(const TextParser&)            = delete;
+            TextParser& operator=(const TextParser&) = delete;
+            ~TextParser();
+
+            inline std::u16string_view GetText()
             {
+                if (!Text.computed)
+                    ComputeText();
                 return { Text.text, static_cast<size_t>(Text.size) };
             }
             inline std::span<uint32> GetLines()
@@ -321,11 +342,28 @@ namespace Type
                     ComputeLineOffsets();
                 return std::span<uint32>(this->Lines.offsets, static_cast<size_t>(this->Lines.count));
             }
+            inline GView::Utils::CharacterEncoding::Encoding GetEncoding(uint32& bomLength)
+            {
+                if (!Detected.computed)
+                    ComputeEncoding();
+                bomLength = Detected.bomLength;
+                return Detected.value;
+            }
+            inline bool IsEncodingComputed() const
+            {
+                return Detected.computed;
+            }
         };
         struct Interface
         {
             virtual bool Init(std::string_view text)                            = 0;
             virtual bool Match(AppCUI::Utils::BufferView buf, TextParser& text) = 0;
+
+            // first raw byte a buffer must start with to match (-1 if the matcher works over the text form)
+            virtual int32 GetLeadingByte() const
+            {
+                return -1;
+            }
         };
         class MagicMatcher : public Interface
         {
@@ -344,6 +382,10 @@ namespace Type
             }
             virtual bool Init(std::string_view text) override;
             virtual bool Match(AppCUI::Utils::BufferView buf, TextParser& text) override;
+            virtual int32 GetLeadingByte() const override
+            {
+                return count > 0 ? u8[0] : -1;
+            }
         };
         class StartsWithMatcher : public Interface
         {
@@ -386,6 +428,7 @@ namespace Type
         bool (*fnValidate)(const AppCUI::Utils::BufferView& buf, const std::string_view& extension);
         TypeInterface* (*fnCreateInstance)();
         bool (*fnPopulateWindow)(Reference<GView::View::WindowInterface> win);
+        bool (*fnUpdate)(Reference<GView::Object> object); // optional export
 
         bool LoadPlugin();
 
@@ -393,11 +436,19 @@ namespace Type
         Plugin();
         bool Init(AppCUI::Utils::IniSection section);
         void Init();
+        bool Load();
         bool MatchExtension(uint64 extensionHash);
         bool MatchContent(AppCUI::Utils::BufferView buf, Matcher::TextParser& textParser);
         bool IsOfType(AppCUI::Utils::BufferView buf, GView::Type::Matcher::TextParser& textParser, const std::string_view& extension = "");
+        void GetIndexKeys(std::vector<uint64>& extensionHashes, std::vector<int32>& leadingBytes) const;
         bool PopulateWindow(Reference<GView::View::WindowInterface> win) const;
         TypeInterface* CreateInstance() const;
+        // parses an object (created with CreateInstance) without a window, only if the plugin exports 'Update'
+        bool Update(Reference<GView::Object> object) const;
+        inline bool HasUpdate() const
+        {
+            return fnUpdate != nullptr;
+        }
         inline bool operator<(const Plugin& plugin) const
         {
             return priority > plugin.priority;
@@ -418,6 +469,20 @@ namespace Type
         static uint64 ExtensionToHash(std::string_view ext);
         static uint64 ExtensionToHash(std::u16string_view ext);
     };
+
+    // Precomputed lookup tables that narrow the list of type plugins worth checking for a buffer.
+    // All candidate lists hold indexes in the (priority sorted) plugins vector, in ascending order.
+    class PluginsIndex
+    {
+        std::unordered_map<uint64, std::vector<uint32>> byExtension;
+        std::vector<uint32> byLeadingByte[256];
+        std::vector<uint32> textMatchers; // plugins with at least one pattern that can not be keyed on the first byte
+
+      public:
+        void Build(const std::vector<Plugin>& plugins);
+        std::span<const uint32> GetExtensionCandidates(uint64 extensionHash) const;
+        void GetContentCandidates(AppCUI::Utils::BufferView buf, std::vector<uint32>& candidates) const;
+    };
 } // namespace Type
 
 namespace App
@@ -475,14 +540,17 @@ namespace App
         AppCUI::Controls::Menu* mnuHelp;
         AppCUI::Controls::Menu* mnuFile;
         std::vector<GView::Type::Plugin> typePlugins;
+        GView::Type::PluginsIndex typePluginsIndex;
         std::vector<GView::Generic::Plugin> genericPlugins;
         GView::Type::Plugin defaultPlugin;
         GView::Utils::ErrorList errList;
         uint32 defaultCacheSize;
+        bool useMemoryMappedFiles;
         std::filesystem::path lastOpenedFolderLocation;
+        std::mutex typePluginsLock; // AnalyzeFile runs on several threads, but the type plugins are not required to be thread-safe
 
         bool BuildMainMenus();
-        bool LoadSettings();
+        bool LoadSettings(AppCUI::Utils::IniObject* ini);
         void OpenFile();
         void OpenFolder();
         void ShowErrors();
@@ -523,6 +591,7 @@ namespace App
               const AppCUI::Utils::ConstString& name,
               const AppCUI::Utils::ConstString& path,
               GView::Utils::DataCache& cache,
+              GView::Type::Matcher::TextParser& textParser,
               uint64 extensionHash,
               OpenMethod method,
               std::string_view typeName,
@@ -542,6 +611,8 @@ namespace App
         Instance();
         virtual ~Instance() {}
         bool Init();
+        bool InitHeadless();
+        bool AnalyzeFile(const std::filesystem::path& path, std::string& output);
         bool AddFileWindow(const std::filesystem::path& path, OpenMethod method, string_view typeName, Reference<Window> parent = nullptr);
         bool AddBufferWindow(BufferView buf, const ConstString& name, const ConstString& path, OpenMethod method, string_view typeName, Reference<Window> parent);
         void UpdateCommandBar(AppCUI::Application::CommandBar& commandBar);
@@ -487,42 +487,19 @@ bool Instance::DropBinaryData(
         }
     } _{ .o = droppedFile };
 
-    auto& cache          = this->object->GetData();
-    const auto cacheSize = cache.GetCacheSize();
+    auto& cache = this->object->GetData();
 
     for (const auto& area : areas) {
-        const auto size = area.second - area.first;
-        if (size < cacheSize) {
-            auto bf = cache.Get(area.first, static_cast<int32>(size), true);
-            CHECK(bf.IsValid(), false, "");
-
-            for (int32 i = 0; i < bf.GetLength(); i++) {
+        auto chunks = cache.Chunks(area.first, area.second - area.first);
+        for (auto bf : chunks) {
+            for (uint32 i = 0; i < bf.GetLength(); i++) {
                 const auto c = bf[i];
                 if (context.binaryCharSetMatrix[c]) {
                     droppedFile << c;
                 }
             }
-        } else {
-            auto sizeLeft = size - cacheSize;
-            auto offset   = area.first;
-            auto bf       = cache.Get(offset, cacheSize, true);
-            offset += cacheSize;
-
-            while (bf.IsValid() && !bf.Empty()) {
-                for (int32 i = 0; i < bf.GetLength(); i++) {
-                    const auto c = bf[i];
-                    if (context.binaryCharSetMatrix[c]) {
-                        droppedFile << c;
-                    }
-                }
-
-                const auto sizeToRead = std::min<int64>(sizeLeft, cacheSize);
-                sizeLeft -= sizeToRead;
-
-                bf = cache.Get(offset, static_cast<int32>(sizeToRead), true);
-                offset += sizeToRead;
-            }
         }
+        CHECK(chunks.HasFailed() == false, false, "");
     }
 
     CHECK(droppedFile.good(), false, "");
@@ -150,19 +150,13 @@ bool Plugin::DrawEntropy(EntropyType type)
     canvas->Resize(maxX, maxY, 'X', color);
     canvas->ClearEntireSurface('X', color);
 
+    // the entire profile is computed in a single pass (the blocks past the end of the profile are empty)
+    const auto alpha = type == EntropyType::Renyi ? this->renyiAlpha : 1.0;
+    std::vector<double> profile;
+    CHECK(GView::Entropy::ComputeProfile(cache, 0, size, this->blockSize, alpha, profile), false, "");
+
     for (uint32 i = 0; i < blocksCount; i++) {
-        auto bf    = cache.Get(i * static_cast<uint64>(this->blockSize), this->blockSize, false);
-        auto value = 0.0;
-        switch (type) {
-        case EntropyType::Shannon:
-        case EntropyType::ShannonDataType:
-            value = GView::Entropy::ShannonEntropy(bf);
-            break;
-        case EntropyType::Renyi:
-            value = GView::Entropy::RenyiEntropy(bf, this->renyiAlpha);
-        default:
-            break;
-        }
+        const auto value = i < profile.size() ? profile[i] : 0.0;
 
         auto fColor = Color::Black;
         switch (type) {
@@ -4,7 +4,10 @@
 
 #include <any>
 #include <array>
+#include <condition_variable>
+#include <functional>
 #include <map>
+#include <thread>
 
 namespace GView::GenericPlugins::Hashes
 {
@@ -591,6 +591,97 @@ void HashesDialog::SetSettingsFromFlags()
     allSettings->Save(Application::GetAppSettingsFile());
 }
 
+// Runs the update functions of the selected hashes on worker threads. Every chunk is shared (read only) by all
+// the workers and the reader waits until all of them are done before moving to the next one, so the time needed
+// is given by the slowest hash (not by the sum of all of them).
+class HashWorkers
+{
+  public:
+    using Updater = std::function<bool(BufferView)>;
+
+  private:
+    std::vector<Updater>& updaters;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable chunkReady;
+    std::condition_variable chunkDone;
+    BufferView chunk;
+    uint64 chunkID{ 0 };
+    uint32 workersCount{ 0 };
+    uint32 pending{ 0 };
+    bool stop{ false };
+    bool failed{ false };
+
+    void Run(uint32 index)
+    {
+        auto lastID = 0ULL;
+        while (true)
+        {
+            BufferView buffer;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                chunkReady.wait(guard, [&]() { return stop || chunkID != lastID; });
+                if (stop)
+                    return;
+                lastID = chunkID;
+                buffer = chunk;
+            }
+
+            auto ok = true;
+            for (auto idx = index; idx < static_cast<uint32>(updaters.size()); idx += workersCount)
+                ok &= updaters[idx](buffer);
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                failed |= !ok;
+                if (--pending == 0)
+                    chunkDone.notify_one();
+            }
+        }
+    }
+
+  public:
+    HashWorkers(std::vector<Updater>& hashUpdaters) : updaters(hashUpdaters)
+    {
+        // one hash per worker (as long as there are enough cores); a single hash is computed on the caller thread
+        workersCount = std::min<>(static_cast<uint32>(updaters.size()), std::max<>(std::thread::hardware_concurrency(), 1U));
+        if (workersCount < 2)
+            return;
+        threads.reserve(workersCount);
+        for (auto idx = 0U; idx < workersCount; idx++)
+            threads.emplace_back([this, idx]() { Run(idx); });
+    }
+    ~HashWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        chunkReady.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    bool Process(BufferView buffer)
+    {
+        if (threads.empty())
+        {
+            for (auto& update : updaters)
+                CHECK(update(buffer), false, "");
+            return true;
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        chunk   = buffer;
+        pending = static_cast<uint32>(threads.size());
+        chunkID++;
+        chunkReady.notify_all();
+        chunkDone.wait(guard, [this]() { return pending == 0; });
+        CHECK(failed == false, false, "");
+        return true;
+    }
+};
+
 static bool ComputeHash(
       std::map<std::string, std::string>& outputs,
       uint32 hashFlags,
@@ -638,131 +729,93 @@ static bool ComputeHash(
     OpenSSLHash shake128(OpenSSLHashKind::Shake128);
     OpenSSLHash shake256(OpenSSLHashKind::Shake256);
 
+    // every selected hash is initialized and gets an update function (they are executed by HashWorkers)
+    std::vector<HashWorkers::Updater> updaters;
+    const auto OpenSSLUpdater = [](OpenSSLHash& hash) -> HashWorkers::Updater
+    { return [&hash](BufferView buffer) { return hash.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())); }; };
+
     for (const auto& hash : hashList)
     {
         switch (static_cast<Hashes>(hashFlags & static_cast<uint32>(hash)))
         {
         case Hashes::Adler32:
             CHECK(adler32.Init(), false, "");
+            updaters.emplace_back([&adler32](BufferView buffer) { return adler32.Update(buffer); });
             break;
         case Hashes::CRC16:
             CHECK(crc16.Init(), false, "");
+            updaters.emplace_back([&crc16](BufferView buffer) { return crc16.Update(buffer); });
             break;
         case Hashes::CRC32_JAMCRC_0:
             CHECK(crc32JAMCRC0.Init(CRC32Type::JAMCRC_0), false, "");
+            updaters.emplace_back([&crc32JAMCRC0](BufferView buffer) { return crc32JAMCRC0.Update(buffer); });
             break;
         case Hashes::CRC32_JAMCRC:
             CHECK(crc32JAMCRC.Init(CRC32Type::JAMCRC), false, "");
+            updaters.emplace_back([&crc32JAMCRC](BufferView buffer) { return crc32JAMCRC.Update(buffer); });
             break;
         case Hashes::CRC64_ECMA_182:
             CHECK(crc64ECMA182.Init(CRC64Type::ECMA_182), false, "");
+            updaters.emplace_back([&crc64ECMA182](BufferView buffer) { return crc64ECMA182.Update(buffer); });
             break;
         case Hashes::CRC64_WE:
             CHECK(crc64WE.Init(CRC64Type::WE), false, "");
+            updaters.emplace_back([&crc64WE](BufferView buffer) { return crc64WE.Update(buffer); });
             break;
         case Hashes::MD5:
+            updaters.emplace_back(OpenSSLUpdater(md5));
+            break;
         case Hashes::BLAKE2S256:
+            updaters.emplace_back(OpenSSLUpdater(blake2s256));
+            break;
         case Hashes::BLAKE2B512:
+            updaters.emplace_back(OpenSSLUpdater(blake2b512));
+            break;
         case Hashes::SHA1:
+            updaters.emplace_back(OpenSSLUpdater(sha1));
+            break;
         case Hashes::SHA224:
+            updaters.emplace_back(OpenSSLUpdater(sha224));
+            break;
         case Hashes::SHA256:
+            updaters.emplace_back(OpenSSLUpdater(sha256));
+            break;
         case Hashes::SHA384:
+            updaters.emplace_back(OpenSSLUpdater(sha384));
+            break;
         case Hashes::SHA512:
+            updaters.emplace_back(OpenSSLUpdater(sha512));
+            break;
         case Hashes::SHA512_224:
+            updaters.emplace_back(OpenSSLUpdater(sha512_224));
+            break;
         case Hashes::SHA512_256:
+            updaters.emplace_back(OpenSSLUpdater(sha512_256));
+            break;
         case Hashes::SHA3_224:
+            updaters.emplace_back(OpenSSLUpdater(sha3_224));
+            break;
         case Hashes::SHA3_256:
+            updaters.emplace_back(OpenSSLUpdater(sha3_256));
+            break;
         case Hashes::SHA3_384:
+            updaters.emplace_back(OpenSSLUpdater(sha3_384));
+            break;
         case Hashes::SHA3_512:
+            updaters.emplace_back(OpenSSLUpdater(sha3_512));
+            break;
         case Hashes::SHAKE128:
+            updaters.emplace_back(OpenSSLUpdater(shake128));
+            break;
         case Hashes::SHAKE256:
-            /* openssl */
+            updaters.emplace_back(OpenSSLUpdater(shake256));
             break;
         default:
             break;
         }
     }
 
-    const auto UpdateHashOnBuffer = [&](const Buffer& buffer)
-    {
-        for (const auto& hash : hashList)
-        {
-            switch (static_cast<Hashes>(hashFlags & static_cast<uint32>(hash)))
-            {
-            case Hashes::Adler32:
-                CHECK(adler32.Update(buffer), false, "");
-                break;
-            case Hashes::CRC16:
-                CHECK(crc16.Update(buffer), false, "");
-                break;
-            case Hashes::CRC32_JAMCRC_0:
-                CHECK(crc32JAMCRC0.Update(buffer), false, "");
-                break;
-            case Hashes::CRC32_JAMCRC:
-                CHECK(crc32JAMCRC.Update(buffer), false, "");
-                break;
-            case Hashes::CRC64_ECMA_182:
-                CHECK(crc64ECMA182.Update(buffer), false, "");
-                break;
-            case Hashes::CRC64_WE:
-                CHECK(crc64WE.Update(buffer), false, "");
-                break;
-            case Hashes::MD5:
-                CHECK(md5.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::BLAKE2S256:
-                CHECK(blake2s256.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::BLAKE2B512:
-                CHECK(blake2b512.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA1:
-                CHECK(sha1.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA224:
-                CHECK(sha224.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA256:
-                CHECK(sha256.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA384:
-                CHECK(sha384.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA512:
-                CHECK(sha512.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA512_224:
-                CHECK(sha512_224.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA512_256:
-                CHECK(sha512_256.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA3_224:
-                CHECK(sha3_224.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA3_256:
-                CHECK(sha3_256.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA3_384:
-                CHECK(sha3_384.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHA3_512:
-                CHECK(sha3_512.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHAKE128:
-                CHECK(shake128.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            case Hashes::SHAKE256:
-                CHECK(shake256.Update(buffer.GetData(), static_cast<uint32>(buffer.GetLength())), false, "");
-                break;
-            default:
-                break;
-            }
-        }
-
-        return true;
-    };
-
+    HashWorkers workers(updaters);
     LocalString<512> ls;
 
     const char* format = "Reading [0x%.8llX/0x%.8llX] bytes...";
@@ -771,24 +824,24 @@ static bool ComputeHash(
         format = "[0x%.16llX/0x%.16llX] bytes...";
     }
 
-    const auto block = object->GetData().GetCacheSize();
-
+    auto processed             = 0ULL;
     const auto UpdateHashOnBlock = [&](uint64 offset, uint64 left)
     {
-        do
+        // the next block is read in background while the current one is hashed (by all the workers)
+        GView::Utils::DataCache::SequentialReader reader(object->GetData(), offset, left);
+        while (true)
         {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
+            CHECK(ProgressStatus::Update(processed, ls.Format(format, processed, objectSize)) == false, false, "");
 
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
-
-            const Buffer buffer = object->GetData().CopyToBuffer(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
+            const auto buffer = reader.Next();
+            if (buffer.Empty())
+                break;
 
-            CHECK(UpdateHashOnBuffer(buffer), false, "");
+            CHECK(workers.Process(buffer), false, "");
 
-            offset += sizeToRead;
-        } while (left > 0);
+            processed += buffer.GetLength();
+        }
+        CHECK(reader.HasFailed() == false, false, "");
 
         return true;
     };
@@ -886,7 +939,7 @@ static bool ComputeHash(
             outputs.emplace(std::pair{ "SHA3_384", sha3_384.GetHexValue() });
             break;
         case Hashes::SHA3_512:
-            sha3_384.Final();
+            sha3_512.Final();
             outputs.emplace(std::pair{ "SHA3_512", sha3_512.GetHexValue() });
             break;
         case Hashes::SHAKE128:
@@ -21,6 +21,7 @@ class Plugin : public Window, public Handlers::OnButtonPressedInterface, public
     void SetAllWindowsWithGivenViewName(const std::string_view& viewName);
     void ArrangeFilteredWindows(const std::string_view& filterName);
     bool GetColorForByteAt(uint64 offset, const ViewData& vd, ColorPair& cp) override;
+    void GetColorsForBuffer(uint64 offset, BufferView buf, const ViewData& vd, std::vector<BufferViewer::BufferColor>& runs) override;
     virtual bool GenerateActionOnMove(Reference<Control> sender, int64 deltaStartView, const ViewData& vd) override;
     void SetUpCallbackForViews(bool remove);
     bool ToggleSync();
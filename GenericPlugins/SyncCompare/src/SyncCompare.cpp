@@ -276,6 +276,64 @@ bool Plugin::GetColorForByteAt(uint64 offset, const ViewData& vd, ColorPair& cp)
     return false;
 }
 
+void Plugin::GetColorsForBuffer(uint64 offset, BufferView buf, const ViewData& vd, std::vector<BufferViewer::BufferColor>& runs)
+{
+    runs.clear();
+    auto desktop         = AppCUI::Application::GetDesktop();
+    const auto windowsNo = desktop->GetChildrenCount();
+    CHECKRET(windowsNo > 1, "");
+    CHECKRET(vd.viewStartOffset <= offset, "");
+    const auto deltaOffset = offset - vd.viewStartOffset;
+
+    // the bytes from the same positions in every window, read once (copied, the windows can share the same cache)
+    std::vector<std::vector<uint8>> windowsBytes(windowsNo);
+    for (uint32 i = 0; i < windowsNo; i++)
+    {
+        auto window    = desktop->GetChild(i);
+        auto interface = window.ToObjectRef<GView::View::WindowInterface>();
+        auto& data     = interface->GetObject()->GetData();
+
+        ViewData viewData{}; // we assume that current view is what we want (buffer view)
+        CHECKRET(interface->GetCurrentView()->GetViewData(viewData, GView::Utils::INVALID_OFFSET), "");
+
+        const auto buffer = data.Get(viewData.viewStartOffset + deltaOffset, static_cast<uint32>(buf.GetLength()), false);
+        windowsBytes[i].assign(buffer.begin(), buffer.end());
+    }
+
+    // the same rules as GetColorForByteAt
+    for (auto idx = 0U; idx < buf.GetLength(); idx++)
+    {
+        const auto byte = buf[idx];
+        uint32 same     = 0;
+        uint32 distinct = 0;
+        for (uint32 i = 0; i < windowsNo; i++)
+        {
+            if (idx >= windowsBytes[i].size())
+                continue;
+            const auto value = windowsBytes[i][idx];
+            same += value == byte ? 1 : 0;
+            auto seen = false;
+            for (uint32 j = 0; (j < i) && (!seen); j++)
+                seen = (idx < windowsBytes[j].size()) && (windowsBytes[j][idx] == value);
+            distinct += seen ? 0 : 1;
+        }
+
+        ColorPair cp;
+        if (distinct == 1 && same == windowsNo)
+            cp = MATCH_COMPLETE;
+        else if (distinct < windowsNo && same >= 2)
+            cp = MATCH_PARTIAL;
+        else
+            continue;
+
+        if (!runs.empty() && runs.back().end + 1 == offset + idx && runs.back().color.Foreground == cp.Foreground &&
+            runs.back().color.Background == cp.Background)
+            runs.back().end++;
+        else
+            runs.push_back({ offset + idx, offset + idx, cp });
+    }
+}
+
 bool Plugin::GenerateActionOnMove(Reference<Control> sender, int64 deltaStartView, const ViewData& vd)
 {
     CHECK(deltaStartView != 0, false, "");
@@ -125,6 +125,11 @@ extern "C"
         elf->selectionZoneInterface = win->GetSelectionZoneInterfaceFromViewerCreation(settings);
     }
 
+    PLUGIN_EXPORT bool Update(Reference<GView::Object> object)
+    {
+        return object->GetContentType<ELF::ELFFile>()->Update();
+    }
+
     PLUGIN_EXPORT bool PopulateWindow(Reference<GView::View::WindowInterface> win)
     {
         auto elf = win->GetObject()->GetContentType<ELF::ELFFile>();
@@ -767,6 +767,7 @@ void JSFile::BuildBlocks(GView::View::LexicalViewer::SyntaxManager& syntax)
     TokenIndexStack arrayBlocks;
     auto indexArrayBlock = 0u;
     auto len             = syntax.tokens.Len();
+    auto matched         = true;
     for (auto index = 0U; index < len; index++)
     {
         auto typeID = syntax.tokens[index].GetTypeID(TokenType::None);
@@ -776,13 +777,14 @@ void JSFile::BuildBlocks(GView::View::LexicalViewer::SyntaxManager& syntax)
             stBlocks.Push(index);
             break;
         case TokenType::BlockClose:
-            syntax.blocks.Add(stBlocks.Pop(), index, BlockAlignament::ParentBlockWithIndent, BlockFlags::EndMarker);
+            matched &= syntax.blocks.Add(stBlocks.Pop(), index, BlockAlignament::ParentBlockWithIndent, BlockFlags::EndMarker).IsValid();
             break;
         case TokenType::ExpressionOpen:
             exprBlocks.Push(index);
             break;
         case TokenType::ExpressionClose:
-            syntax.blocks.Add(exprBlocks.Pop(), index, BlockAlignament::CurrentToken, BlockFlags::EndMarker | BlockFlags::ManualCollapse);
+            matched &= syntax.blocks.Add(exprBlocks.Pop(), index, BlockAlignament::CurrentToken, BlockFlags::EndMarker | BlockFlags::ManualCollapse)
+                             .IsValid();
             break;
         case TokenType::ArrayOpen:
             arrayBlocks.Push(index);
@@ -797,9 +799,13 @@ void JSFile::BuildBlocks(GView::View::LexicalViewer::SyntaxManager& syntax)
                     syntax.blocks.Add(
                           indexArrayBlock, index, BlockAlignament::CurrentToken, BlockFlags::EndMarker | BlockFlags::ManualCollapse);
             }
+            else
+                matched = false;
             break;
         }
     }
+    // an unmatched '{', '(' or '[' (or a closing one) changes the blocks from the rest of the text
+    syntax.blocksMatched = matched && stBlocks.Empty() && exprBlocks.Empty() && arrayBlocks.Empty();
 }
 void JSFile::Tokenize(const TextParser& text, TokensList& tokenList, BlocksList& blocks)
 {
@@ -1201,7 +1207,7 @@ void JSFile::GetTokenIDStringRepresentation(uint32 id, AppCUI::Utils::String& st
 }
 void JSFile::AnalyzeText(GView::View::LexicalViewer::SyntaxManager& syntax)
 {
-    syntax.tokens.ResetLastTokenID(TokenType::None);
+    // the last token ID is TokenType::None for the entire text (or the one of the token after which the analysis continues)
     Tokenize(syntax.text, syntax.tokens, syntax.blocks);
     BuildBlocks(syntax);
     OperatorAlignament(syntax.tokens);
@@ -1240,6 +1246,14 @@ void JSFile::OperatorAlignament(GView::View::LexicalViewer::TokensList& tokenLis
         }
     }
 }
+bool JSFile::CanSplitAnalysisAfter(Token token)
+{
+    // a statement ends with ';' (unless it is followed by the rest of an 'if' or 'do' statement)
+    if (token.GetTypeID(TokenType::None) != TokenType::Semicolumn)
+        return false;
+    const auto next = token.Next().GetTypeID(TokenType::None);
+    return (next != TokenType::Keyword_Else) && (next != TokenType::Keyword_While);
+}
 bool JSFile::StringToContent(std::u16string_view string, AppCUI::Utils::UnicodeStringBuilder& result)
 {
     return TextParser::ExtractContentFromString(
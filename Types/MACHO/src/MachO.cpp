@@ -53,9 +53,9 @@ extern "C"
         return true;
     }
 
-    PLUGIN_EXPORT TypeInterface* CreateInstance(Reference<DataCache> file)
+    PLUGIN_EXPORT TypeInterface* CreateInstance()
     {
-        return new MachOFile(file);
+        return new MachOFile(nullptr);
     }
 
     void CreateBufferView(Reference<GView::View::WindowInterface> win, Reference<MachOFile> machO)
@@ -172,6 +172,11 @@ extern "C"
         win->CreateViewer(settings);
     }
 
+    PLUGIN_EXPORT bool Update(Reference<GView::Object> object)
+    {
+        return object->GetContentType<MachO::MachOFile>()->Update();
+    }
+
     PLUGIN_EXPORT bool PopulateWindow(Reference<GView::View::WindowInterface> win)
     {
         auto machO = win->GetObject()->GetContentType<MachO::MachOFile>();
@@ -7,7 +7,7 @@ namespace GView::Type::PCAP
 class PCAPFile : public TypeInterface, public View::ContainerViewer::EnumerateInterface, public View::ContainerViewer::OpenItemInterface
 {
   public:
-    Buffer data; // it's maximum 0xFFFF so just save it here
+    Buffer data; // copy of the packets (empty if the file is memory mapped)
 
     Header header;
     std::vector<std::pair<PacketHeader*, uint32>> packetHeaders;
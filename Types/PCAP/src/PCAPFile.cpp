@@ -16,14 +16,26 @@ bool PCAPFile::Update()
         Swap(header);
     }
 
+    // packet headers point in the file content --> for memory mapped files use the mapping directly (it lives as long as the object)
     // TODO: check for future, is this really ok? test with big pcap files
-    data = obj->GetData().CopyToBuffer(offset, (uint32) obj->GetData().GetSize() - offset);
-    CHECK(data.IsValid(), false, "");
+    const uint8* packets = nullptr;
+    if (obj->GetData().IsMemoryMapped())
+    {
+        const auto view = obj->GetData().Get(offset, (uint32) obj->GetData().GetSize() - offset, true);
+        CHECK(view.IsValid(), false, "");
+        packets = view.GetData();
+    }
+    else
+    {
+        data = obj->GetData().CopyToBuffer(offset, (uint32) obj->GetData().GetSize() - offset);
+        CHECK(data.IsValid(), false, "");
+        packets = data.GetData();
+    }
 
     const auto delta = offset;
     do
     {
-        const auto& [header, _] = packetHeaders.emplace_back((PacketHeader*) (data.GetData() + offset - delta), offset);
+        const auto& [header, _] = packetHeaders.emplace_back((PacketHeader*) (packets + offset - delta), offset);
         offset += (sizeof(PacketHeader) + header->origLen);
     } while (offset < obj->GetData().GetSize());
 
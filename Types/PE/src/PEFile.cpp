@@ -2015,24 +2015,38 @@ std::vector<uint64> PEFile::FindPcLnTabSigsCandidates() const
     std::vector<uint64> indexes;
     indexes.reserve(10); // usually not that many sigs found matching
 
+    // all signatures have the same size --> an overlap of (size - 1) bytes finds matches across chunks without duplicates
+    constexpr uint32 overlap = static_cast<uint32>(pclntabSigs[0].size() - 1);
+    std::vector<uint64> sigIndexes[ARRAY_LEN(pclntabSigs)];
+
     for (uint32 i = 0; i < nrSections; i++)
     {
-        const auto sectionBuffer = obj->GetData().CopyToBuffer(sect[i].PointerToRawData, sect[i].SizeOfRawData);
-        CHECK(sectionBuffer.IsValid(), indexes, "");
-        const auto section = std::string_view{ reinterpret_cast<char*>(sectionBuffer.GetData()), sectionBuffer.GetLength() };
-
-        for (const auto& sig : pclntabSigs)
+        auto chunks = obj->GetData().Chunks(sect[i].PointerToRawData, sect[i].SizeOfRawData, overlap);
+        for (auto it = chunks.begin(); it != chunks.end(); ++it)
         {
-            uint64 index = 0;
-            while ((index = section.find(sig, index)) != std::string::npos)
+            const auto chunk       = *it;
+            const auto chunkOffset = it.GetOffset() - sect[i].PointerToRawData;
+            const auto section     = std::string_view{ reinterpret_cast<const char*>(chunk.GetData()), chunk.GetLength() };
+
+            for (uint32 s = 0; s < ARRAY_LEN(pclntabSigs); s++)
             {
-                if (index != std::string::npos && index < sect[i].SizeOfRawData)
+                const auto& sig = pclntabSigs[s];
+                uint64 index    = 0;
+                while ((index = section.find(sig, index)) != std::string::npos)
                 {
-                    indexes.push_back(index + sect[i].VirtualAddress + imageBase);
+                    sigIndexes[s].push_back(chunkOffset + index + sect[i].VirtualAddress + imageBase);
+                    index += sig.size();
                 }
-                index += sig.size();
             }
         }
+        CHECK(chunks.HasFailed() == false, indexes, "");
+
+        // keep the candidates ordered by signature (for each section)
+        for (auto& si : sigIndexes)
+        {
+            indexes.insert(indexes.end(), si.begin(), si.end());
+            si.clear();
+        }
     }
 
     return indexes;
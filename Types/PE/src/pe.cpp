@@ -190,9 +190,26 @@ UInt16 e_res[4];)");
         settings.AddMemoryMapping(RVA, Name, DissasmViewer::MemoryMappingType::FunctionMapping);
     }
 
+    // the exported functions start functions for the deep scan even if nothing calls them
+    LocalString<32> ordinalName;
+    for (const auto& exportedFunction : pe->exp) {
+        const auto fa = pe->RVAToFA(exportedFunction.RVA);
+        if (fa == PE_INVALID_ADDRESS)
+            continue;
+        if (exportedFunction.Name.Len() > 0)
+            settings.AddFunction(fa, exportedFunction.Name);
+        else
+            settings.AddFunction(fa, ordinalName.Format("ordinal_%u", exportedFunction.Ordinal));
+    }
+
     win->CreateViewer(settings);
 }
 
+PLUGIN_EXPORT bool Update(Reference<GView::Object> object)
+{
+    return object->GetContentType<PE::PEFile>()->Update();
+}
+
 PLUGIN_EXPORT bool PopulateWindow(Reference<GView::View::WindowInterface> win)
 {
     auto pe = win->GetObject()->GetContentType<PE::PEFile>();